@@ -2,6 +2,7 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmCTestBuildHandler.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <ratio>
@@ -327,27 +328,26 @@ int cmCTestBuildHandler::ProcessHandler()
 
   // Pre-compile regular expressions objects for all regular expressions
 
-#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes)              \
+#define cmCTestBuildHandlerPopulateRegexVector(strings, group)                \
   do {                                                                        \
-    regexes.clear();                                                          \
     cmCTestOptionalLog(this->CTest, DEBUG,                                    \
-                       this << "Add " #regexes << std::endl, this->Quiet);    \
+                       this << "Add " #group << std::endl, this->Quiet);      \
     for (std::string const& s : (strings)) {                                  \
       cmCTestOptionalLog(this->CTest, DEBUG,                                  \
                          "Add " #strings ": " << s << std::endl,              \
                          this->Quiet);                                        \
-      (regexes).emplace_back(s);                                              \
+      this->LineMatcher.Add(cmCTestBuildLineMatcher::group, s);               \
     }                                                                         \
   } while (false)
 
-  cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorMatches,
-                                         this->ErrorMatchRegex);
+  this->LineMatcher.Clear();
+  cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorMatches, ErrorMatch);
   cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorExceptions,
-                                         this->ErrorExceptionRegex);
+                                         ErrorException);
   cmCTestBuildHandlerPopulateRegexVector(this->CustomWarningMatches,
-                                         this->WarningMatchRegex);
+                                         WarningMatch);
   cmCTestBuildHandlerPopulateRegexVector(this->CustomWarningExceptions,
-                                         this->WarningExceptionRegex);
+                                         WarningException);
 
   // Determine source and binary tree substitutions to simplify the output.
   this->SimplifySourceDir.clear();
@@ -498,21 +498,73 @@ void cmCTestBuildHandler::GenerateXMLLaunched(cmXMLWriter& xml)
     return;
   }
 
-  // Sort XML fragments in chronological order.
+  // only report the first 50 warnings and first 50 errors
+  int numErrorsAllowed = this->MaxErrors;
+  int numWarningsAllowed = this->MaxWarnings;
+
+  // Launchers record every command they run in the launch log, in order of
+  // completion.  Stream it to find the xml fragments of the commands that
+  // failed or warned.
+  std::set<std::string> seen;
+  cmsys::ifstream fin(
+    cmStrCat(this->CTestLaunchDir, '/', cmCTestLaunchReporter::LaunchLogName)
+      .c_str(),
+    std::ios::in | std::ios::binary);
+  if (fin) {
+    unsigned long commands = 0;
+    std::chrono::milliseconds elapsed(0);
+    std::string line;
+    while (cmSystemTools::GetLineFromStream(fin, line)) {
+      // <exit code>\t<milliseconds>\t<output hash>\t<xml fragment>
+      std::string::size_type const time = line.find('\t');
+      std::string::size_type const hash = line.find('\t', time + 1);
+      std::string::size_type const frag = line.find('\t', hash + 1);
+      if (time == std::string::npos || hash == std::string::npos ||
+          frag == std::string::npos) {
+        continue;
+      }
+      ++commands;
+      elapsed += std::chrono::milliseconds(std::atol(&line[time + 1]));
+      std::string const fname = line.substr(frag + 1);
+      if (fname.empty() || !seen.insert(fname).second) {
+        continue;
+      }
+      if (this->IsLaunchedErrorFile(fname.c_str()) && numErrorsAllowed) {
+        numErrorsAllowed--;
+        ++this->TotalErrors;
+      } else if (this->IsLaunchedWarningFile(fname.c_str()) &&
+                 numWarningsAllowed) {
+        numWarningsAllowed--;
+        ++this->TotalWarnings;
+      } else {
+        continue;
+      }
+      xml.FragmentFile(cmStrCat(this->CTestLaunchDir, '/', fname).c_str());
+    }
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                       "Launched " << commands << " commands taking "
+                                   << std::chrono::duration<double>(elapsed)
+                                        .count()
+                                   << " s in total" << std::endl,
+                       this->Quiet);
+  }
+
+  // Fragments not listed in the log, e.g. written by launchers of another
+  // CMake version or with no log at all, follow in chronological order.
   cmFileTimeCache ftc;
   FragmentCompare fragmentCompare(&ftc);
   using Fragments = std::set<std::string, FragmentCompare>;
   Fragments fragments(fragmentCompare);
 
-  // only report the first 50 warnings and first 50 errors
-  int numErrorsAllowed = this->MaxErrors;
-  int numWarningsAllowed = this->MaxWarnings;
   // Identify fragments on disk.
   cmsys::Directory launchDir;
   launchDir.Load(this->CTestLaunchDir);
   unsigned long n = launchDir.GetNumberOfFiles();
   for (unsigned long i = 0; i < n; ++i) {
     char const* fname = launchDir.GetFile(i);
+    if (seen.count(fname)) {
+      continue;
+    }
     if (this->IsLaunchedErrorFile(fname) && numErrorsAllowed) {
       numErrorsAllowed--;
       fragments.insert(this->CTestLaunchDir + '/' + fname);
@@ -979,6 +1031,8 @@ bool cmCTestBuildHandler::RunMakeCommand(std::string const& command,
                 ofs.flush();
                 reporter.LogOut = this->LogFileName;
                 reporter.WriteXML();
+                reporter.WriteLaunchRecord(reporter.GetXMLFileName(),
+                                           std::chrono::milliseconds(0));
               }
             } else {
               cmCTestBuildErrorWarning errorwarning;
@@ -1038,21 +1092,14 @@ void cmCTestBuildHandler::ProcessBuffer(char const* data, size_t length,
                                         t_BuildProcessingQueueType* queue)
 {
   std::string::size_type const tick_line_len = 50;
-  char const* ptr;
-  for (ptr = data; ptr < data + length; ptr++) {
-    queue->push_back(*ptr);
-  }
+  queue->insert(queue->end(), data, data + length);
   this->BuildOutputLogSize += length;
 
   // until there are any lines left in the buffer
   while (true) {
     // Find the end of line
-    t_BuildProcessingQueueType::iterator it;
-    for (it = queue->begin(); it != queue->end(); ++it) {
-      if (*it == '\n') {
-        break;
-      }
-    }
+    t_BuildProcessingQueueType::iterator it =
+      std::find(queue->begin(), queue->end(), '\n');
 
     // Once certain number of errors or warnings reached, ignore future errors
     // or warnings.
@@ -1176,7 +1223,11 @@ int cmCTestBuildHandler::ProcessSingleLine(char const* data)
   // Ignore ANSI color codes when checking for errors and warnings.
   std::string input(data);
   std::string line;
-  this->ColorRemover->Replace(input, line);
+  if (input.find('\x1b') == std::string::npos) {
+    line = std::move(input);
+  } else {
+    this->ColorRemover->Replace(input, line);
+  }
 
   cmCTestOptionalLog(this->CTest, DEBUG, "Line: [" << line << "]" << std::endl,
                      this->Quiet);
@@ -1185,26 +1236,22 @@ int cmCTestBuildHandler::ProcessSingleLine(char const* data)
   int errorLine = 0;
 
   // Check for regular expressions
+  this->LineMatcher.SetLine(line);
 
   if (!this->ErrorQuotaReached) {
     // Errors
-    int wrxCnt = 0;
-    for (cmsys::RegularExpression& rx : this->ErrorMatchRegex) {
-      if (rx.find(line.c_str())) {
-        errorLine = 1;
-        cmCTestOptionalLog(this->CTest, DEBUG,
-                           "  Error Line: " << line << " (matches: "
-                                            << this->CustomErrorMatches[wrxCnt]
-                                            << ")" << std::endl,
-                           this->Quiet);
-        break;
-      }
-      wrxCnt++;
-    }
-    // Error exceptions
-    wrxCnt = 0;
-    for (cmsys::RegularExpression& rx : this->ErrorExceptionRegex) {
-      if (rx.find(line.c_str())) {
+    int wrxCnt = this->LineMatcher.Find(cmCTestBuildLineMatcher::ErrorMatch);
+    if (wrxCnt >= 0) {
+      errorLine = 1;
+      cmCTestOptionalLog(this->CTest, DEBUG,
+                         "  Error Line: " << line << " (matches: "
+                                          << this->CustomErrorMatches[wrxCnt]
+                                          << ")" << std::endl,
+                         this->Quiet);
+      // Error exceptions
+      wrxCnt =
+        this->LineMatcher.Find(cmCTestBuildLineMatcher::ErrorException);
+      if (wrxCnt >= 0) {
         errorLine = 0;
         cmCTestOptionalLog(this->CTest, DEBUG,
                            "  Not an error Line: "
@@ -1212,32 +1259,24 @@ int cmCTestBuildHandler::ProcessSingleLine(char const* data)
                              << this->CustomErrorExceptions[wrxCnt] << ")"
                              << std::endl,
                            this->Quiet);
-        break;
       }
-      wrxCnt++;
     }
   }
   if (!this->WarningQuotaReached) {
     // Warnings
-    int wrxCnt = 0;
-    for (cmsys::RegularExpression& rx : this->WarningMatchRegex) {
-      if (rx.find(line.c_str())) {
-        warningLine = 1;
-        cmCTestOptionalLog(this->CTest, DEBUG,
-                           "  Warning Line: "
-                             << line << " (matches: "
-                             << this->CustomWarningMatches[wrxCnt] << ")"
-                             << std::endl,
-                           this->Quiet);
-        break;
-      }
-      wrxCnt++;
-    }
-
-    wrxCnt = 0;
-    // Warning exceptions
-    for (cmsys::RegularExpression& rx : this->WarningExceptionRegex) {
-      if (rx.find(line.c_str())) {
+    int wrxCnt = this->LineMatcher.Find(cmCTestBuildLineMatcher::WarningMatch);
+    if (wrxCnt >= 0) {
+      warningLine = 1;
+      cmCTestOptionalLog(this->CTest, DEBUG,
+                         "  Warning Line: "
+                           << line << " (matches: "
+                           << this->CustomWarningMatches[wrxCnt] << ")"
+                           << std::endl,
+                         this->Quiet);
+      // Warning exceptions
+      wrxCnt =
+        this->LineMatcher.Find(cmCTestBuildLineMatcher::WarningException);
+      if (wrxCnt >= 0) {
         warningLine = 0;
         cmCTestOptionalLog(this->CTest, DEBUG,
                            "  Not a warning Line: "
@@ -1245,9 +1284,7 @@ int cmCTestBuildHandler::ProcessSingleLine(char const* data)
                              << this->CustomWarningExceptions[wrxCnt] << ")"
                              << std::endl,
                            this->Quiet);
-        break;
       }
-      wrxCnt++;
     }
   }
   if (errorLine) {
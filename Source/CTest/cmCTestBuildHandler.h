@@ -13,6 +13,7 @@
 
 #include "cmsys/RegularExpression.hxx"
 
+#include "cmCTestBuildLineMatcher.h"
 #include "cmCTestGenericHandler.h"
 #include "cmDuration.h"
 #include "cmProcessOutput.h"
@@ -103,10 +104,7 @@ private:
   std::vector<std::string> ReallyCustomWarningExceptions;
   std::vector<cmCTestCompileErrorWarningRex> ErrorWarningFileLineRegex;
 
-  std::vector<cmsys::RegularExpression> ErrorMatchRegex;
-  std::vector<cmsys::RegularExpression> ErrorExceptionRegex;
-  std::vector<cmsys::RegularExpression> WarningMatchRegex;
-  std::vector<cmsys::RegularExpression> WarningExceptionRegex;
+  cmCTestBuildLineMatcher LineMatcher;
 
   using t_BuildProcessingQueueType = std::deque<char>;
 
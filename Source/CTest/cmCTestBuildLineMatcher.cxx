@@ -0,0 +1,295 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmCTestBuildLineMatcher.h"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <utility>
+
+namespace {
+// Return the position after the bracket expression starting at 'i',
+// following the rules of cmsys::RegularExpression.
+size_t SkipBracket(std::string const& regex, size_t i)
+{
+  size_t const n = regex.size();
+  ++i;
+  if (i < n && regex[i] == '^') {
+    ++i;
+  }
+  if (i < n && (regex[i] == ']' || regex[i] == '-')) {
+    ++i;
+  }
+  while (i < n && regex[i] != ']') {
+    ++i;
+  }
+  return i < n ? i + 1 : std::string::npos;
+}
+
+// Return the position after the group starting at 'i'.
+size_t SkipGroup(std::string const& regex, size_t i)
+{
+  size_t const n = regex.size();
+  int depth = 0;
+  while (i < n) {
+    switch (regex[i]) {
+      case '\\':
+        i += 2;
+        continue;
+      case '[':
+        i = SkipBracket(regex, i);
+        if (i == std::string::npos) {
+          return i;
+        }
+        continue;
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        if (--depth == 0) {
+          return i + 1;
+        }
+        break;
+      default:
+        break;
+    }
+    ++i;
+  }
+  return std::string::npos;
+}
+}
+
+std::string cmCTestBuildLineMatcher::RequiredLiteral(std::string const& regex,
+                                                     bool& anchored)
+{
+  // Collect the runs of literal characters at the top level of the
+  // expression.  Each of them must appear in a match unless the top level
+  // has alternatives.  Anything inside a group is skipped.
+  std::string best;
+  bool bestAnchored = false;
+  std::string run;
+  bool runAnchored = false;
+  bool lastLiteral = false;
+  auto endRun = [&]() {
+    if (run.size() > best.size()) {
+      best = run;
+      bestAnchored = runAnchored;
+    }
+    run.clear();
+    runAnchored = false;
+    lastLiteral = false;
+  };
+
+  anchored = false;
+  size_t const n = regex.size();
+  size_t i = 0;
+  if (n > 0 && regex[0] == '^') {
+    runAnchored = true;
+    i = 1;
+  }
+  while (i < n) {
+    char const c = regex[i];
+    switch (c) {
+      case '\\':
+        if (i + 1 >= n) {
+          return std::string();
+        }
+        run += regex[i + 1];
+        lastLiteral = true;
+        i += 2;
+        continue;
+      case '*':
+      case '?':
+        // The preceding atom is optional.
+        if (lastLiteral) {
+          run.pop_back();
+        }
+        endRun();
+        break;
+      case '+':
+        endRun();
+        break;
+      case '[':
+        endRun();
+        i = SkipBracket(regex, i);
+        if (i == std::string::npos) {
+          return std::string();
+        }
+        continue;
+      case '(':
+        endRun();
+        i = SkipGroup(regex, i);
+        if (i == std::string::npos) {
+          return std::string();
+        }
+        continue;
+      case '|':
+      case ')':
+        return std::string();
+      case '.':
+      case '^':
+      case '$':
+        endRun();
+        break;
+      default:
+        run += c;
+        lastLiteral = true;
+        break;
+    }
+    ++i;
+  }
+  endRun();
+
+  anchored = bestAnchored;
+  return best;
+}
+
+void cmCTestBuildLineMatcher::Clear()
+{
+  for (std::vector<Pattern>& patterns : this->Patterns) {
+    patterns.clear();
+  }
+  this->Literals.clear();
+  this->Compiled = false;
+}
+
+void cmCTestBuildLineMatcher::Add(Group group, std::string const& regex)
+{
+  Pattern p;
+  p.Regex.compile(regex);
+  p.Literal = RequiredLiteral(regex, p.Anchored);
+  if (!p.Literal.empty() && !p.Anchored) {
+    p.LiteralId = this->AddLiteral(p.Literal);
+  }
+  this->Patterns[group].emplace_back(std::move(p));
+  this->Compiled = false;
+}
+
+int cmCTestBuildLineMatcher::AddLiteral(std::string const& literal)
+{
+  auto it = std::find(this->Literals.begin(), this->Literals.end(), literal);
+  if (it != this->Literals.end()) {
+    return static_cast<int>(it - this->Literals.begin());
+  }
+  this->Literals.push_back(literal);
+  return static_cast<int>(this->Literals.size() - 1);
+}
+
+void cmCTestBuildLineMatcher::Compile()
+{
+  // Bytes that appear in no literal share class 0.
+  std::fill(std::begin(this->ByteClass), std::end(this->ByteClass), 0);
+  this->NumClasses = 1;
+  for (std::string const& literal : this->Literals) {
+    for (char c : literal) {
+      unsigned char& cls = this->ByteClass[static_cast<unsigned char>(c)];
+      if (cls == 0) {
+        cls = static_cast<unsigned char>(this->NumClasses++);
+      }
+    }
+  }
+  size_t const nc = this->NumClasses;
+
+  // Build the trie of all literals.
+  this->Next.assign(nc, -1);
+  this->Outputs.assign(1, std::vector<int>());
+  for (size_t id = 0; id < this->Literals.size(); ++id) {
+    size_t s = 0;
+    for (char c : this->Literals[id]) {
+      size_t const t =
+        s * nc + this->ByteClass[static_cast<unsigned char>(c)];
+      if (this->Next[t] < 0) {
+        this->Next[t] = static_cast<int>(this->Outputs.size());
+        this->Outputs.emplace_back();
+        this->Next.resize(this->Next.size() + nc, -1);
+      }
+      s = static_cast<size_t>(this->Next[t]);
+    }
+    this->Outputs[s].push_back(static_cast<int>(id));
+  }
+
+  // Turn the trie into a complete automaton in breadth-first order so that
+  // the failure state of each state is finished before the state itself.
+  std::vector<int> fail(this->Outputs.size(), 0);
+  std::deque<int> queue;
+  for (size_t c = 0; c < nc; ++c) {
+    int& t = this->Next[c];
+    if (t < 0) {
+      t = 0;
+    } else {
+      queue.push_back(t);
+    }
+  }
+  while (!queue.empty()) {
+    size_t const s = static_cast<size_t>(queue.front());
+    queue.pop_front();
+    size_t const f = static_cast<size_t>(fail[s]);
+    for (size_t c = 0; c < nc; ++c) {
+      int const t = this->Next[s * nc + c];
+      int const ft = this->Next[f * nc + c];
+      if (t < 0) {
+        this->Next[s * nc + c] = ft;
+        continue;
+      }
+      fail[t] = ft;
+      std::vector<int> const& inherited = this->Outputs[ft];
+      this->Outputs[t].insert(this->Outputs[t].end(), inherited.begin(),
+                              inherited.end());
+      queue.push_back(t);
+    }
+  }
+
+  this->Seen.assign(this->Literals.size(), 0);
+  this->Generation = 0;
+  this->Compiled = true;
+}
+
+void cmCTestBuildLineMatcher::SetLine(std::string const& line)
+{
+  this->Line = &line;
+  this->Scanned = false;
+}
+
+void cmCTestBuildLineMatcher::Scan()
+{
+  if (++this->Generation == 0) {
+    std::fill(this->Seen.begin(), this->Seen.end(), 0);
+    this->Generation = 1;
+  }
+  size_t const nc = this->NumClasses;
+  size_t s = 0;
+  for (char c : *this->Line) {
+    s = static_cast<size_t>(
+      this->Next[s * nc + this->ByteClass[static_cast<unsigned char>(c)]]);
+    for (int id : this->Outputs[s]) {
+      this->Seen[id] = this->Generation;
+    }
+  }
+  this->Scanned = true;
+}
+
+int cmCTestBuildLineMatcher::Find(Group group)
+{
+  if (!this->Compiled) {
+    this->Compile();
+  }
+  std::string const& line = *this->Line;
+  std::vector<Pattern>& patterns = this->Patterns[group];
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    Pattern& p = patterns[i];
+    if (p.LiteralId >= 0) {
+      if (!this->Scanned) {
+        this->Scan();
+      }
+      if (this->Seen[p.LiteralId] != this->Generation) {
+        continue;
+      }
+    } else if (p.Anchored && line.compare(0, p.Literal.size(), p.Literal)) {
+      continue;
+    }
+    if (p.Regex.find(line.c_str())) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,77 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "cmsys/RegularExpression.hxx"
+
+/** \class cmCTestBuildLineMatcher
+ * \brief Classify lines of build output against groups of regexes.
+ *
+ * Each regular expression is reduced to a literal that every match of it
+ * must contain.  The literals of all groups are searched for at once in a
+ * single pass over a line, and only the regular expressions whose literal
+ * was found are tried.  Within a group the first matching expression is
+ * reported, exactly as if all of them had been tried in order.
+ */
+class cmCTestBuildLineMatcher
+{
+public:
+  enum Group
+  {
+    ErrorMatch,
+    ErrorException,
+    WarningMatch,
+    WarningException,
+    GroupCount
+  };
+
+  void Clear();
+  void Add(Group group, std::string const& regex);
+
+  /** Set the line to classify.  It must outlive the calls to Find.  */
+  void SetLine(std::string const& line);
+
+  /** Index of the first regex of the group that matches the line,
+      or -1 if none does.  */
+  int Find(Group group);
+
+  /** The literal that any match of the regex must contain.  It is
+      empty if there is none the regex can be reduced to.  */
+  static std::string RequiredLiteral(std::string const& regex,
+                                     bool& anchored);
+
+private:
+  struct Pattern
+  {
+    cmsys::RegularExpression Regex;
+    std::string Literal;
+    bool Anchored = false;
+    int LiteralId = -1;
+  };
+
+  int AddLiteral(std::string const& literal);
+  void Compile();
+  void Scan();
+
+  std::vector<Pattern> Patterns[GroupCount];
+  std::vector<std::string> Literals;
+  bool Compiled = false;
+
+  // Aho-Corasick automaton over the unanchored literals, with input bytes
+  // mapped to classes so that the transition table stays small.
+  unsigned char ByteClass[256] = {};
+  size_t NumClasses = 1;
+  std::vector<int> Next;
+  std::vector<std::vector<int>> Outputs;
+
+  std::string const* Line = nullptr;
+  bool Scanned = false;
+  unsigned int Generation = 0;
+  std::vector<unsigned int> Seen;
+};
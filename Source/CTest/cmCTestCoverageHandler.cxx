@@ -9,16 +9,24 @@
 #include <iomanip>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <ratio>
 #include <sstream>
 #include <type_traits>
 #include <utility>
 
+#include <cm/optional>
 #include <cmext/algorithm>
 
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+#include <cm3p/zlib.h>
+
+#include "cmsys/Directory.hxx"
 #include "cmsys/FStream.hxx"
 #include "cmsys/Glob.hxx"
 #include "cmsys/RegularExpression.hxx"
+#include "cmsys/SystemInformation.hxx"
 
 #include "cmCTest.h"
 #include "cmDuration.h"
@@ -33,6 +41,7 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmUVProcessChain.h"
+#include "cmWorkerPool.h"
 #include "cmWorkingDirectory.h"
 #include "cmXMLWriter.h"
 
@@ -629,6 +638,21 @@ int cmCTestCoverageHandler::HandlePHPCoverage(
   return static_cast<int>(cont->TotalCoverage.size());
 }
 
+unsigned int cmCTestCoverageHandler::GetThreadCount(size_t jobs) const
+{
+  size_t parallelLevel = 1;
+  cm::optional<size_t> level = this->CTest->GetParallelLevel();
+  if (!level || *level == 0) {
+    cmsys::SystemInformation info;
+    info.RunCPUCheck();
+    parallelLevel = info.GetNumberOfLogicalCPU();
+  } else {
+    parallelLevel = *level;
+  }
+  return static_cast<unsigned int>(
+    std::max<size_t>(1, std::min(parallelLevel, jobs)));
+}
+
 int cmCTestCoverageHandler::HandleCoberturaCoverage(
   cmCTestCoverageHandlerContainer* cont)
 {
@@ -751,7 +775,7 @@ int cmCTestCoverageHandler::HandleJacocoCoverage(
     cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                        "Found Jacoco Files, Performing Coverage" << std::endl,
                        this->Quiet);
-    cov.LoadCoverageData(files);
+    cov.LoadCoverageData(files, this->GetThreadCount(files.size()));
   } else {
     cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                        " Cannot find Jacoco coverage files: " << coverageFile
@@ -848,6 +872,321 @@ int cmCTestCoverageHandler::HandleBlanketJSCoverage(
   }
   return static_cast<int>(cont->TotalCoverage.size());
 }
+namespace {
+// Read the execution count of each line of a .gcov file, with -1 for
+// lines that are not executable.
+bool ReadGCovFile(std::string const& gcovFile, std::vector<int>& counts)
+{
+  cmsys::ifstream ifile(gcovFile.c_str());
+  if (!ifile) {
+    return false;
+  }
+  std::string nl;
+  while (cmSystemTools::GetLineFromStream(ifile, nl)) {
+    // Skip empty lines
+    if (nl.empty()) {
+      continue;
+    }
+
+    // Skip unused lines
+    if (nl.size() < 12) {
+      continue;
+    }
+
+    // Handle gcov 3.0 non-coverage lines
+    // non-coverage lines seem to always start with something not
+    // a space and don't have a ':' in the 9th position
+    // TODO: Verify that this is actually a robust metric
+    if (nl[0] != ' ' && nl[9] != ':') {
+      continue;
+    }
+
+    // Read the coverage count from the beginning of the gcov output
+    // line
+    std::string prefix = nl.substr(0, 12);
+    int cov = atoi(prefix.c_str());
+
+    // Read the line number starting at the 10th character of the gcov
+    // output line
+    std::string lineNumber = nl.substr(10, 5);
+
+    int lineIdx = atoi(lineNumber.c_str()) - 1;
+    if (lineIdx >= 0) {
+      while (counts.size() <= static_cast<size_t>(lineIdx)) {
+        counts.push_back(-1);
+      }
+
+      // Initially all entries are -1 (not used). If we get coverage
+      // information, increment it to 0 first.
+      if (counts[lineIdx] < 0) {
+        if (cov > 0 || prefix.find('#') != std::string::npos) {
+          counts[lineIdx] = 0;
+        }
+      }
+
+      counts[lineIdx] += cov;
+    }
+  }
+  return true;
+}
+
+// Number of coverage data files given to one gcov run in JSON mode.
+size_t const kGCovJSONBatchSize = 100;
+
+// Whether the gcov options select the JSON intermediate format, given as
+// the long option or among short options such as "-lj".
+bool IsGCovJSONFormat(std::vector<std::string> const& args)
+{
+  for (size_t a = 1; a < args.size(); ++a) {
+    std::string const& arg = args[a];
+    if (arg == "--json-format") {
+      return true;
+    }
+    if (arg == "--object-directory" || arg == "--source-prefix") {
+      ++a;
+      continue;
+    }
+    if (arg.size() < 2 || arg[0] != '-' || arg[1] == '-') {
+      continue;
+    }
+    for (size_t i = 1; i < arg.size(); ++i) {
+      if (arg[i] == 'i' || arg[i] == 'j') {
+        return true;
+      }
+      if (arg[i] == 'o' || arg[i] == 's') {
+        // The rest of the word, or else the next argument, is the value.
+        if (i + 1 == arg.size()) {
+          ++a;
+        }
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+// Read the execution count of each line from gcov JSON intermediate
+// output, one document per line, by full path of the source file.
+bool ReadGCovJSON(std::string const& output,
+                  std::map<std::string, std::vector<int>>& counts)
+{
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> const reader(builder.newCharReader());
+  bool ok = true;
+  std::string::size_type pos = 0;
+  while (pos < output.size()) {
+    std::string::size_type end = output.find('\n', pos);
+    if (end == std::string::npos) {
+      end = output.size();
+    }
+    Json::Value root;
+    if (output[pos] == '{' &&
+        reader->parse(output.data() + pos, output.data() + end, &root,
+                      nullptr) &&
+        root.isObject() && root["files"].isArray()) {
+      Json::Value const& cwd = root["current_working_directory"];
+      for (Json::Value const& file : root["files"]) {
+        if (!file.isObject() || !file["file"].isString() ||
+            !file["lines"].isArray()) {
+          continue;
+        }
+        std::vector<int>& vec = counts[cmSystemTools::CollapseFullPath(
+          file["file"].asString(), cwd.isString() ? cwd.asString() : "")];
+        for (Json::Value const& line : file["lines"]) {
+          if (!line.isObject() || !line["line_number"].isUInt64() ||
+              !line["count"].isUInt64() ||
+              line["line_number"].asUInt64() == 0) {
+            continue;
+          }
+          size_t const lineIdx =
+            static_cast<size_t>(line["line_number"].asUInt64() - 1);
+          if (vec.size() <= lineIdx) {
+            vec.resize(lineIdx + 1, -1);
+          }
+          // Lines of functions instantiated more than once are listed
+          // for each instance.
+          vec[lineIdx] = std::max(vec[lineIdx], 0) +
+            static_cast<int>(line["count"].asUInt64());
+        }
+      }
+    } else if (end > pos) {
+      ok = false;
+    }
+    pos = end + 1;
+  }
+  return ok;
+}
+
+// Read the .gcov.json.gz files that gcov writes in JSON mode when it does
+// not print to its standard output, and remove them.
+bool ReadGCovJSONFiles(std::string const& dir,
+                       std::map<std::string, std::vector<int>>& counts)
+{
+  bool ok = true;
+  cmsys::Directory d;
+  if (!d.Load(dir)) {
+    return ok;
+  }
+  for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+    std::string const& name = d.GetFileName(i);
+    if (!cmHasLiteralSuffix(name, ".gcov.json.gz")) {
+      continue;
+    }
+    std::string const path = d.GetFilePath(i);
+    std::string json;
+    gzFile gf = gzopen(path.c_str(), "rb");
+    if (gf) {
+      char buffer[16384];
+      int n;
+      while ((n = gzread(gf, buffer, sizeof(buffer))) > 0) {
+        json.append(buffer, static_cast<size_t>(n));
+      }
+      ok = n == 0 && ok;
+      gzclose(gf);
+    } else {
+      ok = false;
+    }
+    ok = ReadGCovJSON(json, counts) && ok;
+    cmSystemTools::RemoveFile(path);
+  }
+  return ok;
+}
+
+class GCovEndJob : public cmWorkerPool::JobFenceT
+{
+public:
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+
+struct cmCTestCoverageHandler::GCovRun
+{
+  std::string File;
+  std::vector<std::string> Command;
+  cmWorkerPool::ProcessResultT Result;
+  // Line counts of each .gcov file named in the gcov output.
+  // In JSON mode, line counts of each source file instead.
+  std::map<std::string, std::vector<int>> GCovFiles;
+  size_t NumFiles = 1;
+  bool JSONError = false;
+  bool Finished = false;
+};
+
+struct cmCTestCoverageHandler::GCovContext
+{
+  GCovContext(cmCTestCoverageHandler* handler,
+              cmCTestCoverageHandlerContainer* cont)
+    : Handler(handler)
+    , Cont(cont)
+  {
+  }
+
+  cmCTestCoverageHandler* Handler;
+  cmCTestCoverageHandlerContainer* Cont;
+  std::string WorkingDirectory;
+  bool WorkerDirectories = false;
+  bool JSON = false;
+  std::vector<GCovRun> Runs;
+
+  // Runs are processed in order, under the mutex, by the worker that
+  // finishes the last of a sequence of runs.
+  std::mutex Mutex;
+  size_t NextRun = 0;
+  int FileCount = 0;
+  size_t FileTotal = 0;
+  int GCovStyle = 0;
+  std::set<std::string> MissingFiles;
+  std::string ActualSourceFile;
+
+  // Style 1
+  cmsys::RegularExpression St1re1{
+    "[0-9]+\\.[0-9]+% of [0-9]+ (source |)lines executed in file (.*)$"
+  };
+  cmsys::RegularExpression St1re2{ "^Creating (.*\\.gcov)\\." };
+
+  // Style 2
+  cmsys::RegularExpression St2re1{ "^File *[`'](.*)'$" };
+  cmsys::RegularExpression St2re2{
+    "Lines executed: *[0-9]+\\.[0-9]+% of [0-9]+$"
+  };
+  cmsys::RegularExpression St2re3{ "^(.*)reating [`'](.*\\.gcov)'" };
+  cmsys::RegularExpression St2re4{ "^(.*):unexpected EOF *$" };
+  cmsys::RegularExpression St2re5{ "^(.*):cannot open source file*$" };
+  cmsys::RegularExpression St2re6{
+    "^(.*):source file is newer than graph file `(.*)'$"
+  };
+};
+
+class cmCTestCoverageHandler::GCovJob : public cmWorkerPool::JobT
+{
+public:
+  GCovJob(size_t index)
+    : Index(index)
+  {
+  }
+
+  void Process() override
+  {
+    GCovContext& ctx = *static_cast<GCovContext*>(this->UserData());
+    GCovRun& run = ctx.Runs[this->Index];
+
+    // Concurrent gcov runs may create .gcov files of the same name, so
+    // each worker runs gcov in a directory of its own.
+    std::string const dir = ctx.WorkerDirectories
+      ? cmStrCat(ctx.WorkingDirectory, '/', this->WorkerIndex())
+      : ctx.WorkingDirectory;
+    this->RunProcess(run.Result, run.Command, dir);
+
+    if (ctx.JSON) {
+      if (run.Result.ErrorMessage.empty()) {
+        // A gcov that ignores --stdout writes compressed files instead.
+        run.JSONError = run.Result.StdOut.find('{') == std::string::npos
+          ? !ReadGCovJSONFiles(dir, run.GCovFiles)
+          : !ReadGCovJSON(run.Result.StdOut, run.GCovFiles);
+      }
+      run.Result.StdOut.clear();
+    } else if (run.Result.ErrorMessage.empty()) {
+      // Read the .gcov files before this worker runs gcov again.
+      cmsys::RegularExpression st1re2("^Creating (.*\\.gcov)\\.");
+      cmsys::RegularExpression st2re3("^(.*)reating [`'](.*\\.gcov)'");
+      std::vector<std::string> lines;
+      cmsys::SystemTools::Split(run.Result.StdOut, lines);
+      for (std::string const& line : lines) {
+        std::string gcovFile;
+        if (st1re2.find(line)) {
+          gcovFile = st1re2.match(1);
+        } else if (st2re3.find(line)) {
+          gcovFile = st2re3.match(2);
+        }
+        if (gcovFile.empty() || run.GCovFiles.count(gcovFile)) {
+          continue;
+        }
+        std::vector<int> counts;
+        if (ReadGCovFile(cmSystemTools::CollapseFullPath(gcovFile, dir),
+                         counts)) {
+          run.GCovFiles.emplace(gcovFile, std::move(counts));
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(ctx.Mutex);
+    run.Finished = true;
+    while (ctx.NextRun < ctx.Runs.size() && ctx.Runs[ctx.NextRun].Finished) {
+      GCovRun& next = ctx.Runs[ctx.NextRun++];
+      if (ctx.JSON) {
+        ctx.Handler->ProcessGCovJSONRun(ctx, next);
+      } else {
+        ctx.Handler->ProcessGCovRun(ctx, next);
+      }
+      next.Result.reset();
+      next.GCovFiles.clear();
+    }
+  }
+
+private:
+  size_t Index;
+};
+
 int cmCTestCoverageHandler::HandleGCovCoverage(
   cmCTestCoverageHandlerContainer* cont)
 {
@@ -867,29 +1206,6 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
     return 0;
   }
 
-  // Style 1
-  std::string st1gcovOutputRex1 =
-    "[0-9]+\\.[0-9]+% of [0-9]+ (source |)lines executed in file (.*)$";
-  std::string st1gcovOutputRex2 = "^Creating (.*\\.gcov)\\.";
-  cmsys::RegularExpression st1re1(st1gcovOutputRex1.c_str());
-  cmsys::RegularExpression st1re2(st1gcovOutputRex2.c_str());
-
-  // Style 2
-  std::string st2gcovOutputRex1 = "^File *[`'](.*)'$";
-  std::string st2gcovOutputRex2 =
-    "Lines executed: *[0-9]+\\.[0-9]+% of [0-9]+$";
-  std::string st2gcovOutputRex3 = "^(.*)reating [`'](.*\\.gcov)'";
-  std::string st2gcovOutputRex4 = "^(.*):unexpected EOF *$";
-  std::string st2gcovOutputRex5 = "^(.*):cannot open source file*$";
-  std::string st2gcovOutputRex6 =
-    "^(.*):source file is newer than graph file `(.*)'$";
-  cmsys::RegularExpression st2re1(st2gcovOutputRex1.c_str());
-  cmsys::RegularExpression st2re2(st2gcovOutputRex2.c_str());
-  cmsys::RegularExpression st2re3(st2gcovOutputRex3.c_str());
-  cmsys::RegularExpression st2re4(st2gcovOutputRex4.c_str());
-  cmsys::RegularExpression st2re5(st2gcovOutputRex5.c_str());
-  cmsys::RegularExpression st2re6(st2gcovOutputRex6.c_str());
-
   std::vector<std::string> files;
   this->FindGCovFiles(files);
 
@@ -911,18 +1227,6 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   }
   cmWorkingDirectory workdir(tempDir);
 
-  int gcovStyle = 0;
-
-  std::set<std::string> missingFiles;
-
-  std::string actualSourceFile;
-  cmCTestOptionalLog(
-    this->CTest, HANDLER_OUTPUT,
-    "   Processing coverage (each . represents one file):" << std::endl,
-    this->Quiet);
-  cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
-  int file_count = 0;
-
   // make sure output from gcov is in English!
   cmCTestCoverageHandlerLocale locale_C;
   static_cast<void>(locale_C);
@@ -930,321 +1234,455 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   std::vector<std::string> basecovargs =
     cmSystemTools::ParseArguments(gcovExtraFlags);
   basecovargs.insert(basecovargs.begin(), gcovCommand);
+
+  GCovContext ctx(this, cont);
+  ctx.WorkingDirectory = tempDir;
+  ctx.FileTotal = files.size();
+
+  // With the JSON intermediate format gcov reports on all coverage data
+  // files of an object directory in one run, on its standard output.
+  ctx.JSON = IsGCovJSONFormat(basecovargs);
+  if (ctx.JSON) {
+    basecovargs.emplace_back("--stdout");
+  }
   basecovargs.emplace_back("-o");
 
   // files is a list of *.da and *.gcda files with coverage data in them.
   // These are binary files that you give as input to gcov so that it will
   // give us text output we can analyze to summarize coverage.
   //
-  for (std::string const& f : files) {
-    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
-                       this->Quiet);
-
-    // Call gcov to get coverage data for this *.gcda file:
-    //
-    std::string fileDir = cmSystemTools::GetFilenamePath(f);
-    std::vector<std::string> covargs = basecovargs;
-    covargs.push_back(fileDir);
-    covargs.push_back(f);
-    std::string const command = joinCommandLine(covargs);
-
-    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                       command << std::endl, this->Quiet);
-
-    std::string output;
-    std::string errors;
-    int retVal = 0;
-    *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
-    *cont->OFS << "  Command: " << command << std::endl;
-    int res = this->CTest->RunCommand(covargs, &output, &errors, &retVal,
-                                      tempDir.c_str(),
-                                      cmDuration::zero() /*this->TimeOut*/);
-
-    *cont->OFS << "  Output: " << output << std::endl;
-    *cont->OFS << "  Errors: " << errors << std::endl;
-    if (!res) {
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-                 "Problem running coverage on file: " << f << std::endl);
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-                 "Command produced error: " << errors << std::endl);
-      cont->Error++;
-      continue;
+  if (ctx.JSON) {
+    std::map<std::string, std::vector<std::string>> filesByDir;
+    for (std::string const& f : files) {
+      filesByDir[cmSystemTools::GetFilenamePath(f)].push_back(f);
     }
-    if (retVal != 0) {
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-                 "Coverage command returned: "
-                   << retVal << " while processing: " << f << std::endl);
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-                 "Command produced error: " << cont->Error << std::endl);
+    for (auto const& dir : filesByDir) {
+      for (size_t i = 0; i < dir.second.size(); i += kGCovJSONBatchSize) {
+        size_t const end =
+          std::min(dir.second.size(), i + kGCovJSONBatchSize);
+        ctx.Runs.emplace_back();
+        GCovRun& run = ctx.Runs.back();
+        run.File = dir.first;
+        run.NumFiles = end - i;
+        run.Command = basecovargs;
+        run.Command.push_back(dir.first);
+        run.Command.insert(run.Command.end(), dir.second.begin() + i,
+                           dir.second.begin() + end);
+      }
     }
-    cmCTestOptionalLog(
-      this->CTest, HANDLER_VERBOSE_OUTPUT,
-      "--------------------------------------------------------------"
-        << std::endl
-        << output << std::endl
-        << "--------------------------------------------------------------"
-        << std::endl,
-      this->Quiet);
-
-    std::vector<std::string> lines;
-    cmsys::SystemTools::Split(output, lines);
+  } else {
+    ctx.Runs.resize(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+      GCovRun& run = ctx.Runs[i];
+      run.File = files[i];
+      run.Command = basecovargs;
+      run.Command.push_back(cmSystemTools::GetFilenamePath(files[i]));
+      run.Command.push_back(files[i]);
+    }
+  }
 
-    for (std::string const& line : lines) {
-      std::string sourceFile;
-      std::string gcovFile;
+  // Run gcov as many times at once as tests would run.
+  unsigned int const threads = this->GetThreadCount(ctx.Runs.size());
 
-      cmCTestOptionalLog(this->CTest, DEBUG,
-                         "Line: [" << line << "]" << std::endl, this->Quiet);
+  ctx.WorkerDirectories = threads > 1;
+  if (ctx.WorkerDirectories) {
+    for (unsigned int i = 0; i < threads; ++i) {
+      std::string const dir = cmStrCat(tempDir, '/', i);
+      if (!cmSystemTools::MakeDirectory(dir)) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unable to make directory: " << dir << std::endl);
+        cont->Error++;
+        return 0;
+      }
+    }
+  }
 
-      if (line.empty()) {
-        // Ignore empty line; probably style 2
-      } else if (st1re1.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 1;
-        }
-        if (gcovStyle != 1) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e1" << std::endl);
-          cont->Error++;
-          break;
-        }
+  cmCTestOptionalLog(
+    this->CTest, HANDLER_OUTPUT,
+    "   Processing coverage (each . represents one file):" << std::endl,
+    this->Quiet);
+  cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
 
-        actualSourceFile.clear();
-        sourceFile = st1re1.match(2);
-      } else if (st1re2.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 1;
-        }
-        if (gcovStyle != 1) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e2" << std::endl);
-          cont->Error++;
-          break;
-        }
+  cmWorkerPool pool;
+  pool.SetThreadCount(threads);
+  for (size_t i = 0; i < ctx.Runs.size(); ++i) {
+    pool.EmplaceJob<GCovJob>(i);
+  }
+  pool.EmplaceJob<GCovEndJob>();
+  pool.Process(&ctx);
 
-        gcovFile = st1re2.match(1);
-      } else if (st2re1.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 2;
-        }
-        if (gcovStyle != 2) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e3" << std::endl);
-          cont->Error++;
-          break;
-        }
+  return ctx.FileCount;
+}
 
-        actualSourceFile.clear();
-        sourceFile = st2re1.match(1);
-      } else if (st2re2.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 2;
-        }
-        if (gcovStyle != 2) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e4" << std::endl);
-          cont->Error++;
-          break;
-        }
-      } else if (st2re3.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 2;
-        }
-        if (gcovStyle != 2) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e5" << std::endl);
-          cont->Error++;
-          break;
-        }
+void cmCTestCoverageHandler::ProcessGCovRun(GCovContext& ctx, GCovRun& run)
+{
+  cmCTestCoverageHandlerContainer* cont = ctx.Cont;
+  std::string const& f = run.File;
 
-        gcovFile = st2re3.match(2);
-      } else if (st2re4.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 2;
-        }
-        if (gcovStyle != 2) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e6" << std::endl);
-          cont->Error++;
-          break;
-        }
+  cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
+                     this->Quiet);
 
-        cmCTestOptionalLog(this->CTest, WARNING,
-                           "Warning: " << st2re4.match(1)
-                                       << " had unexpected EOF" << std::endl,
-                           this->Quiet);
-      } else if (st2re5.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 2;
-        }
-        if (gcovStyle != 2) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e7" << std::endl);
-          cont->Error++;
-          break;
-        }
+  std::string fileDir = cmSystemTools::GetFilenamePath(f);
+  std::string const command = joinCommandLine(run.Command);
 
-        cmCTestOptionalLog(this->CTest, WARNING,
-                           "Warning: Cannot open file: " << st2re5.match(1)
-                                                         << std::endl,
-                           this->Quiet);
-      } else if (st2re6.find(line)) {
-        if (gcovStyle == 0) {
-          gcovStyle = 2;
-        }
-        if (gcovStyle != 2) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output style e8" << std::endl);
-          cont->Error++;
-          break;
-        }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     command << std::endl, this->Quiet);
+
+  std::string const& output = run.Result.StdOut;
+  std::string const& errors = run.Result.StdErr;
+  *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
+  *cont->OFS << "  Command: " << command << std::endl;
+  *cont->OFS << "  Output: " << output << std::endl;
+  *cont->OFS << "  Errors: " << errors << std::endl;
+  if (!run.Result.ErrorMessage.empty()) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Problem running coverage on file: " << f << std::endl);
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Command produced error: " << run.Result.ErrorMessage
+                                          << std::endl);
+    cont->Error++;
+    return;
+  }
+  if (run.Result.ExitStatus != 0) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Coverage command returned: " << run.Result.ExitStatus
+                                             << " while processing: " << f
+                                             << std::endl);
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Command produced error: " << cont->Error << std::endl);
+  }
+  cmCTestOptionalLog(
+    this->CTest, HANDLER_VERBOSE_OUTPUT,
+    "--------------------------------------------------------------"
+      << std::endl
+      << output << std::endl
+      << "--------------------------------------------------------------"
+      << std::endl,
+    this->Quiet);
 
-        cmCTestOptionalLog(this->CTest, WARNING,
-                           "Warning: File: " << st2re6.match(1)
-                                             << " is newer than "
-                                             << st2re6.match(2) << std::endl,
-                           this->Quiet);
-      } else {
-        // gcov 4.7 can have output lines saying "No executable lines" and
-        // "Removing 'filename.gcov'"... Don't log those as "errors."
-        if (line != "No executable lines" &&
-            !cmHasLiteralPrefix(line, "Removing ")) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Unknown gcov output line: [" << line << "]"
-                                                   << std::endl);
-          cont->Error++;
-          // abort();
-        }
+  int& gcovStyle = ctx.GCovStyle;
+  std::string& actualSourceFile = ctx.ActualSourceFile;
+  std::set<std::string>& missingFiles = ctx.MissingFiles;
+  cmsys::RegularExpression& st1re1 = ctx.St1re1;
+  cmsys::RegularExpression& st1re2 = ctx.St1re2;
+  cmsys::RegularExpression& st2re1 = ctx.St2re1;
+  cmsys::RegularExpression& st2re2 = ctx.St2re2;
+  cmsys::RegularExpression& st2re3 = ctx.St2re3;
+  cmsys::RegularExpression& st2re4 = ctx.St2re4;
+  cmsys::RegularExpression& st2re5 = ctx.St2re5;
+  cmsys::RegularExpression& st2re6 = ctx.St2re6;
+
+  std::vector<std::string> lines;
+  cmsys::SystemTools::Split(output, lines);
+
+  for (std::string const& line : lines) {
+    std::string sourceFile;
+    std::string gcovFile;
+
+    cmCTestOptionalLog(this->CTest, DEBUG,
+                       "Line: [" << line << "]" << std::endl, this->Quiet);
+
+    if (line.empty()) {
+      // Ignore empty line; probably style 2
+    } else if (st1re1.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 1;
+      }
+      if (gcovStyle != 1) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e1" << std::endl);
+        cont->Error++;
+        break;
       }
 
-      // If the last line of gcov output gave us a valid value for gcovFile,
-      // and we have an actualSourceFile, then insert a (or add to existing)
-      // SingleFileCoverageVector for actualSourceFile:
-      //
-      if (!gcovFile.empty() && !actualSourceFile.empty()) {
-        cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec =
-          cont->TotalCoverage[actualSourceFile];
+      actualSourceFile.clear();
+      sourceFile = st1re1.match(2);
+    } else if (st1re2.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 1;
+      }
+      if (gcovStyle != 1) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e2" << std::endl);
+        cont->Error++;
+        break;
+      }
 
-        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                           "   in gcovFile: " << gcovFile << std::endl,
-                           this->Quiet);
+      gcovFile = st1re2.match(1);
+    } else if (st2re1.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 2;
+      }
+      if (gcovStyle != 2) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e3" << std::endl);
+        cont->Error++;
+        break;
+      }
 
-        cmsys::ifstream ifile(gcovFile.c_str());
-        if (!ifile) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Cannot open file: " << gcovFile << std::endl);
-        } else {
-          std::string nl;
-          while (cmSystemTools::GetLineFromStream(ifile, nl)) {
-            // Skip empty lines
-            if (nl.empty()) {
-              continue;
-            }
+      actualSourceFile.clear();
+      sourceFile = st2re1.match(1);
+    } else if (st2re2.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 2;
+      }
+      if (gcovStyle != 2) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e4" << std::endl);
+        cont->Error++;
+        break;
+      }
+    } else if (st2re3.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 2;
+      }
+      if (gcovStyle != 2) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e5" << std::endl);
+        cont->Error++;
+        break;
+      }
 
-            // Skip unused lines
-            if (nl.size() < 12) {
-              continue;
-            }
+      gcovFile = st2re3.match(2);
+    } else if (st2re4.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 2;
+      }
+      if (gcovStyle != 2) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e6" << std::endl);
+        cont->Error++;
+        break;
+      }
 
-            // Handle gcov 3.0 non-coverage lines
-            // non-coverage lines seem to always start with something not
-            // a space and don't have a ':' in the 9th position
-            // TODO: Verify that this is actually a robust metric
-            if (nl[0] != ' ' && nl[9] != ':') {
-              continue;
-            }
+      cmCTestOptionalLog(this->CTest, WARNING,
+                         "Warning: " << st2re4.match(1)
+                                     << " had unexpected EOF" << std::endl,
+                         this->Quiet);
+    } else if (st2re5.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 2;
+      }
+      if (gcovStyle != 2) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e7" << std::endl);
+        cont->Error++;
+        break;
+      }
 
-            // Read the coverage count from the beginning of the gcov output
-            // line
-            std::string prefix = nl.substr(0, 12);
-            int cov = atoi(prefix.c_str());
+      cmCTestOptionalLog(this->CTest, WARNING,
+                         "Warning: Cannot open file: " << st2re5.match(1)
+                                                       << std::endl,
+                         this->Quiet);
+    } else if (st2re6.find(line)) {
+      if (gcovStyle == 0) {
+        gcovStyle = 2;
+      }
+      if (gcovStyle != 2) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output style e8" << std::endl);
+        cont->Error++;
+        break;
+      }
 
-            // Read the line number starting at the 10th character of the gcov
-            // output line
-            std::string lineNumber = nl.substr(10, 5);
+      cmCTestOptionalLog(this->CTest, WARNING,
+                         "Warning: File: " << st2re6.match(1)
+                                           << " is newer than "
+                                           << st2re6.match(2) << std::endl,
+                         this->Quiet);
+    } else {
+      // gcov 4.7 can have output lines saying "No executable lines" and
+      // "Removing 'filename.gcov'"... Don't log those as "errors."
+      if (line != "No executable lines" &&
+          !cmHasLiteralPrefix(line, "Removing ")) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Unknown gcov output line: [" << line << "]"
+                                                 << std::endl);
+        cont->Error++;
+        // abort();
+      }
+    }
 
-            int lineIdx = atoi(lineNumber.c_str()) - 1;
-            if (lineIdx >= 0) {
-              while (vec.size() <= static_cast<size_t>(lineIdx)) {
-                vec.push_back(-1);
-              }
+    // If the last line of gcov output gave us a valid value for gcovFile,
+    // and we have an actualSourceFile, then insert a (or add to existing)
+    // SingleFileCoverageVector for actualSourceFile:
+    //
+    if (!gcovFile.empty() && !actualSourceFile.empty()) {
+      cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec =
+        cont->TotalCoverage[actualSourceFile];
 
-              // Initially all entries are -1 (not used). If we get coverage
-              // information, increment it to 0 first.
-              if (vec[lineIdx] < 0) {
-                if (cov > 0 || prefix.find('#') != std::string::npos) {
-                  vec[lineIdx] = 0;
-                }
-              }
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         "   in gcovFile: " << gcovFile << std::endl,
+                         this->Quiet);
 
-              vec[lineIdx] += cov;
-            }
+      auto counts = run.GCovFiles.find(gcovFile);
+      if (counts == run.GCovFiles.end()) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Cannot open file: " << gcovFile << std::endl);
+      } else {
+        std::vector<int> const& fileCounts = counts->second;
+        if (vec.size() < fileCounts.size()) {
+          vec.resize(fileCounts.size(), -1);
+        }
+        for (size_t i = 0; i < fileCounts.size(); ++i) {
+          if (fileCounts[i] >= 0) {
+            vec[i] = std::max(vec[i], 0) + fileCounts[i];
           }
         }
-
-        actualSourceFile.clear();
       }
 
-      if (!sourceFile.empty() && actualSourceFile.empty()) {
-        gcovFile.clear();
+      actualSourceFile.clear();
+    }
 
-        // Is it in the source dir or the binary dir?
-        //
-        if (IsFileInDir(sourceFile, cont->SourceDir)) {
+    if (!sourceFile.empty() && actualSourceFile.empty()) {
+      gcovFile.clear();
+
+      // Is it in the source dir or the binary dir?
+      //
+      if (IsFileInDir(sourceFile, cont->SourceDir)) {
+        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                           "   produced s: " << sourceFile << std::endl,
+                           this->Quiet);
+        *cont->OFS << "  produced in source dir: " << sourceFile
+                   << std::endl;
+        actualSourceFile = cmSystemTools::CollapseFullPath(sourceFile);
+      } else if (IsFileInDir(sourceFile, cont->BinaryDir)) {
+        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                           "   produced b: " << sourceFile << std::endl,
+                           this->Quiet);
+        *cont->OFS << "  produced in binary dir: " << sourceFile
+                   << std::endl;
+        actualSourceFile = cmSystemTools::CollapseFullPath(sourceFile);
+      }
+
+      if (actualSourceFile.empty()) {
+        if (missingFiles.find(sourceFile) == missingFiles.end()) {
           cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                             "   produced s: " << sourceFile << std::endl,
+                             "Something went wrong" << std::endl,
                              this->Quiet);
-          *cont->OFS << "  produced in source dir: " << sourceFile
-                     << std::endl;
-          actualSourceFile = cmSystemTools::CollapseFullPath(sourceFile);
-        } else if (IsFileInDir(sourceFile, cont->BinaryDir)) {
           cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                             "   produced b: " << sourceFile << std::endl,
-                             this->Quiet);
-          *cont->OFS << "  produced in binary dir: " << sourceFile
-                     << std::endl;
-          actualSourceFile = cmSystemTools::CollapseFullPath(sourceFile);
-        }
-
-        if (actualSourceFile.empty()) {
-          if (missingFiles.find(sourceFile) == missingFiles.end()) {
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               "Something went wrong" << std::endl,
-                               this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               "Cannot find file: [" << sourceFile << "]"
-                                                     << std::endl,
-                               this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               " in source dir: [" << cont->SourceDir << "]"
+                             "Cannot find file: [" << sourceFile << "]"
                                                    << std::endl,
-                               this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               " or binary dir: [" << cont->BinaryDir.size()
-                                                   << "]" << std::endl,
-                               this->Quiet);
-            *cont->OFS << "  Something went wrong. Cannot find file: "
-                       << sourceFile << " in source dir: " << cont->SourceDir
-                       << " or binary dir: " << cont->BinaryDir << std::endl;
+                             this->Quiet);
+          cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                             " in source dir: [" << cont->SourceDir << "]"
+                                                 << std::endl,
+                             this->Quiet);
+          cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                             " or binary dir: [" << cont->BinaryDir.size()
+                                                 << "]" << std::endl,
+                             this->Quiet);
+          *cont->OFS << "  Something went wrong. Cannot find file: "
+                     << sourceFile << " in source dir: " << cont->SourceDir
+                     << " or binary dir: " << cont->BinaryDir << std::endl;
 
-            missingFiles.insert(sourceFile);
-          }
+          missingFiles.insert(sourceFile);
         }
       }
     }
+  }
 
-    file_count++;
+  ctx.FileCount++;
 
-    if (file_count % 50 == 0) {
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
-                         " processed: " << file_count << " out of "
-                                        << files.size() << std::endl,
-                         this->Quiet);
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+  if (ctx.FileCount % 50 == 0) {
+    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
+                       " processed: " << ctx.FileCount << " out of "
+                                      << ctx.FileTotal << std::endl,
+                       this->Quiet);
+    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+  }
+}
+
+void cmCTestCoverageHandler::ProcessGCovJSONRun(GCovContext& ctx,
+                                                GCovRun& run)
+{
+  cmCTestCoverageHandlerContainer* cont = ctx.Cont;
+
+  cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
+                     this->Quiet);
+
+  std::string const command = joinCommandLine(run.Command);
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     command << std::endl, this->Quiet);
+
+  *cont->OFS << "* Run coverage for: " << run.File << std::endl;
+  *cont->OFS << "  Command: " << command << std::endl;
+  *cont->OFS << "  Errors: " << run.Result.StdErr << std::endl;
+  if (!run.Result.ErrorMessage.empty()) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Problem running coverage on directory: " << run.File
+                                                         << std::endl);
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Command produced error: " << run.Result.ErrorMessage
+                                          << std::endl);
+    cont->Error++;
+    return;
+  }
+  if (run.Result.ExitStatus != 0) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Coverage command returned: " << run.Result.ExitStatus
+                                             << " while processing: "
+                                             << run.File << std::endl);
+  }
+  if (run.JSONError) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Cannot parse gcov JSON output for: " << run.File
+                                                     << std::endl);
+    cont->Error++;
+  }
+
+  for (auto const& file : run.GCovFiles) {
+    std::string const& sourceFile = file.first;
+    if (IsFileInDir(sourceFile, cont->SourceDir)) {
+      *cont->OFS << "  produced in source dir: " << sourceFile << std::endl;
+    } else if (IsFileInDir(sourceFile, cont->BinaryDir)) {
+      *cont->OFS << "  produced in binary dir: " << sourceFile << std::endl;
+    } else {
+      if (ctx.MissingFiles.insert(sourceFile).second) {
+        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                           "Cannot find file: [" << sourceFile << "]"
+                                                 << std::endl,
+                           this->Quiet);
+        *cont->OFS << "  Something went wrong. Cannot find file: "
+                   << sourceFile << " in source dir: " << cont->SourceDir
+                   << " or binary dir: " << cont->BinaryDir << std::endl;
+      }
+      continue;
+    }
+
+    cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec =
+      cont->TotalCoverage[sourceFile];
+    if (vec.empty()) {
+      // The JSON output lists executable lines only, but the coverage
+      // log covers every line of the source file.
+      cmsys::ifstream ifs(sourceFile.c_str());
+      std::string line;
+      size_t lines = 0;
+      while (cmSystemTools::GetLineFromStream(ifs, line)) {
+        ++lines;
+      }
+      vec.assign(lines, -1);
+    }
+    std::vector<int> const& fileCounts = file.second;
+    if (vec.size() < fileCounts.size()) {
+      vec.resize(fileCounts.size(), -1);
+    }
+    for (size_t i = 0; i < fileCounts.size(); ++i) {
+      if (fileCounts[i] >= 0) {
+        vec[i] = std::max(vec[i], 0) + fileCounts[i];
+      }
     }
   }
 
-  return file_count;
+  int const previousCount = ctx.FileCount;
+  ctx.FileCount += static_cast<int>(run.NumFiles);
+  if (ctx.FileCount / 50 != previousCount / 50) {
+    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
+                       " processed: " << ctx.FileCount << " out of "
+                                      << ctx.FileTotal << std::endl,
+                       this->Quiet);
+    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+  }
 }
 
 int cmCTestCoverageHandler::HandleLCovCoverage(
@@ -4,6 +4,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <iosfwd>
 #include <map>
 #include <set>
@@ -65,9 +66,17 @@ private:
   void StartCoverageLogXML(cmXMLWriter& xml);
   void EndCoverageLogXML(cmXMLWriter& xml);
 
+  //! Number of threads to process the given number of jobs with
+  unsigned int GetThreadCount(size_t jobs) const;
+
   //! Handle coverage using GCC's GCov
   int HandleGCovCoverage(cmCTestCoverageHandlerContainer* cont);
   void FindGCovFiles(std::vector<std::string>& files);
+  struct GCovRun;
+  struct GCovContext;
+  class GCovJob;
+  void ProcessGCovRun(GCovContext& ctx, GCovRun& run);
+  void ProcessGCovJSONRun(GCovContext& ctx, GCovRun& run);
 
   //! Handle coverage using Intel's LCov
   int HandleLCovCoverage(cmCTestCoverageHandlerContainer* cont);
@@ -2,11 +2,13 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmCTestLaunch.h"
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include <cm3p/uv.h>
@@ -185,18 +187,14 @@ void cmCTestLaunch::RunChild()
   cmUVProcessChainBuilder builder;
   builder.AddCommand(this->RealArgV);
 
-  cmsys::ofstream fout;
-  cmsys::ofstream ferr;
   if (this->Reporter.Passthru) {
     // In passthru mode we just share the output pipes.
     builder.SetExternalStream(cmUVProcessChainBuilder::Stream_OUTPUT, stdout)
       .SetExternalStream(cmUVProcessChainBuilder::Stream_ERROR, stderr);
   } else {
-    // In full mode we record the child output pipes to log files.
+    // In full mode we record the child output in memory.
     builder.SetBuiltinStream(cmUVProcessChainBuilder::Stream_OUTPUT)
       .SetBuiltinStream(cmUVProcessChainBuilder::Stream_ERROR);
-    fout.open(this->Reporter.LogOut.c_str(), std::ios::out | std::ios::binary);
-    ferr.open(this->Reporter.LogErr.c_str(), std::ios::out | std::ios::binary);
   }
 
 #ifdef _WIN32
@@ -220,34 +218,36 @@ void cmCTestLaunch::RunChild()
   if (!this->Reporter.Passthru) {
     auto beginRead = [&chain, &processOutput](
                        cm::uv_pipe_ptr& pipe, int stream, std::ostream& out,
-                       cmsys::ofstream& file, bool& haveData, bool& finished,
+                       std::string& text, bool& haveData, bool& finished,
                        int id) -> std::unique_ptr<cmUVStreamReadHandle> {
       pipe.init(chain.GetLoop(), 0);
       uv_pipe_open(pipe, stream);
       finished = false;
       return cmUVStreamRead(
         pipe,
-        [&processOutput, &out, &file, id, &haveData](std::vector<char> data) {
+        [&processOutput, &out, &text, id, &haveData](std::vector<char> data) {
           std::string strdata;
           processOutput.DecodeText(data.data(), data.size(), strdata, id);
-          file.write(strdata.c_str(), strdata.size());
+          text += strdata;
           out.write(strdata.c_str(), strdata.size());
           haveData = true;
         },
-        [&processOutput, &out, &file, &finished, id]() {
+        [&processOutput, &out, &text, &finished, id]() {
           std::string strdata;
           processOutput.DecodeText(std::string(), strdata, id);
           if (!strdata.empty()) {
-            file.write(strdata.c_str(), strdata.size());
+            text += strdata;
             out.write(strdata.c_str(), strdata.size());
           }
           finished = true;
         });
     };
-    outputHandle = beginRead(outPipe, chain.OutputStream(), std::cout, fout,
-                             this->HaveOut, outFinished, 1);
-    errorHandle = beginRead(errPipe, chain.ErrorStream(), std::cerr, ferr,
-                            this->HaveErr, errFinished, 2);
+    outputHandle =
+      beginRead(outPipe, chain.OutputStream(), std::cout,
+                this->Reporter.StdOut, this->HaveOut, outFinished, 1);
+    errorHandle =
+      beginRead(errPipe, chain.ErrorStream(), std::cerr,
+                this->Reporter.StdErr, this->HaveErr, errFinished, 2);
   }
 
   // Wait for the real command to finish.
@@ -279,6 +279,7 @@ int cmCTestLaunch::Run()
   std::map<std::string, std::string> arrayOptions;
   arrayOptions["outputs"] = this->Reporter.OptionOutput;
   arrayOptions["targetLabels"] = this->Reporter.OptionTargetLabels;
+  auto const start = std::chrono::steady_clock::now();
   instrumentation.InstrumentCommand(
     this->Reporter.OptionCommandType, this->RealArgV,
     [this]() -> int {
@@ -287,14 +288,19 @@ int cmCTestLaunch::Run()
     },
     options, arrayOptions);
 
-  if (this->Operation == Op::Normal) {
-
-    if (this->CheckResults()) {
-      return this->Reporter.ExitCode;
+  auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+
+  if (this->Operation == Op::Normal && !this->Reporter.Passthru) {
+    // Write an xml fragment only for commands that failed or warned.
+    // Every command gets a record in the launch log.
+    std::string fragment;
+    if (!this->CheckResults()) {
+      this->LoadConfig();
+      this->Reporter.WriteXML();
+      fragment = this->Reporter.GetXMLFileName();
     }
-
-    this->LoadConfig();
-    this->Reporter.WriteXML();
+    this->Reporter.WriteLaunchRecord(fragment, duration);
   }
 
   return this->Reporter.ExitCode;
@@ -313,8 +319,8 @@ bool cmCTestLaunch::CheckResults()
   }
 
   // Scrape the output logs to look for warnings.
-  if ((this->HaveErr && this->ScrapeLog(this->Reporter.LogErr)) ||
-      (this->HaveOut && this->ScrapeLog(this->Reporter.LogOut))) {
+  if ((this->HaveErr && this->ScrapeLog(this->Reporter.StdErr)) ||
+      (this->HaveOut && this->ScrapeLog(this->Reporter.StdOut))) {
     return false;
   }
   return true;
@@ -348,13 +354,13 @@ void cmCTestLaunch::LoadScrapeRules(
   }
 }
 
-bool cmCTestLaunch::ScrapeLog(std::string const& fname)
+bool cmCTestLaunch::ScrapeLog(std::string const& text)
 {
   this->LoadScrapeRules();
 
-  // Look for log file lines matching warning expressions but not
+  // Look for output lines matching warning expressions but not
   // suppression expressions.
-  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  std::istringstream fin(text);
   std::string line;
   while (cmSystemTools::GetLineFromStream(fin, line)) {
     if (this->Reporter.MatchesFilterPrefix(line)) {
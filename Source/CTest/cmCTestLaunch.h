@@ -65,7 +65,7 @@ private:
   void LoadScrapeRules();
   void LoadScrapeRules(char const* purpose,
                        std::vector<cmsys::RegularExpression>& regexps) const;
-  bool ScrapeLog(std::string const& fname);
+  bool ScrapeLog(std::string const& text);
 
   // Helper class to generate the xml fragment.
   cmCTestLaunchReporter Reporter;
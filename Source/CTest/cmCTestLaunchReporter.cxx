@@ -2,6 +2,7 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmCTestLaunchReporter.h"
 
+#include <sstream>
 #include <utility>
 
 #include "cmsys/FStream.hxx"
@@ -37,14 +38,6 @@ cmCTestLaunchReporter::cmCTestLaunchReporter()
   this->RegexWarning.emplace_back("(^|[ :])[Nn][Oo][Tt][Ee]");
 }
 
-cmCTestLaunchReporter::~cmCTestLaunchReporter()
-{
-  if (!this->Passthru) {
-    cmSystemTools::RemoveFile(this->LogOut);
-    cmSystemTools::RemoveFile(this->LogErr);
-  }
-}
-
 void cmCTestLaunchReporter::ComputeFileNames()
 {
   // We just passthru the behavior of the real command unless the
@@ -70,10 +63,6 @@ void cmCTestLaunchReporter::ComputeFileNames()
     md5.Append(realArg);
   }
   this->LogHash = md5.FinalizeHex();
-
-  // We store stdout and stderr in temporary log files.
-  this->LogOut = cmStrCat(this->LogDir, "launch-", this->LogHash, "-out.txt");
-  this->LogErr = cmStrCat(this->LogDir, "launch-", this->LogHash, "-err.txt");
 }
 
 void cmCTestLaunchReporter::LoadLabels()
@@ -135,15 +124,16 @@ bool cmCTestLaunchReporter::IsError() const
   return this->ExitCode != 0;
 }
 
-void cmCTestLaunchReporter::WriteXML()
+std::string cmCTestLaunchReporter::GetXMLFileName() const
 {
-  // Name the xml file.
-  std::string logXML =
-    cmStrCat(this->LogDir, this->IsError() ? "error-" : "warning-",
-             this->LogHash, ".xml");
+  return cmStrCat(this->IsError() ? "error-" : "warning-", this->LogHash,
+                  ".xml");
+}
 
+void cmCTestLaunchReporter::WriteXML()
+{
   // Use cmGeneratedFileStream to atomically create the report file.
-  cmGeneratedFileStream fxml(logXML);
+  cmGeneratedFileStream fxml(cmStrCat(this->LogDir, this->GetXMLFileName()));
   cmXMLWriter xml(fxml, 2);
   cmXMLElement e2(xml, "Failure");
   e2.Attribute("type", this->IsError() ? "Error" : "Warning");
@@ -226,10 +216,14 @@ void cmCTestLaunchReporter::WriteXMLResult(cmXMLElement& e2)
   cmXMLElement e3(e2, "Result");
 
   // StdOut
-  this->DumpFileToXML(e3, "StdOut", this->LogOut);
+  if (!this->LogOut.empty()) {
+    this->DumpFileToXML(e3, "StdOut", this->LogOut);
+  } else {
+    this->DumpTextToXML(e3, "StdOut", this->StdOut);
+  }
 
   // StdErr
-  this->DumpFileToXML(e3, "StdErr", this->LogErr);
+  this->DumpTextToXML(e3, "StdErr", this->StdErr);
 
   // ExitCondition
   cmXMLElement e4(e3, "ExitCondition");
@@ -269,7 +263,19 @@ void cmCTestLaunchReporter::DumpFileToXML(cmXMLElement& e3, char const* tag,
                                           std::string const& fname)
 {
   cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  this->DumpStreamToXML(e3, tag, fin);
+}
 
+void cmCTestLaunchReporter::DumpTextToXML(cmXMLElement& e3, char const* tag,
+                                          std::string const& text)
+{
+  std::istringstream fin(text);
+  this->DumpStreamToXML(e3, tag, fin);
+}
+
+void cmCTestLaunchReporter::DumpStreamToXML(cmXMLElement& e3, char const* tag,
+                                            std::istream& fin)
+{
   std::string line;
   char const* sep = "";
 
@@ -289,6 +295,24 @@ void cmCTestLaunchReporter::DumpFileToXML(cmXMLElement& e3, char const* tag,
   }
 }
 
+void cmCTestLaunchReporter::WriteLaunchRecord(
+  std::string const& fragment, std::chrono::milliseconds duration) const
+{
+  cmCryptoHash md5(cmCryptoHash::AlgoMD5);
+  md5.Initialize();
+  md5.Append(this->StdOut);
+  md5.Append(this->StdErr);
+  std::string const record =
+    cmStrCat(this->ExitCode, '\t', duration.count(), '\t', md5.FinalizeHex(),
+             '\t', fragment, '\n');
+
+  // Launchers of parallel jobs append to the same log.  Write each record
+  // with a single call so that records do not interleave.
+  cmsys::ofstream fout(cmStrCat(this->LogDir, LaunchLogName).c_str(),
+                       std::ios::out | std::ios::app | std::ios::binary);
+  fout.write(record.data(), static_cast<std::streamsize>(record.size()));
+}
+
 bool cmCTestLaunchReporter::Match(
   std::string const& line, std::vector<cmsys::RegularExpression>& regexps)
 {
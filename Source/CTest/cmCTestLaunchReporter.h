@@ -4,6 +4,8 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <chrono>
+#include <iosfwd>
 #include <set>
 #include <string>
 #include <vector>
@@ -22,7 +24,6 @@ class cmCTestLaunchReporter
 public:
   // Initialize the launcher from its command line.
   cmCTestLaunchReporter();
-  ~cmCTestLaunchReporter();
 
   cmCTestLaunchReporter(cmCTestLaunchReporter const&) = delete;
   cmCTestLaunchReporter& operator=(cmCTestLaunchReporter const&) = delete;
@@ -58,10 +59,18 @@ public:
   cmUVProcessChain::Status Status;
   int ExitCode;
 
-  // Temporary log files for stdout and stderr of real command.
+  // Output of the real command.  A log file, if given, is reported
+  // instead of the output kept in memory.
   std::string LogDir;
+  std::string StdOut;
+  std::string StdErr;
   std::string LogOut;
-  std::string LogErr;
+
+  // Append-only log in LogDir with one record per launched command:
+  // "<exit code>\t<milliseconds>\t<output hash>\t<xml fragment>".
+  static constexpr char const* LaunchLogName = "CTestLaunchLog.txt";
+  void WriteLaunchRecord(std::string const& fragment,
+                         std::chrono::milliseconds duration) const;
 
   // Labels associated with the build rule.
   std::set<std::string> Labels;
@@ -76,12 +85,15 @@ public:
   bool MatchesFilterPrefix(std::string const& line) const;
 
   // Methods to generate the xml fragment.
+  std::string GetXMLFileName() const;
   void WriteXML();
   void WriteXMLAction(cmXMLElement&) const;
   void WriteXMLCommand(cmXMLElement&);
   void WriteXMLResult(cmXMLElement&);
   void WriteXMLLabels(cmXMLElement&);
   void DumpFileToXML(cmXMLElement&, char const* tag, std::string const& fname);
+  void DumpTextToXML(cmXMLElement&, char const* tag, std::string const& text);
+  void DumpStreamToXML(cmXMLElement&, char const* tag, std::istream& fin);
 
   // Configuration
   std::string SourceDir;
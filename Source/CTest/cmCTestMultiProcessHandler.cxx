@@ -8,9 +8,12 @@
 #include <cmath>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdlib>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <queue>
 #include <sstream>
 #include <stack>
 #include <unordered_map>
@@ -140,6 +143,14 @@ bool cmCTestMultiProcessHandler::SetTests(TestMap tests,
   this->Total = this->PendingTests.size();
   if (!this->CTest->GetShowOnly()) {
     this->ReadCostData();
+    this->ReadTestStatistics();
+    if (this->GetParallelLevel() > 1) {
+      cmsys::SystemInformation info;
+      info.RunMemoryCheck();
+      this->AvailableMemory =
+        static_cast<std::uint64_t>(info.GetAvailablePhysicalMemory()) *
+        1024 * 1024;
+    }
     this->HasCycles = !this->CheckCycles();
     this->HasInvalidGeneratedResourceSpec =
       !this->CheckGeneratedResourceSpec();
@@ -241,11 +252,27 @@ void cmCTestMultiProcessHandler::RunTests()
   }
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
 
+  double predicted = 0;
+  if (this->ScheduleCriticalPath) {
+    predicted = this->PredictMakespan();
+  }
+  auto const start = std::chrono::steady_clock::now();
+
   this->InitializeLoop();
   this->StartNextTestsOnIdle();
   uv_run(this->Loop, UV_RUN_DEFAULT);
   this->FinalizeLoop();
 
+  if (this->ScheduleCriticalPath) {
+    double const actual = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    cmCTestLog(this->CTest, HANDLER_OUTPUT,
+               "\nCritical path schedule: predicted "
+                 << std::fixed << std::setprecision(2) << predicted
+                 << " sec, actual " << actual << " sec" << std::endl);
+  }
+
   if (!this->StopTimePassed && !this->CheckStopOnFailure()) {
     assert(this->Complete());
     assert(this->PendingTests.empty());
@@ -505,6 +532,17 @@ void cmCTestMultiProcessHandler::LockResources(int index)
     this->SerialTestRunning = true;
   }
 
+  if (properties->PeakMemory) {
+    this->ReservedMemory[index] = properties->PeakMemory;
+    this->RunningMemory += properties->PeakMemory;
+  }
+
+  if (this->ScheduleCriticalPath) {
+    this->ExpectedFinish[index] = std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(this->GetScheduleCost(index)));
+  }
+
   if (this->HaveAffinity && properties->WantAffinity) {
     size_t needProcessors = this->GetProcessorsUsed(index);
     assert(needProcessors <= this->ProcessorsAvailable.size());
@@ -536,6 +574,13 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
     this->SerialTestRunning = false;
   }
 
+  auto reserved = this->ReservedMemory.find(index);
+  if (reserved != this->ReservedMemory.end()) {
+    this->RunningMemory -= reserved->second;
+    this->ReservedMemory.erase(reserved);
+  }
+  this->ExpectedFinish.erase(index);
+
   this->RunningCount -= this->GetProcessorsUsed(index);
 }
 
@@ -647,6 +692,11 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
   }
 
+  // With the critical path schedule, once a ready test does not fit in
+  // the free processors, start only tests expected to finish before
+  // enough processors are free for it.
+  cm::optional<double> backfillLimit;
+
   // Start tests in the preferred order, each subject to readiness checks.
   auto ti = this->OrderedTests.begin();
   while (numToStart > 0 && !this->SerialTestRunning &&
@@ -689,6 +739,15 @@ void cmCTestMultiProcessHandler::StartNextTests()
 
     // Exclude tests that are too big to fit in the concurrency limit.
     if (processors > numToStart) {
+      if (this->ScheduleCriticalPath && !backfillLimit) {
+        backfillLimit =
+          this->GetSecondsUntilProcessorsFree(processors - numToStart);
+      }
+      continue;
+    }
+
+    // Exclude tests that would delay the test waiting for processors.
+    if (backfillLimit && this->GetScheduleCost(test) > *backfillLimit) {
       continue;
     }
 
@@ -697,6 +756,12 @@ void cmCTestMultiProcessHandler::StartNextTests()
       continue;
     }
 
+    // Exclude tests whose peak memory in previous runs does not fit
+    // beside that of the running tests.
+    if (!this->MemoryAvailable(test)) {
+      continue;
+    }
+
     // Allocate system resources needed by this test.
     if (!this->AllocateResources(test)) {
       continue;
@@ -872,6 +937,8 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   }
   fout.close();
   cmSystemTools::RenameFile(tmpout, fname);
+
+  this->WriteTestStatistics();
 }
 
 void cmCTestMultiProcessHandler::ReadCostData()
@@ -918,6 +985,105 @@ void cmCTestMultiProcessHandler::ReadCostData()
   }
 }
 
+std::string cmCTestMultiProcessHandler::GetTestStatisticsFile()
+{
+  return cmStrCat(
+    cmSystemTools::GetFilenamePath(this->CTest->GetCostDataFile()),
+    "/CTestTestStatistics.json");
+}
+
+void cmCTestMultiProcessHandler::ReadTestStatistics()
+{
+  std::string const fname = this->GetTestStatisticsFile();
+  if (!cmSystemTools::FileExists(fname, true)) {
+    return;
+  }
+  Json::Value root;
+  cmJSONState state(fname, &root);
+  if (!state.errors.empty() || !root["tests"].isObject()) {
+    // Ignore a damaged file, it will be rewritten after this run.
+    return;
+  }
+
+  std::unordered_map<std::string, int> indexes;
+  for (auto const& p : this->Properties) {
+    indexes.emplace(p.second->Name, p.first);
+  }
+  Json::Value const& tests = root["tests"];
+  for (auto i = tests.begin(); i != tests.end(); ++i) {
+    auto index = indexes.find(i.name());
+    if (index == indexes.end() || !i->isObject()) {
+      continue;
+    }
+    auto* p = this->Properties[index->second];
+    p->DurationMean = (*i)["mean"].asDouble();
+    p->DurationVariance = (*i)["variance"].asDouble();
+    p->DurationSamples = (*i)["samples"].asInt();
+    p->PeakMemory = (*i)["peakMemory"].asUInt64();
+    p->History = (*i)["history"].asString();
+  }
+}
+
+void cmCTestMultiProcessHandler::WriteTestStatistics()
+{
+  std::string const fname = this->GetTestStatisticsFile();
+
+  // Keep the entries of tests that did not run.
+  Json::Value root;
+  if (cmSystemTools::FileExists(fname, true)) {
+    cmJSONState state(fname, &root);
+    if (!state.errors.empty() || !root.isObject()) {
+      root = Json::Value();
+    }
+  }
+  root["version"] = 1;
+  Json::Value& tests = root["tests"];
+  if (!tests.isObject()) {
+    tests = Json::objectValue;
+  }
+  for (auto const& p : this->Properties) {
+    auto const* props = p.second;
+    if (props->DurationSamples == 0 && props->History.empty()) {
+      continue;
+    }
+    Json::Value& test = tests[props->Name] = Json::objectValue;
+    test["mean"] = props->DurationMean;
+    test["variance"] = props->DurationVariance;
+    test["samples"] = props->DurationSamples;
+    test["peakMemory"] = static_cast<Json::UInt64>(props->PeakMemory);
+    test["history"] = props->History;
+  }
+
+  std::string const tmpout = fname + ".tmp";
+  cmsys::ofstream fout(tmpout.c_str());
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = " ";
+  std::unique_ptr<Json::StreamWriter> jout(builder.newStreamWriter());
+  jout->write(root, &fout);
+  fout << "\n";
+  fout.close();
+  cmSystemTools::RenameFile(tmpout, fname);
+}
+
+double cmCTestMultiProcessHandler::GetScheduleCost(int test)
+{
+  // Plan for slow runs: use the 90th percentile of the recent durations,
+  // assuming they are normally distributed.
+  auto const* p = this->Properties[test];
+  if (p->DurationSamples >= 2) {
+    return p->DurationMean + 1.2816 * std::sqrt(p->DurationVariance);
+  }
+  return p->Cost;
+}
+
+bool cmCTestMultiProcessHandler::MemoryAvailable(int test)
+{
+  std::uint64_t const memory = this->Properties[test]->PeakMemory;
+  return this->RunningCount == 0 || memory == 0 ||
+    this->AvailableMemory == 0 ||
+    this->RunningMemory + memory <= this->AvailableMemory;
+}
+
 int cmCTestMultiProcessHandler::SearchByName(cm::string_view name)
 {
   int index = -1;
@@ -933,8 +1099,15 @@ int cmCTestMultiProcessHandler::SearchByName(cm::string_view name)
 void cmCTestMultiProcessHandler::CreateTestCostList()
 {
   if (this->GetParallelLevel() > 1) {
-    this->CreateParallelTestCostList();
+    if (this->ScheduleCriticalPath) {
+      this->CreateCriticalPathTestCostList();
+    } else {
+      this->CreateParallelTestCostList();
+    }
   } else {
+    // Serial runs have nothing to schedule around, and the makespan
+    // prediction needs the dependents recorded by the parallel ordering.
+    this->ScheduleCriticalPath = false;
     this->CreateSerialTestCostList();
   }
 }
@@ -997,6 +1170,180 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
   }
 }
 
+void cmCTestMultiProcessHandler::CreateCriticalPathTestCostList()
+{
+  // Order the tests so that each follows the tests it depends on.
+  std::map<int, size_t> waiting;
+  TestList order;
+  for (auto const& t : this->PendingTests) {
+    size_t count = 0;
+    for (int dep : t.second.Depends) {
+      if (cm::contains(this->PendingTests, dep)) {
+        this->Dependents[dep].push_back(t.first);
+        ++count;
+      }
+    }
+    waiting[t.first] = count;
+    if (count == 0) {
+      order.push_back(t.first);
+    }
+  }
+  for (size_t i = 0; i < order.size(); ++i) {
+    for (int dependent : this->Dependents[order[i]]) {
+      if (--waiting[dependent] == 0) {
+        order.push_back(dependent);
+      }
+    }
+  }
+
+  // The priority of a test is the total cost of the longest chain of
+  // tests that starts with it, through DEPENDS and fixtures.  Its depth
+  // is the number of tests in the longest such chain.
+  std::map<int, double> priority;
+  std::map<int, size_t> depth;
+  for (int test : cmReverseRange(order)) {
+    double longest = 0;
+    size_t deepest = 0;
+    for (int dependent : this->Dependents[test]) {
+      longest = std::max(longest, priority[dependent]);
+      deepest = std::max(deepest, depth[dependent]);
+    }
+    priority[test] = this->GetScheduleCost(test) + longest;
+    depth[test] = deepest + 1;
+  }
+
+  // Break ties by the processor time and resource slots a test needs,
+  // so that large tests start early rather than extend the tail.
+  auto area = [this](int test) -> double {
+    return this->GetScheduleCost(test) *
+      static_cast<double>(this->GetProcessorsUsed(test));
+  };
+  auto slots = [this](int test) -> int {
+    int total = 0;
+    for (auto const& group : this->Properties[test]->ResourceGroups) {
+      for (auto const& requirement : group) {
+        total += requirement.SlotsNeeded * requirement.UnitsNeeded;
+      }
+    }
+    return total;
+  };
+
+  // As with the default schedule, previously failed tests run first.
+  TestList sorted;
+  for (int test : order) {
+    if (cm::contains(this->LastTestsFailed, this->Properties[test]->Name)) {
+      this->OrderedTests.push_back(test);
+    } else {
+      sorted.push_back(test);
+    }
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [&](int l, int r) -> bool {
+    if (priority[l] != priority[r]) {
+      return priority[l] > priority[r];
+    }
+    if (depth[l] != depth[r]) {
+      return depth[l] > depth[r];
+    }
+    if (area(l) != area(r)) {
+      return area(l) > area(r);
+    }
+    return slots(l) > slots(r);
+  });
+  cm::append(this->OrderedTests, sorted);
+}
+
+double cmCTestMultiProcessHandler::PredictMakespan()
+{
+  // Simulate the schedule using the test costs as durations, limited
+  // only by the parallel level.
+  size_t const parallelLevel = this->GetParallelLevel();
+  std::map<int, size_t> rank;
+  for (int test : this->OrderedTests) {
+    rank.emplace(test, rank.size());
+  }
+  std::map<int, size_t> waiting;
+  std::set<std::pair<size_t, int>> ready;
+  for (int test : this->OrderedTests) {
+    size_t count = 0;
+    for (int dep : this->PendingTests[test].Depends) {
+      if (cm::contains(rank, dep)) {
+        ++count;
+      }
+    }
+    waiting[test] = count;
+    if (count == 0) {
+      ready.emplace(rank[test], test);
+    }
+  }
+
+  struct Running
+  {
+    double Finish;
+    int Test;
+    size_t Processors;
+    bool operator>(Running const& other) const
+    {
+      return this->Finish > other.Finish;
+    }
+  };
+  std::priority_queue<Running, std::vector<Running>, std::greater<Running>>
+    running;
+  size_t used = 0;
+  double now = 0;
+  for (;;) {
+    for (auto i = ready.begin(); i != ready.end();) {
+      int const test = i->second;
+      size_t const processors = this->Properties[test]->RunSerial
+        ? parallelLevel
+        : this->GetProcessorsUsed(test);
+      if (used + processors > parallelLevel) {
+        ++i;
+        continue;
+      }
+      used += processors;
+      running.push({ now + this->GetScheduleCost(test), test, processors });
+      i = ready.erase(i);
+    }
+    if (running.empty()) {
+      break;
+    }
+    Running const done = running.top();
+    running.pop();
+    now = done.Finish;
+    used -= done.Processors;
+    for (int dependent : this->Dependents[done.Test]) {
+      if (--waiting[dependent] == 0) {
+        ready.emplace(rank[dependent], dependent);
+      }
+    }
+  }
+  return now;
+}
+
+double cmCTestMultiProcessHandler::GetSecondsUntilProcessorsFree(
+  size_t processors)
+{
+  // Tests running past their expected finish give no estimate, so
+  // only those still expected to finish are considered.
+  auto const now = std::chrono::steady_clock::now();
+  std::vector<std::pair<std::chrono::steady_clock::time_point, size_t>>
+    finishes;
+  for (auto const& f : this->ExpectedFinish) {
+    if (f.second > now) {
+      finishes.emplace_back(f.second, this->GetProcessorsUsed(f.first));
+    }
+  }
+  std::sort(finishes.begin(), finishes.end());
+  size_t freed = 0;
+  for (auto const& f : finishes) {
+    freed += f.second;
+    if (freed >= processors) {
+      return std::chrono::duration<double>(f.first - now).count();
+    }
+  }
+  return std::numeric_limits<double>::infinity();
+}
+
 void cmCTestMultiProcessHandler::GetAllTestDependencies(int test,
                                                         TestList& dependencies)
 {
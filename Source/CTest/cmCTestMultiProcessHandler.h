@@ -4,7 +4,9 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
@@ -97,6 +99,10 @@ public:
 
   void SetQuiet(bool b) { this->Quiet = b; }
 
+  // Order tests by their critical path through dependencies and hold
+  // back tests that would delay a waiting multi-processor test.
+  void SetScheduleCriticalPath(bool b) { this->ScheduleCriticalPath = b; }
+
   void CheckResourceAvailability();
 
 protected:
@@ -110,6 +116,11 @@ protected:
 
   void UpdateCostData();
   void ReadCostData();
+  std::string GetTestStatisticsFile();
+  void ReadTestStatistics();
+  void WriteTestStatistics();
+  double GetScheduleCost(int test);
+  bool MemoryAvailable(int test);
   // Return index of a test based on its name
   int SearchByName(cm::string_view name);
 
@@ -120,6 +131,10 @@ protected:
 
   void CreateParallelTestCostList();
 
+  void CreateCriticalPathTestCostList();
+  double PredictMakespan();
+  double GetSecondsUntilProcessorsFree(size_t processors);
+
   // Removes the checkpoint file
   void MarkFinished();
   void FinishTestProcess(std::unique_ptr<cmCTestRunTest> runner, bool started);
@@ -231,4 +246,17 @@ private:
   int RepeatCount = 1;
   bool Quiet = false;
   bool SerialTestRunning = false;
+
+  bool ScheduleCriticalPath = false;
+  // Tests that depend on each test, for the critical path schedule.
+  std::map<int, TestList> Dependents;
+  // Expected finish time of each running test, from its cost.
+  std::map<int, std::chrono::steady_clock::time_point> ExpectedFinish;
+
+  // Physical memory available on the host when testing started, not used
+  // by other processes, and the recorded peak memory of the running tests,
+  // in bytes.
+  std::uint64_t AvailableMemory = 0;
+  std::uint64_t RunningMemory = 0;
+  std::map<int, std::uint64_t> ReservedMemory;
 };
@@ -0,0 +1,142 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmCTestOutputCapture.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <cm3p/zlib.h>
+
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+// Extra bytes kept on each side so that truncation at the limit does not
+// depend on a multi-byte UTF-8 encoding cut by the omitted part.
+size_t const kUTF8Slack = 4;
+}
+
+cmCTestOutputCapture::~cmCTestOutputCapture()
+{
+  this->Close();
+}
+
+void cmCTestOutputCapture::Start(size_t limit, std::string spillFile)
+{
+  this->Close();
+  this->Keep = limit ? limit + kUTF8Slack : 0;
+  this->SpillFile = std::move(spillFile);
+  this->Spilled = false;
+  this->FullOutput = false;
+  this->Total = 0;
+  this->Head.clear();
+  this->Tail.clear();
+  this->TailPos = 0;
+  this->TailWrapped = false;
+}
+
+void cmCTestOutputCapture::Append(std::string const& text)
+{
+  this->Total += text.size();
+  if (!this->FullOutput &&
+      text.find("CTEST_FULL_OUTPUT") != std::string::npos) {
+    this->FullOutput = true;
+  }
+
+  if (!this->Spilled) {
+    this->Head += text;
+    if (this->Keep && this->Head.size() > 2 * this->Keep && !this->Spill()) {
+      // Without a spill file all output stays in memory.
+      this->Keep = 0;
+    }
+    return;
+  }
+
+  if (this->File) {
+    gzwrite(this->File, text.data(), static_cast<unsigned>(text.size()));
+  }
+  this->AppendTail(text.data(), text.size());
+}
+
+bool cmCTestOutputCapture::Spill()
+{
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(this->SpillFile));
+  this->File = gzopen(this->SpillFile.c_str(), "wb");
+  if (!this->File) {
+    return false;
+  }
+  gzwrite(this->File, this->Head.data(),
+          static_cast<unsigned>(this->Head.size()));
+  this->Spilled = true;
+  this->Tail.resize(this->Keep);
+  this->AppendTail(this->Head.data() + this->Keep,
+                   this->Head.size() - this->Keep);
+  this->Head.resize(this->Keep);
+  this->Head.shrink_to_fit();
+  return true;
+}
+
+void cmCTestOutputCapture::AppendTail(char const* data, size_t size)
+{
+  size_t const capacity = this->Tail.size();
+  if (size >= capacity) {
+    std::copy(data + size - capacity, data + size, this->Tail.begin());
+    this->TailPos = 0;
+    this->TailWrapped = true;
+    return;
+  }
+  size_t const first = std::min(size, capacity - this->TailPos);
+  std::copy(data, data + first, this->Tail.begin() + this->TailPos);
+  std::copy(data + first, data + size, this->Tail.begin());
+  if (this->TailPos + size >= capacity) {
+    this->TailWrapped = true;
+  }
+  this->TailPos = (this->TailPos + size) % capacity;
+}
+
+void cmCTestOutputCapture::Close()
+{
+  if (this->File) {
+    gzclose(this->File);
+    this->File = nullptr;
+  }
+}
+
+std::string cmCTestOutputCapture::Finish()
+{
+  if (!this->Spilled) {
+    return std::move(this->Head);
+  }
+  this->Close();
+
+  std::string output;
+  if (this->FullOutput) {
+    gzFile gf = gzopen(this->SpillFile.c_str(), "rb");
+    if (gf) {
+      output.reserve(static_cast<size_t>(this->Total));
+      char buffer[16384];
+      int n;
+      while ((n = gzread(gf, buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, static_cast<size_t>(n));
+      }
+      gzclose(gf);
+      if (n == 0) {
+        return output;
+      }
+      output.clear();
+    }
+  }
+
+  std::uint64_t const omitted =
+    this->Total - this->Head.size() - this->Tail.size();
+  output = cmStrCat(std::move(this->Head), "\n[", omitted,
+                    " bytes of test output are omitted here.  The full "
+                    "output is in ",
+                    this->SpillFile, "]\n");
+  if (this->TailWrapped) {
+    output.append(this->Tail.begin() + this->TailPos, this->Tail.end());
+  }
+  output.append(this->Tail.begin(), this->Tail.begin() + this->TailPos);
+  return output;
+}
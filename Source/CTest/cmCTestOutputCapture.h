@@ -0,0 +1,64 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct gzFile_s;
+
+/** \class cmCTestOutputCapture
+ * \brief Capture of the output of a test in bounded memory.
+ *
+ * Output is kept in memory until it exceeds twice the limit.  From then
+ * on only its beginning and its end are kept in memory, enough to
+ * truncate it to the limit from either side, and the full output is
+ * written to a compressed file instead.
+ */
+class cmCTestOutputCapture
+{
+public:
+  cmCTestOutputCapture() = default;
+  ~cmCTestOutputCapture();
+
+  cmCTestOutputCapture(cmCTestOutputCapture const&) = delete;
+  cmCTestOutputCapture& operator=(cmCTestOutputCapture const&) = delete;
+
+  /** Start a new capture.  A limit of 0 keeps all output in memory.  */
+  void Start(size_t limit, std::string spillFile);
+
+  void Append(std::string const& text);
+
+  /** Whether the output was written to the spill file.  */
+  bool IsSpilled() const { return this->Spilled; }
+
+  /** The output captured so far.  Complete only if not spilled.  */
+  std::string const& GetOutput() const { return this->Head; }
+
+  std::string const& GetSpillFile() const { return this->SpillFile; }
+
+  /** Finish the capture and return the output kept in memory, with a
+      note in place of the omitted part.  The full output is read back
+      from the spill file if it contains CTEST_FULL_OUTPUT.  */
+  std::string Finish();
+
+private:
+  bool Spill();
+  void AppendTail(char const* data, size_t size);
+  void Close();
+
+  size_t Keep = 0;
+  std::string SpillFile;
+  gzFile_s* File = nullptr;
+  bool Spilled = false;
+  bool FullOutput = false;
+  std::uint64_t Total = 0;
+  std::string Head;
+  std::vector<char> Tail;
+  size_t TailPos = 0;
+  bool TailWrapped = false;
+};
@@ -74,13 +74,25 @@ void cmCTestRunTest::CheckOutput(std::string const& line)
     }
   }
 
-  this->ProcessOutput += line;
-  this->ProcessOutput += "\n";
+  this->OutputCapture.Append(cmStrCat(line, '\n'));
+
+  if (this->InMeasurement ||
+      line.find("<DartMeasurement") != std::string::npos ||
+      line.find("<CTestMeasurement") != std::string::npos) {
+    this->MeasurementOutput += cmStrCat(line, '\n');
+    this->InMeasurement =
+      line.find("</DartMeasurement") == std::string::npos &&
+      line.find("</CTestMeasurement") == std::string::npos;
+  }
 
-  // Check for TIMEOUT_AFTER_MATCH property.
+  // Check for TIMEOUT_AFTER_MATCH property.  Once the output is spilled
+  // to disk only the new line is matched.
   if (!this->TestProperties->TimeoutRegularExpressions.empty()) {
+    std::string const& output = this->OutputCapture.IsSpilled()
+      ? line
+      : this->OutputCapture.GetOutput();
     for (auto& reg : this->TestProperties->TimeoutRegularExpressions) {
-      if (reg.first.find(this->ProcessOutput)) {
+      if (reg.first.find(output)) {
         cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                    this->GetIndex()
                      << ": "
@@ -103,6 +115,7 @@ cmCTestRunTest::EndTestResult cmCTestRunTest::EndTest(size_t completed,
                                                       size_t total,
                                                       bool started)
 {
+  this->ProcessOutput = this->OutputCapture.Finish();
   this->WriteLogOutputTop(completed, total);
   std::string reason;
   bool passed = true;
@@ -368,11 +381,14 @@ cmCTestRunTest::EndTestResult cmCTestRunTest::EndTest(size_t completed,
     this->TestResult.ExecutionTime = this->TestProcess->GetTotalTime();
     this->MemCheckPostProcess();
     this->ComputeWeightedCost();
+    if (!skipped) {
+      this->UpdateStatistics(passed);
+    }
   }
   // If the test does not need to rerun push the current TestResult onto the
   // TestHandler vector
   if (!this->NeedsToRepeat()) {
-    this->TestHandler->TestResults.push_back(this->TestResult);
+    this->TestHandler->RecordTestResult(this->TestResult);
   }
   cmCTestRunTest::EndTestResult testResult;
   testResult.Passed = passed || skipped;
@@ -445,6 +461,41 @@ void cmCTestRunTest::ComputeWeightedCost()
   }
 }
 
+void cmCTestRunTest::UpdateStatistics(bool passed)
+{
+  auto* p = this->TestProperties;
+
+  // Keep the outcomes of the most recent runs.
+  static std::string::size_type const historySize = 20;
+  p->History += passed ? 'P' : 'F';
+  if (p->History.size() > historySize) {
+    p->History.erase(0, p->History.size() - historySize);
+  }
+
+  if (std::uint64_t memory = this->TestProcess->GetPeakMemory()) {
+    p->PeakMemory = memory;
+  }
+
+  if (this->TestResult.Status != cmCTestTestHandler::COMPLETED) {
+    return;
+  }
+
+  // Exponentially weighted moving average and variance of the duration,
+  // so that estimates follow changes in the test.
+  static double const alpha = 0.25;
+  double const current = this->TestResult.ExecutionTime.count();
+  if (p->DurationSamples == 0) {
+    p->DurationMean = current;
+    p->DurationVariance = 0;
+  } else {
+    double const diff = current - p->DurationMean;
+    double const incr = alpha * diff;
+    p->DurationMean += incr;
+    p->DurationVariance = (1.0 - alpha) * (p->DurationVariance + diff * incr);
+  }
+  p->DurationSamples++;
+}
+
 void cmCTestRunTest::MemCheckPostProcess()
 {
   if (!this->TestHandler->MemCheck) {
@@ -487,6 +538,7 @@ void cmCTestRunTest::StartFailure(size_t total, std::string const& output,
   }
 
   this->ProcessOutput.clear();
+  this->StartOutputCapture();
   if (!output.empty()) {
     *this->TestHandler->LogFile << output << std::endl;
     cmCTestLog(this->CTest, ERROR_MESSAGE, output << std::endl);
@@ -557,6 +609,7 @@ bool cmCTestRunTest::StartTest(size_t completed, size_t total)
   }
 
   this->ProcessOutput.clear();
+  this->StartOutputCapture();
 
   this->TestResult.Properties = this->TestProperties;
   this->TestResult.ExecutionTime = cmDuration::zero();
@@ -745,13 +798,38 @@ void cmCTestRunTest::ComputeArguments()
   }
 }
 
+void cmCTestRunTest::StartOutputCapture()
+{
+  // Output that will be truncated is captured in bounded memory, unless
+  // all of it must be matched or post-processed.
+  cmCTestTestOptions const& options = this->TestHandler->TestOptions;
+  size_t limit = 0;
+  if (!this->TestHandler->MemCheck && options.OutputSizePassed > 0 &&
+      options.OutputSizeFailed > 0 &&
+      this->TestProperties->RequiredRegularExpressions.empty() &&
+      this->TestProperties->ErrorRegularExpressions.empty() &&
+      this->TestProperties->SkipRegularExpressions.empty()) {
+    limit = static_cast<size_t>(
+      std::max(options.OutputSizePassed, options.OutputSizeFailed));
+  }
+  this->OutputCapture.Start(
+    limit,
+    cmStrCat(this->CTest->GetBinaryDir(), "/Testing/Temporary/TestOutput_",
+             this->TestProperties->Index, ".txt.gz"));
+  this->MeasurementOutput.clear();
+  this->InMeasurement = false;
+}
+
 void cmCTestRunTest::ParseOutputForMeasurements()
 {
-  if (!this->ProcessOutput.empty() &&
-      (this->ProcessOutput.find("<DartMeasurement") != std::string::npos ||
-       this->ProcessOutput.find("<CTestMeasurement") != std::string::npos)) {
-    if (this->TestHandler->AllTestMeasurementsRegex.find(
-          this->ProcessOutput)) {
+  // Measurements may be in the part of a spilled output that is omitted.
+  std::string const& measurements = this->OutputCapture.IsSpilled()
+    ? this->MeasurementOutput
+    : this->ProcessOutput;
+  if (!measurements.empty() &&
+      (measurements.find("<DartMeasurement") != std::string::npos ||
+       measurements.find("<CTestMeasurement") != std::string::npos)) {
+    if (this->TestHandler->AllTestMeasurementsRegex.find(measurements)) {
       this->TestResult.TestMeasurementsOutput =
         this->TestHandler->AllTestMeasurementsRegex.match(1);
       // keep searching and replacing until none are left
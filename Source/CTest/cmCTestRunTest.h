@@ -13,6 +13,7 @@
 
 #include "cmCTest.h"
 #include "cmCTestMultiProcessHandler.h"
+#include "cmCTestOutputCapture.h"
 #include "cmCTestTestHandler.h"
 #include "cmProcess.h"
 
@@ -79,6 +80,7 @@ public:
   void ComputeArguments();
 
   void ComputeWeightedCost();
+  void UpdateStatistics(bool passed);
 
   void StartFailure(size_t total, std::string const& output,
                     std::string const& detail);
@@ -115,6 +117,8 @@ private:
 
   void SetupResourcesEnvironment(std::vector<std::string>* log = nullptr);
 
+  void StartOutputCapture();
+
   // Returns "completed/total Test #Index: "
   std::string GetTestPrefix(size_t completed, size_t total) const;
 
@@ -126,6 +130,11 @@ private:
 
   std::unique_ptr<cmProcess> TestProcess;
   std::string ProcessOutput;
+  cmCTestOutputCapture OutputCapture;
+  // Measurement tags found in the output, kept for when the output does
+  // not fit in memory.
+  std::string MeasurementOutput;
+  bool InMeasurement = false;
   cmCTestTestHandler::cmCTestTestResult TestResult;
   std::set<std::string> FailedDependencies;
   std::string StartTime;
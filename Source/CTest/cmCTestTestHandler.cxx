@@ -345,6 +345,21 @@ int cmCTestTestHandler::PostProcessHandler()
   return 1;
 }
 
+class cmCTestTestHandler::OutputSpoolHelper
+{
+public:
+  OutputSpoolHelper(cmCTestTestHandler* handler)
+    : Handler(handler)
+  {
+  }
+  ~OutputSpoolHelper() { this->Handler->CloseOutputSpool(); }
+  OutputSpoolHelper(OutputSpoolHelper const&) = delete;
+  OutputSpoolHelper& operator=(OutputSpoolHelper const&) = delete;
+
+private:
+  cmCTestTestHandler* Handler;
+};
+
 int cmCTestTestHandler::ProcessHandler()
 {
   if (!this->ProcessOptions()) {
@@ -370,6 +385,9 @@ int cmCTestTestHandler::ProcessHandler()
   std::vector<std::string> passed;
   std::vector<std::string> failed;
 
+  // The output spool opened by ProcessDirectory is removed on return.
+  OutputSpoolHelper outputSpoolHelper(this);
+
   // start the real time clock
   auto clock_start = std::chrono::steady_clock::now();
 
@@ -469,6 +487,8 @@ bool cmCTestTestHandler::ProcessOptions()
   this->SetTestsToRunInformation(this->TestOptions.TestsToRunInformation);
   if (this->TestOptions.ScheduleRandom) {
     this->CTest->SetScheduleType("Random");
+  } else if (this->TestOptions.ScheduleCriticalPath) {
+    this->CTest->SetScheduleType("CriticalPath");
   }
   if (auto repeat = this->Repeat) {
     cmsys::RegularExpression repeatRegex(
@@ -494,6 +514,26 @@ bool cmCTestTestHandler::ProcessOptions()
       return false;
     }
   }
+  if (!this->TestOptions.Shard.empty()) {
+    cmsys::RegularExpression shardRegex("^([0-9]+)/([0-9]+)$");
+    unsigned long index = 0;
+    unsigned long count = 0;
+    if (!shardRegex.find(this->TestOptions.Shard) ||
+        !cmStrToULong(shardRegex.match(1), &index) ||
+        !cmStrToULong(shardRegex.match(2), &count) || index < 1 ||
+        index > count) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Shard option invalid value: " << this->TestOptions.Shard
+                                                << std::endl);
+      return false;
+    }
+    this->ShardIndex = index;
+    this->ShardCount = count;
+    if (!this->TestOptions.ShardCostFile.empty() &&
+        !this->ReadShardCostFile(this->TestOptions.ShardCostFile)) {
+      return false;
+    }
+  }
   if (auto parallelLevel = this->ParallelLevel) {
     if (parallelLevel->empty()) {
       // An empty value tells ctest to choose a default.
@@ -899,6 +939,7 @@ bool cmCTestTestHandler::ComputeTestList()
     finalList.push_back(tp);
   }
 
+  this->ShardTestList(finalList);
   this->UpdateForFixtures(finalList);
 
   // Save the total number of tests before exclusions
@@ -928,6 +969,7 @@ bool cmCTestTestHandler::ComputeTestListForRerunFailed()
     finalList.push_back(tp);
   }
 
+  this->ShardTestList(finalList);
   this->UpdateForFixtures(finalList);
 
   // Save the total number of tests before exclusions
@@ -941,6 +983,157 @@ bool cmCTestTestHandler::ComputeTestListForRerunFailed()
   return true;
 }
 
+void cmCTestTestHandler::ShardTestList(ListOfTests& tests) const
+{
+  if (this->ShardCount < 2 || tests.empty()) {
+    return;
+  }
+
+  // Group tests that must run on the same shard: those linked through
+  // DEPENDS or through a fixture they set up, clean up or require.
+  std::vector<size_t> group(tests.size());
+  for (size_t i = 0; i < group.size(); ++i) {
+    group[i] = i;
+  }
+  auto find = [&group](size_t i) -> size_t {
+    while (group[i] != i) {
+      i = group[i] = group[group[i]];
+    }
+    return i;
+  };
+  auto join = [&group, &find](size_t a, size_t b) {
+    a = find(a);
+    b = find(b);
+    if (a != b) {
+      group[std::max(a, b)] = std::min(a, b);
+    }
+  };
+  std::map<std::string, size_t> byName;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    byName.emplace(tests[i].Name, i);
+  }
+  std::map<std::string, size_t> byFixture;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    cmCTestTestProperties const& p = tests[i];
+    for (std::string const& dep : p.Depends) {
+      auto it = byName.find(dep);
+      if (it != byName.end()) {
+        join(i, it->second);
+      }
+    }
+    for (auto const* fixtures :
+         { &p.FixturesSetup, &p.FixturesCleanup, &p.FixturesRequired }) {
+      for (std::string const& fixture : *fixtures) {
+        auto ins = byFixture.emplace(fixture, i);
+        if (!ins.second) {
+          join(i, ins.first->second);
+        }
+      }
+    }
+  }
+
+  // Weigh each test by its cost in the shard cost file, or else by its
+  // COST property.  Every machine must compute the partition from the same
+  // inputs to agree on it, so the costs measured in this build tree are
+  // not used.  Tests without a cost get the average of the known costs.
+  std::vector<double> cost(tests.size(), -1);
+  double known = 0;
+  size_t numKnown = 0;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    auto measured = this->ShardCosts.find(tests[i].Name);
+    if (measured != this->ShardCosts.end()) {
+      cost[i] = measured->second;
+    } else if (tests[i].Cost > 0) {
+      cost[i] = tests[i].Cost;
+    }
+    if (cost[i] >= 0) {
+      known += cost[i];
+      ++numKnown;
+    }
+  }
+  double const fallback =
+    numKnown > 0 ? known / static_cast<double>(numKnown) : 1;
+
+  // Identify each group by the least name of its tests, so that groups
+  // of equal cost are ordered by name rather than by test order.
+  std::vector<size_t> groups;
+  std::map<size_t, double> groupCost;
+  std::map<size_t, std::string const*> groupName;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    size_t const g = find(i);
+    if (g == i) {
+      groups.push_back(i);
+    }
+    groupCost[g] += cost[i] >= 0 ? cost[i] : fallback;
+    std::string const*& name = groupName[g];
+    if (!name || tests[i].Name < *name) {
+      name = &tests[i].Name;
+    }
+  }
+  std::sort(groups.begin(), groups.end(),
+            [&groupCost, &groupName](size_t l, size_t r) {
+              if (groupCost[l] != groupCost[r]) {
+                return groupCost[l] > groupCost[r];
+              }
+              return *groupName[l] < *groupName[r];
+            });
+
+  // Assign the most expensive groups first, each to the least loaded
+  // shard.
+  std::vector<double> load(this->ShardCount, 0);
+  std::set<size_t> selected;
+  for (size_t g : groups) {
+    auto shard = std::min_element(load.begin(), load.end());
+    *shard += groupCost[g];
+    if (static_cast<unsigned long>(shard - load.begin()) + 1 ==
+        this->ShardIndex) {
+      selected.insert(g);
+    }
+  }
+
+  ListOfTests shardList;
+  for (size_t i = 0; i < tests.size(); ++i) {
+    if (selected.count(find(i))) {
+      shardList.push_back(tests[i]);
+    }
+  }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Shard " << this->ShardIndex << '/' << this->ShardCount
+                              << " runs " << shardList.size() << " of "
+                              << tests.size() << " tests" << std::endl,
+                     this->Quiet);
+  tests = std::move(shardList);
+}
+
+bool cmCTestTestHandler::ReadShardCostFile(std::string const& fileName)
+{
+  cmsys::ifstream fin(fileName.c_str());
+  if (!fin) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Problem reading shard cost file: " << fileName << std::endl);
+    return false;
+  }
+  // Use the format of CTestCostData.txt: one "<name> <runs> <cost>" line
+  // per test, optionally followed by "---" and the names of failed tests.
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line) && line != "---") {
+    std::string::size_type const costPos = line.rfind(' ');
+    std::string::size_type const runsPos = costPos != std::string::npos &&
+        costPos > 0
+      ? line.rfind(' ', costPos - 1)
+      : std::string::npos;
+    if (runsPos == std::string::npos || runsPos == 0) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Invalid line in shard cost file " << fileName << ": "
+                                                    << line << std::endl);
+      return false;
+    }
+    this->ShardCosts[line.substr(0, runsPos)] =
+      atof(line.c_str() + costPos + 1);
+  }
+  return true;
+}
+
 void cmCTestTestHandler::UpdateForFixtures(ListOfTests& tests) const
 {
   cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
@@ -1308,6 +1501,8 @@ bool cmCTestTestHandler::ProcessDirectory(std::vector<std::string>& passed,
                             this->CTest->GetRepeatCount());
   }
   parallel->SetQuiet(this->Quiet);
+  parallel->SetScheduleCriticalPath(this->CTest->GetScheduleType() ==
+                                    "CriticalPath");
   if (this->TestLoad > 0) {
     parallel->SetTestLoad(this->TestLoad);
   } else {
@@ -1361,6 +1556,7 @@ bool cmCTestTestHandler::ProcessDirectory(std::vector<std::string>& passed,
   } else if (this->CTest->GetShowOnly()) {
     parallel->PrintTestList();
   } else {
+    this->OpenOutputSpool();
     parallel->RunTests();
   }
   this->EndTest = this->CTest->CurrentTime();
@@ -1372,6 +1568,86 @@ bool cmCTestTestHandler::ProcessDirectory(std::vector<std::string>& passed,
   return true;
 }
 
+void cmCTestTestHandler::OpenOutputSpool()
+{
+  this->CloseOutputSpool();
+  // Memory checkers parse the output after all tests have finished.
+  if (this->MemCheck) {
+    return;
+  }
+  this->OutputSpoolFile = cmStrCat(this->CTest->GetBinaryDir(),
+                                   "/Testing/Temporary/LastTestOutput.tmp");
+  this->OutputSpool.open(this->OutputSpoolFile.c_str(),
+                         std::ios::in | std::ios::out | std::ios::trunc |
+                           std::ios::binary);
+  if (!this->OutputSpool) {
+    cmCTestLog(this->CTest, WARNING,
+               "Cannot create test output spool file: "
+                 << this->OutputSpoolFile
+                 << "\nTest output will be kept in memory." << std::endl);
+    this->OutputSpool.clear();
+  }
+}
+
+void cmCTestTestHandler::CloseOutputSpool()
+{
+  if (this->OutputSpool.is_open()) {
+    this->OutputSpool.close();
+    cmSystemTools::RemoveFile(this->OutputSpoolFile);
+  }
+  this->OutputSpool.clear();
+}
+
+void cmCTestTestHandler::RecordTestResult(cmCTestTestResult result)
+{
+  if (!this->MemCheck && !this->CTest->GetProduceXML() &&
+      this->TestOptions.JUnitXMLFileName.empty()) {
+    // Nothing will ever write the output.
+    std::string().swap(result.Output);
+    std::string().swap(result.TestMeasurementsOutput);
+  } else if (this->OutputSpool.is_open()) {
+    std::streamoff const offset = this->OutputSpool.tellp();
+    this->OutputSpool.write(result.Output.data(), result.Output.size());
+    this->OutputSpool.write(result.TestMeasurementsOutput.data(),
+                            result.TestMeasurementsOutput.size());
+    // If the spool cannot be written, keep the output in memory.
+    if (offset >= 0 && this->OutputSpool) {
+      result.SpoolOffset = offset;
+      result.SpoolOutputSize = result.Output.size();
+      result.SpoolMeasurementsSize = result.TestMeasurementsOutput.size();
+      std::string().swap(result.Output);
+      std::string().swap(result.TestMeasurementsOutput);
+    }
+  }
+  this->TestResults.push_back(std::move(result));
+}
+
+void cmCTestTestHandler::ReadSpooledOutput(cmCTestTestResult const& result,
+                                           std::string& output,
+                                           std::string& measurements)
+{
+  if (result.SpoolOffset < 0) {
+    output = result.Output;
+    measurements = result.TestMeasurementsOutput;
+    return;
+  }
+  output.resize(result.SpoolOutputSize);
+  measurements.resize(result.SpoolMeasurementsSize);
+  this->OutputSpool.clear();
+  this->OutputSpool.seekg(result.SpoolOffset);
+  this->OutputSpool.read(&output[0], output.size());
+  this->OutputSpool.read(&measurements[0], measurements.size());
+  if (!this->OutputSpool) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Cannot read the output of test " << result.Name
+                                                 << " back from "
+                                                 << this->OutputSpoolFile
+                                                 << std::endl);
+    output.clear();
+    measurements.clear();
+  }
+}
+
 void cmCTestTestHandler::GenerateTestCommand(
   std::vector<std::string>& /*unused*/, int /*unused*/)
 {
@@ -1397,7 +1673,10 @@ void cmCTestTestHandler::GenerateCTestXML(cmXMLWriter& xml)
     xml.Element("Test", this->CTest->GetShortPathToFile(testPath));
   }
   xml.EndElement(); // TestList
+  std::string output;
+  std::string measurementsOutput;
   for (cmCTestTestResult& result : this->TestResults) {
+    this->ReadSpooledOutput(result, output, measurementsOutput);
     this->WriteTestResultHeader(xml, result);
     xml.StartElement("Results");
     if (result.Status != cmCTestTestHandler::NOT_RUN) {
@@ -1415,7 +1694,7 @@ void cmCTestTestHandler::GenerateCTestXML(cmXMLWriter& xml)
         xml.Element("Value", result.ReturnValue);
         xml.EndElement(); // NamedMeasurement
       }
-      this->RecordCustomTestMeasurements(xml, result.TestMeasurementsOutput);
+      this->RecordCustomTestMeasurements(xml, measurementsOutput);
       xml.StartElement("NamedMeasurement");
       xml.Attribute("type", "numeric/double");
       xml.Attribute("name", "Execution Time");
@@ -1474,7 +1753,7 @@ void cmCTestTestHandler::GenerateCTestXML(cmXMLWriter& xml)
       xml.Attribute("encoding", "base64");
       xml.Attribute("compression", "gzip");
     }
-    xml.Content(result.Output);
+    xml.Content(output);
     xml.EndElement(); // Value
     xml.EndElement(); // Measurement
 
@@ -2568,6 +2847,8 @@ bool cmCTestTestHandler::WriteJUnitXML()
                                               "%Y-%m-%dT%H:%M:%S", false));
 
   // Write <testcase> elements.
+  std::string output;
+  std::string measurementsOutput;
   for (cmCTestTestResult const& result : resultsSet) {
     xml.StartElement("testcase");
     xml.Attribute("name", result.Name);
@@ -2615,7 +2896,8 @@ bool cmCTestTestHandler::WriteJUnitXML()
 
     // Note: compressed test output is unconditionally disabled when
     // --output-junit is specified.
-    xml.Element("system-out", result.Output);
+    this->ReadSpooledOutput(result, output, measurementsOutput);
+    xml.Element("system-out", output);
     xml.EndElement(); // </testcase>
   }
 
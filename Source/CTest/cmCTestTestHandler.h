@@ -7,6 +7,7 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <ios>
 #include <iosfwd>
 #include <map>
 #include <set>
@@ -17,6 +18,7 @@
 #include <cm/optional>
 #include <cm/string_view>
 
+#include "cmsys/FStream.hxx"
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmCTest.h"
@@ -32,6 +34,7 @@ struct cmCTestTestOptions
 {
   bool RerunFailed = false;
   bool ScheduleRandom = false;
+  bool ScheduleCriticalPath = false;
   bool StopOnFailure = false;
   bool UseUnion = false;
 
@@ -54,6 +57,8 @@ struct cmCTestTestOptions
   std::string TestListFile;
   std::string ExcludeTestListFile;
   std::string ResourceSpecFile;
+  std::string Shard;
+  std::string ShardCostFile;
   std::string JUnitXMLFileName;
 };
 
@@ -150,6 +155,14 @@ public:
     bool Disabled = false;
     float Cost = 0;
     int PreviousRuns = 0;
+    // Statistics of previous runs from the test statistics database:
+    // moving average and variance of the duration in seconds, peak
+    // resident memory in bytes, and recent outcomes as 'P' or 'F'.
+    double DurationMean = 0;
+    double DurationVariance = 0;
+    int DurationSamples = 0;
+    std::uint64_t PeakMemory = 0;
+    std::string History;
     bool RunSerial = false;
     cm::optional<cmDuration> Timeout;
     cm::optional<Signal> TimeoutSignal;
@@ -193,6 +206,11 @@ public:
     std::string Output;
     std::string TestMeasurementsOutput;
     std::string InstrumentationFile;
+    // Location of Output and TestMeasurementsOutput in the output spool
+    // file, if they were moved there.
+    std::streamoff SpoolOffset = -1;
+    size_t SpoolOutputSize = 0;
+    size_t SpoolMeasurementsSize = 0;
     int TestCount = 0;
     cmCTestTestProperties* Properties = nullptr;
   };
@@ -327,6 +345,14 @@ private:
   // tests to account for fixture setup/cleanup
   void UpdateForFixtures(ListOfTests& tests) const;
 
+  // keep only the tests of the selected shard, balancing shards by the
+  // cost of each test and keeping tests that are linked by
+  // dependencies or fixtures on the same shard
+  void ShardTestList(ListOfTests& tests) const;
+
+  // read the measured test costs shared by all shards
+  bool ReadShardCostFile(std::string const& fileName);
+
   void UpdateMaxTestNameWidth();
 
   bool GetValue(char const* tag, std::string& value, std::istream& fin);
@@ -362,6 +388,16 @@ private:
   cm::optional<std::string> ParallelLevel;
   cm::optional<std::string> Repeat;
 
+  /**
+   * Keep the result of a finished test.  Its output is moved to the
+   * output spool file, if any, until the XML files are written.
+   */
+  void RecordTestResult(cmCTestTestResult result);
+  void ReadSpooledOutput(cmCTestTestResult const& result, std::string& output,
+                         std::string& measurements);
+  void OpenOutputSpool();
+  void CloseOutputSpool();
+
   void RecordCustomTestMeasurements(cmXMLWriter& xml, std::string content);
   void CheckLabelFilter(cmCTestTestProperties& it);
   void CheckLabelFilterExclude(cmCTestTestProperties& it);
@@ -377,8 +413,16 @@ private:
 
   std::ostream* LogFile = nullptr;
 
+  cmsys::fstream OutputSpool;
+  std::string OutputSpoolFile;
+  class OutputSpoolHelper;
+
   cmCTest::Repeat RepeatMode = cmCTest::Repeat::Never;
   int RepeatCount = 1;
 
+  unsigned long ShardIndex = 0;
+  unsigned long ShardCount = 0;
+  std::map<std::string, double> ShardCosts;
+
   friend class cmCTestTestCommand;
 };
@@ -63,6 +63,7 @@ protected:
                              this->Coverage.Quiet);
           std::string filename = atts[tagCount + 1];
           this->CurFileName.clear();
+          this->CurFileLines = nullptr;
 
           // Check if this is an absolute path that falls within our
           // source or binary directories.
@@ -101,10 +102,10 @@ protected:
             }
           }
           std::string line;
-          FileLinesType& curFileLines =
-            this->Coverage.TotalCoverage[this->CurFileName];
+          this->CurFileLines =
+            &this->Coverage.TotalCoverage[this->CurFileName];
           while (cmSystemTools::GetLineFromStream(fin, line)) {
-            curFileLines.push_back(-1);
+            this->CurFileLines->push_back(-1);
           }
 
           break;
@@ -126,9 +127,12 @@ protected:
         }
 
         if (curHits > -1 && curNumber > 0) {
-          FileLinesType& curFileLines =
-            this->Coverage.TotalCoverage[this->CurFileName];
-          {
+          if (!this->CurFileLines) {
+            this->CurFileLines =
+              &this->Coverage.TotalCoverage[this->CurFileName];
+          }
+          FileLinesType& curFileLines = *this->CurFileLines;
+          if (static_cast<size_t>(curNumber) <= curFileLines.size()) {
             curFileLines[curNumber - 1] = curHits;
           }
           break;
@@ -145,6 +149,7 @@ private:
   std::vector<std::string> FilePaths;
   using FileLinesType =
     cmCTestCoverageHandlerContainer::SingleFileCoverageVector;
+  FileLinesType* CurFileLines = nullptr;
   cmCTest* CTest;
   cmCTestCoverageHandlerContainer& Coverage;
   std::string CurFileName;
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 
 #include "cmsys/Directory.hxx"
 #include "cmsys/FStream.hxx"
@@ -11,13 +12,50 @@
 #include "cmCTestCoverageHandler.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmWorkerPool.h"
 #include "cmXMLParser.h"
 
+namespace {
+// Messages of a report parsed by a worker thread, kept to be logged in
+// the order of the reports.
+class LogBuffer
+{
+public:
+  void Log(cmCTest::LogType logType, std::string msg, bool suppress = false)
+  {
+    this->Messages.push_back({ logType, std::move(msg), suppress });
+  }
+
+  void Replay(cmCTest* ctest)
+  {
+    for (Message& m : this->Messages) {
+      ctest->Log(m.Type, std::move(m.Text), m.Suppress);
+    }
+    this->Messages.clear();
+  }
+
+private:
+  struct Message
+  {
+    cmCTest::LogType Type;
+    std::string Text;
+    bool Suppress;
+  };
+  std::vector<Message> Messages;
+};
+
+class EndJob : public cmWorkerPool::JobFenceT
+{
+public:
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+
 class cmParseJacocoCoverage::XMLParser : public cmXMLParser
 {
 public:
-  XMLParser(cmCTest* ctest, cmCTestCoverageHandlerContainer& cont)
-    : CTest(ctest)
+  XMLParser(LogBuffer* log, cmCTestCoverageHandlerContainer& cont)
+    : Log(log)
     , Coverage(cont)
   {
   }
@@ -34,30 +72,31 @@ protected:
       this->FilePath.clear();
       std::string fileName = atts[1];
 
+      this->CurFileLines = nullptr;
       if (this->PackagePath.empty()) {
         if (!this->FindPackagePath(fileName)) {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-                     "Cannot find file: " << this->PackageName << "/"
-                                          << fileName << std::endl);
+          this->Log->Log(cmCTest::ERROR_MESSAGE,
+                         cmStrCat("Cannot find file: ", this->PackageName,
+                                  '/', fileName, '\n'));
           this->Coverage.Error++;
           return;
         }
       }
 
-      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                         "Reading file: " << fileName << std::endl,
-                         this->Coverage.Quiet);
+      this->Log->Log(cmCTest::HANDLER_VERBOSE_OUTPUT,
+                     cmStrCat("Reading file: ", fileName, '\n'),
+                     this->Coverage.Quiet);
 
       this->FilePath = this->PackagePath + "/" + fileName;
       cmsys::ifstream fin(this->FilePath.c_str());
       if (!fin) {
-        cmCTestLog(this->CTest, ERROR_MESSAGE,
-                   "Jacoco Coverage: Error opening " << this->FilePath
-                                                     << std::endl);
+        this->Log->Log(
+          cmCTest::ERROR_MESSAGE,
+          cmStrCat("Jacoco Coverage: Error opening ", this->FilePath, '\n'));
       }
       std::string line;
-      FileLinesType& curFileLines =
-        this->Coverage.TotalCoverage[this->FilePath];
+      this->CurFileLines = &this->Coverage.TotalCoverage[this->FilePath];
+      FileLinesType& curFileLines = *this->CurFileLines;
       if (fin) {
         curFileLines.push_back(-1);
       }
@@ -75,9 +114,12 @@ protected:
           nr = atoi(atts[tagCount + 1]);
         }
         if (ci > -1 && nr > 0) {
-          FileLinesType& curFileLines =
-            this->Coverage.TotalCoverage[this->FilePath];
-          if (!curFileLines.empty()) {
+          if (!this->CurFileLines) {
+            this->CurFileLines =
+              &this->Coverage.TotalCoverage[this->FilePath];
+          }
+          FileLinesType& curFileLines = *this->CurFileLines;
+          if (static_cast<size_t>(nr) <= curFileLines.size()) {
             curFileLines[nr - 1] = ci;
           }
           break;
@@ -119,10 +161,10 @@ protected:
     for (std::string const& f : files) {
       std::string dir = cmsys::SystemTools::GetParentDirectory(f);
       if (cmHasSuffix(dir, this->PackageName)) {
-        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                           "Found package directory for " << fileName << ": "
-                                                          << dir << std::endl,
-                           this->Coverage.Quiet);
+        this->Log->Log(
+          cmCTest::HANDLER_VERBOSE_OUTPUT,
+          cmStrCat("Found package directory for ", fileName, ": ", dir, '\n'),
+          this->Coverage.Quiet);
         this->PackagePath = dir;
         return true;
       }
@@ -136,10 +178,38 @@ private:
   std::string PackageName;
   using FileLinesType =
     cmCTestCoverageHandlerContainer::SingleFileCoverageVector;
-  cmCTest* CTest;
+  FileLinesType* CurFileLines = nullptr;
+  LogBuffer* Log;
   cmCTestCoverageHandlerContainer& Coverage;
 };
 
+struct cmParseJacocoCoverage::Report
+{
+  std::string Path;
+  cmCTestCoverageHandlerContainer Coverage;
+  LogBuffer Log;
+};
+
+class cmParseJacocoCoverage::ReportJob : public cmWorkerPool::JobT
+{
+public:
+  ReportJob(size_t index)
+    : Index(index)
+  {
+  }
+
+  void Process() override
+  {
+    Report& report =
+      (*static_cast<std::vector<Report>*>(this->UserData()))[this->Index];
+    XMLParser parser(&report.Log, report.Coverage);
+    parser.ParseFile(report.Path.c_str());
+  }
+
+private:
+  size_t Index;
+};
+
 cmParseJacocoCoverage::cmParseJacocoCoverage(
   cmCTestCoverageHandlerContainer& cont, cmCTest* ctest)
   : Coverage(cont)
@@ -148,31 +218,60 @@ cmParseJacocoCoverage::cmParseJacocoCoverage(
 }
 
 bool cmParseJacocoCoverage::LoadCoverageData(
-  std::vector<std::string> const& files)
+  std::vector<std::string> const& files, unsigned int threads)
 {
-  // load all the jacoco.xml files in the source directory
-  cmsys::Directory dir;
-  size_t i;
-  std::string path;
-  size_t numf = files.size();
-  for (i = 0; i < numf; i++) {
-    path = files[i];
+  // Parse each report into a coverage container of its own, so that
+  // reports can be parsed in parallel without sharing any state.
+  std::vector<Report> reports(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    Report& report = reports[i];
+    report.Path = files[i];
+    report.Coverage.Error = 0;
+    report.Coverage.SourceDir = this->Coverage.SourceDir;
+    report.Coverage.BinaryDir = this->Coverage.BinaryDir;
+    report.Coverage.OFS = this->Coverage.OFS;
+    report.Coverage.Quiet = this->Coverage.Quiet;
+  }
+
+  cmWorkerPool pool;
+  pool.SetThreadCount(threads);
+  for (size_t i = 0; i < reports.size(); ++i) {
+    if (cmSystemTools::GetFilenameLastExtension(reports[i].Path) == ".xml") {
+      pool.EmplaceJob<ReportJob>(i);
+    }
+  }
+  pool.EmplaceJob<EndJob>();
+  pool.Process(&reports);
 
+  // Merge the reports in order, as if they had been parsed one by one.
+  for (Report& report : reports) {
     cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                       "Reading XML File " << path << std::endl,
+                       "Reading XML File " << report.Path << std::endl,
                        this->Coverage.Quiet);
-    if (cmSystemTools::GetFilenameLastExtension(path) == ".xml") {
-      if (!this->ReadJacocoXML(path.c_str())) {
-        return false;
-      }
-    }
+    report.Log.Replay(this->CTest);
+    this->MergeReport(report);
   }
   return true;
 }
 
-bool cmParseJacocoCoverage::ReadJacocoXML(char const* file)
+void cmParseJacocoCoverage::MergeReport(Report& report)
 {
-  cmParseJacocoCoverage::XMLParser parser(this->CTest, this->Coverage);
-  parser.ParseFile(file);
-  return true;
+  this->Coverage.Error += report.Coverage.Error;
+  for (auto& fc : report.Coverage.TotalCoverage) {
+    cmCTestCoverageHandlerContainer::SingleFileCoverageVector& lines =
+      this->Coverage.TotalCoverage[fc.first];
+    if (lines.empty()) {
+      lines = std::move(fc.second);
+      continue;
+    }
+    // A source file seen before has its lines appended again, but the
+    // counts go to the lines seen first.
+    size_t const n = fc.second.size();
+    lines.resize(lines.size() + n, -1);
+    for (size_t i = 0; i < n; ++i) {
+      if (fc.second[i] >= 0) {
+        lines[i] = fc.second[i];
+      }
+    }
+  }
 }
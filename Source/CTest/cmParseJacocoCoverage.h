@@ -23,7 +23,9 @@ class cmParseJacocoCoverage
 {
 public:
   cmParseJacocoCoverage(cmCTestCoverageHandlerContainer& cont, cmCTest* ctest);
-  bool LoadCoverageData(std::vector<std::string> const& files);
+  //! Load the given report files, parsing up to 'threads' at a time
+  bool LoadCoverageData(std::vector<std::string> const& files,
+                        unsigned int threads = 1);
 
   std::string PackageName;
   std::string FileName;
@@ -34,8 +36,6 @@ private:
   // implement virtual from parent
   // remove files with no coverage
   void RemoveUnCoveredFiles();
-  // Read a single mcov file
-  bool ReadJacocoXML(char const* f);
   // split a string based on ,
   bool SplitString(std::vector<std::string>& args, std::string const& line);
   bool FindJavaFile(std::string const& routine, std::string& filepath);
@@ -43,6 +43,9 @@ private:
   bool LoadSource(std::string d);
 
   class XMLParser;
+  struct Report;
+  class ReportJob;
+  void MergeReport(Report& report);
 
   std::map<std::string, std::string> RoutineToDirectory;
   cmCTestCoverageHandlerContainer& Coverage;
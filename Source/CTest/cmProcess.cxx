@@ -2,7 +2,9 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmProcess.h"
 
+#include <algorithm>
 #include <csignal>
+#include <cstdlib>
 #include <iostream>
 #include <ratio>
 #include <string>
@@ -10,6 +12,7 @@
 
 #include <cmext/algorithm>
 
+#include "cmsys/FStream.hxx"
 #include "cmsys/Process.h"
 
 #include "cmCTest.h"
@@ -20,9 +23,31 @@
 #if defined(_WIN32)
 #  include <cm3p/kwiml/int.h>
 #endif
+#if defined(__linux__)
+#  include <sys/resource.h>
+#endif
 
 #define CM_PROCESS_BUF_SIZE 65536
 
+#if defined(__linux__)
+namespace {
+// Largest peak resident memory, in KiB, of the reaped children seen by
+// the last test process to start or exit.
+long LastChildrenMaxRSS = 0;
+// Number of test processes reaped so far.
+unsigned long ReapedProcesses = 0;
+
+long ChildrenMaxRSS()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_CHILDREN, &usage) != 0) {
+    return 0;
+  }
+  return usage.ru_maxrss;
+}
+}
+#endif
+
 cmProcess::cmProcess(std::unique_ptr<cmCTestRunTest> runner)
   : Runner(std::move(runner))
   , Conv(cmProcessOutput::UTF8, CM_PROCESS_BUF_SIZE)
@@ -152,6 +177,17 @@ bool cmProcess::StartProcess(uv_loop_t& loop, std::vector<size_t>* affinity)
 
   this->StartTimer();
 
+#if defined(__linux__)
+  // Children reaped before now, such as build tools, are not this test.
+  LastChildrenMaxRSS = std::max(LastChildrenMaxRSS, ChildrenMaxRSS());
+  this->ReapedBeforeStart = ReapedProcesses;
+
+  // Sample the peak memory of the process while it runs.
+  if (this->MemoryTimer.init(loop, this) == 0) {
+    this->MemoryTimer.start(&cmProcess::OnMemoryTimerCB, 1000, 1000);
+  }
+#endif
+
   this->ProcessState = cmProcess::State::Executing;
   return true;
 }
@@ -321,6 +357,55 @@ void cmProcess::OnTimeout()
   }
 }
 
+void cmProcess::OnMemoryTimerCB(uv_timer_t* timer)
+{
+  auto* self = static_cast<cmProcess*>(timer->data);
+  self->SampleMemory();
+}
+
+void cmProcess::SampleMemory()
+{
+#if defined(__linux__)
+  // The kernel keeps the high water mark of the resident set size, so
+  // periodic samples miss only growth since the last one.
+  std::string const status =
+    cmStrCat("/proc/", this->Process->pid, "/status");
+  cmsys::ifstream fin(status.c_str());
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (cmHasLiteralPrefix(line, "VmHWM:")) {
+      std::uint64_t const kib = std::strtoull(line.c_str() + 6, nullptr, 10);
+      this->PeakMemory = std::max(this->PeakMemory, kib * 1024);
+      break;
+    }
+  }
+#endif
+}
+
+void cmProcess::SampleExitMemory()
+{
+#if defined(__linux__)
+  // The process has been reaped by libuv, so /proc no longer has its high
+  // water mark, and libuv does not report the resource usage of a single
+  // process.  The kernel keeps the peak of all reaped children, which only
+  // grows.  If no other test process was reaped while this one ran, growth
+  // of that peak is the peak of this process or of the descendants it
+  // waited for.  This covers processes too short for a sample.  Otherwise,
+  // as with parallel tests, the growth cannot be attributed, and only the
+  // samples taken while the process ran count.
+  long const maxRSS = ChildrenMaxRSS();
+  bool const alone = ReapedProcesses == this->ReapedBeforeStart;
+  ++ReapedProcesses;
+  if (maxRSS > LastChildrenMaxRSS) {
+    LastChildrenMaxRSS = maxRSS;
+    if (alone) {
+      this->PeakMemory = std::max(this->PeakMemory,
+                                  static_cast<std::uint64_t>(maxRSS) * 1024);
+    }
+  }
+#endif
+}
+
 void cmProcess::OnExitCB(uv_process_t* process, int64_t exit_status,
                          int term_signal)
 {
@@ -347,6 +432,8 @@ void cmProcess::OnExit(int64_t exit_status, int term_signal)
   // Record exit information.
   this->ExitValue = exit_status;
   this->Signal = term_signal;
+  this->MemoryTimer.reset();
+  this->SampleExitMemory();
 
   this->ProcessHandleClosed = true;
   if (this->ReadHandleClosed) {
@@ -101,6 +101,10 @@ public:
   };
   Termination GetTerminationStyle() const { return this->TerminationStyle; }
 
+  // Peak resident memory of the process observed while it ran, in bytes,
+  // or 0 if not known on this platform.
+  std::uint64_t GetPeakMemory() const { return this->PeakMemory; }
+
 private:
   cm::optional<cmDuration> Timeout;
   TimeoutReason TimeoutReason_ = TimeoutReason::Normal;
@@ -113,6 +117,10 @@ private:
   cm::uv_process_ptr Process;
   cm::uv_pipe_ptr PipeReader;
   cm::uv_timer_ptr Timer;
+  cm::uv_timer_ptr MemoryTimer;
+  std::uint64_t PeakMemory = 0;
+  // Number of test processes reaped before this one started.
+  unsigned long ReapedBeforeStart = 0;
   std::vector<char> Buf;
 
   std::unique_ptr<cmCTestRunTest> Runner;
@@ -123,6 +131,7 @@ private:
   static void OnExitCB(uv_process_t* process, int64_t exit_status,
                        int term_signal);
   static void OnTimeoutCB(uv_timer_t* timer);
+  static void OnMemoryTimerCB(uv_timer_t* timer);
   static void OnReadCB(uv_stream_t* stream, ssize_t nread,
                        uv_buf_t const* buf);
   static void OnAllocateCB(uv_handle_t* handle, size_t suggested_size,
@@ -130,6 +139,8 @@ private:
 
   void OnExit(int64_t exit_status, int term_signal);
   void OnTimeout();
+  void SampleMemory();
+  void SampleExitMemory();
   void OnRead(ssize_t nread, uv_buf_t const* buf);
   void OnAllocate(size_t suggested_size, uv_buf_t* buf);
 
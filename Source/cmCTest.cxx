@@ -2522,11 +2522,27 @@ int cmCTest::Run(std::vector<std::string> const& args)
                        this->Impl->TestOptions.ExcludeTestListFile = file;
                        return true;
                      } },
+    CommandArgument{ "--shard", CommandArgument::Values::One,
+                     [this](std::string const& shard) -> bool {
+                       this->Impl->TestOptions.Shard = shard;
+                       return true;
+                     } },
+    CommandArgument{ "--shard-cost-file", CommandArgument::Values::One,
+                     [this](std::string const& file) -> bool {
+                       this->Impl->TestOptions.ShardCostFile = file;
+                       return true;
+                     } },
     CommandArgument{ "--schedule-random", CommandArgument::Values::Zero,
                      [this](std::string const&) -> bool {
                        this->Impl->TestOptions.ScheduleRandom = true;
                        return true;
                      } },
+    CommandArgument{ "--schedule-critical-path",
+                     CommandArgument::Values::Zero,
+                     [this](std::string const&) -> bool {
+                       this->Impl->TestOptions.ScheduleCriticalPath = true;
+                       return true;
+                     } },
     CommandArgument{ "--rerun-failed", CommandArgument::Values::Zero,
                      [this](std::string const&) -> bool {
                        this->Impl->TestOptions.RerunFailed = true;
@@ -26,7 +26,6 @@
 #include "cmSystemTools.h"
 #include "cmTarget.h"
 #include "cmTargetDepend.h"
-#include "cmValue.h"
 #include "cmake.h"
 
 /*
@@ -124,6 +123,13 @@ bool cmComputeTargetDepends::Compute()
     return false;
   }
 
+  // The intermediate graph differs from the initial graph only for
+  // libraries that optimize their dependencies.  Without any, reuse the
+  // components already computed.
+  if (!this->DebugMode && !this->AnyOptimizeDependencies()) {
+    return this->ComputeFinalDepends(ccg1);
+  }
+
   // Compute the intermediate graph.
   this->CollectSideEffects();
   this->ComputeIntermediateGraph();
@@ -407,18 +413,18 @@ void cmComputeTargetDepends::CollectSideEffects()
   this->SideEffects.resize(this->InitialGraph.size());
 
   size_t n = this->InitialGraph.size();
-  std::set<size_t> visited;
+  std::vector<bool> visited(n, false);
   for (size_t i = 0; i < n; ++i) {
     this->CollectSideEffectsForTarget(visited, i);
   }
 }
 
 void cmComputeTargetDepends::CollectSideEffectsForTarget(
-  std::set<size_t>& visited, size_t depender_index)
+  std::vector<bool>& visited, size_t depender_index)
 {
-  if (!visited.count(depender_index)) {
+  if (!visited[depender_index]) {
     auto& se = this->SideEffects[depender_index];
-    visited.insert(depender_index);
+    visited[depender_index] = true;
     this->Targets[depender_index]->AppendCustomCommandSideEffects(
       se.CustomCommandSideEffects);
     this->Targets[depender_index]->AppendLanguageSideEffects(
@@ -437,6 +443,23 @@ void cmComputeTargetDepends::CollectSideEffectsForTarget(
   }
 }
 
+bool cmComputeTargetDepends::OptimizeDependencies(cmGeneratorTarget const* gt)
+{
+  return (gt->GetType() == cmStateEnums::STATIC_LIBRARY ||
+          gt->GetType() == cmStateEnums::OBJECT_LIBRARY) &&
+    gt->GetPropertyAsBool("OPTIMIZE_DEPENDENCIES");
+}
+
+bool cmComputeTargetDepends::AnyOptimizeDependencies() const
+{
+  for (cmGeneratorTarget const* gt : this->Targets) {
+    if (OptimizeDependencies(gt)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void cmComputeTargetDepends::ComputeIntermediateGraph()
 {
   this->IntermediateGraph.resize(0);
@@ -447,20 +470,10 @@ void cmComputeTargetDepends::ComputeIntermediateGraph()
     auto const& initialEdges = this->InitialGraph[i];
     auto& intermediateEdges = this->IntermediateGraph[i];
     cmGeneratorTarget const* gt = this->Targets[i];
-    if (gt->GetType() != cmStateEnums::STATIC_LIBRARY &&
-        gt->GetType() != cmStateEnums::OBJECT_LIBRARY) {
-      intermediateEdges = initialEdges;
+    if (OptimizeDependencies(gt)) {
+      this->OptimizeLinkDependencies(gt, intermediateEdges, initialEdges);
     } else {
-      if (cmValue optimizeDependencies =
-            gt->GetProperty("OPTIMIZE_DEPENDENCIES")) {
-        if (optimizeDependencies.IsOn()) {
-          this->OptimizeLinkDependencies(gt, intermediateEdges, initialEdges);
-        } else {
-          intermediateEdges = initialEdges;
-        }
-      } else {
-        intermediateEdges = initialEdges;
-      }
+      intermediateEdges = initialEdges;
     }
   }
 }
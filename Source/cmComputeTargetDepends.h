@@ -60,8 +60,10 @@ private:
                        cmListFileBacktrace const& dependee_backtrace,
                        bool linking, bool cross);
   void CollectSideEffects();
-  void CollectSideEffectsForTarget(std::set<size_t>& visited,
+  void CollectSideEffectsForTarget(std::vector<bool>& visited,
                                    size_t depender_index);
+  static bool OptimizeDependencies(cmGeneratorTarget const* gt);
+  bool AnyOptimizeDependencies() const;
   void ComputeIntermediateGraph();
   void OptimizeLinkDependencies(cmGeneratorTarget const* gt,
                                 cmGraphEdgeList& outputEdges,
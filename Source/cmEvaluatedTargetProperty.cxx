@@ -31,9 +31,25 @@ EvaluatedTargetPropertyEntry EvaluateTargetPropertyEntry(
   if (entry.GetHadContextSensitiveCondition()) {
     ee.ContextDependent = true;
   }
+  if (entry.GetHadConfigSensitiveCondition()) {
+    ee.ConfigDependent = true;
+  }
   return ee;
 }
 
+bool EvaluatedTargetPropertyEntries::IsConfigDependent() const
+{
+  if (this->HadContextSensitiveCondition) {
+    return true;
+  }
+  for (EvaluatedTargetPropertyEntry const& entry : this->Entries) {
+    if (entry.ContextDependent || entry.ConfigDependent) {
+      return true;
+    }
+  }
+  return false;
+}
+
 EvaluatedTargetPropertyEntries EvaluateTargetPropertyEntries(
   cmGeneratorTarget const* thisTarget, std::string const& config,
   std::string const& lang, cmGeneratorExpressionDAGChecker* dagChecker,
@@ -71,6 +87,7 @@ void addInterfaceEntry(cmGeneratorTarget const* headTarget,
                                                          dagChecker, usage),
                    ee.Values);
       ee.ContextDependent = context.HadContextSensitiveCondition;
+      ee.ConfigDependent = context.HadConfigSensitiveCondition;
       entries.Entries.emplace_back(std::move(ee));
     }
   }
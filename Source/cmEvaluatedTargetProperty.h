@@ -31,6 +31,7 @@ struct EvaluatedTargetPropertyEntry
   cmListFileBacktrace Backtrace;
   std::vector<std::string> Values;
   bool ContextDependent = false;
+  bool ConfigDependent = false;
 };
 
 EvaluatedTargetPropertyEntry EvaluateTargetPropertyEntry(
@@ -42,6 +43,10 @@ struct EvaluatedTargetPropertyEntries
 {
   std::vector<EvaluatedTargetPropertyEntry> Entries;
   bool HadContextSensitiveCondition = false;
+
+  // Whether evaluating the entries for another configuration could give
+  // a different result.
+  bool IsConfigDependent() const;
 };
 
 EvaluatedTargetPropertyEntries EvaluateTargetPropertyEntries(
@@ -93,7 +93,10 @@ std::string const& cmCompiledGeneratorExpression::Evaluate(
 
   if (!context.HadError) {
     this->HadContextSensitiveCondition = context.HadContextSensitiveCondition;
+    this->HadConfigSensitiveCondition = context.HadConfigSensitiveCondition;
     this->HadHeadSensitiveCondition = context.HadHeadSensitiveCondition;
+    this->HadDirectorySensitiveCondition =
+      context.HadDirectorySensitiveCondition;
     this->HadLinkLanguageSensitiveCondition =
       context.HadLinkLanguageSensitiveCondition;
     this->SourceSensitiveTargets = context.SourceSensitiveTargets;
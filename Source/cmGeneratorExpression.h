@@ -128,10 +128,18 @@ public:
   {
     return this->HadContextSensitiveCondition;
   }
+  bool GetHadConfigSensitiveCondition() const
+  {
+    return this->HadConfigSensitiveCondition;
+  }
   bool GetHadHeadSensitiveCondition() const
   {
     return this->HadHeadSensitiveCondition;
   }
+  bool GetHadDirectorySensitiveCondition() const
+  {
+    return this->HadDirectorySensitiveCondition;
+  }
   bool GetHadLinkLanguageSensitiveCondition() const
   {
     return this->HadLinkLanguageSensitiveCondition;
@@ -173,7 +181,9 @@ private:
     MaxLanguageStandard;
   mutable std::string Output;
   mutable bool HadContextSensitiveCondition = false;
+  mutable bool HadConfigSensitiveCondition = false;
   mutable bool HadHeadSensitiveCondition = false;
+  mutable bool HadDirectorySensitiveCondition = false;
   mutable bool HadLinkLanguageSensitiveCondition = false;
   mutable std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
 };
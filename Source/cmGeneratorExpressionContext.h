@@ -38,7 +38,10 @@ struct cmGeneratorExpressionContext
   bool Quiet;
   bool HadError = false;
   bool HadContextSensitiveCondition = false;
+  // Set when the result names per-configuration artifacts of a target.
+  bool HadConfigSensitiveCondition = false;
   bool HadHeadSensitiveCondition = false;
+  bool HadDirectorySensitiveCondition = false;
   bool HadLinkLanguageSensitiveCondition = false;
   bool EvaluateForBuildsystem;
 };
@@ -2,6 +2,8 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmGeneratorExpressionDAGChecker.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <utility>
 
@@ -42,18 +44,68 @@ cmGeneratorExpressionDAGChecker::cmGeneratorExpressionDAGChecker(
 
   this->CheckResult = this->CheckGraph();
 
+  auto const* top = this->Top;
   if (this->CheckResult == DAG && this->EvaluatingTransitiveProperty()) {
-    auto const* top = this->Top;
-    auto it = top->Seen.find(this->Target);
-    if (it != top->Seen.end()) {
-      std::set<std::string> const& propSet = it->second;
-      if (propSet.find(this->Property) != propSet.end()) {
-        this->CheckResult = ALREADY_SEEN;
-        return;
+    std::map<std::string, std::size_t>& propMap = top->Seen[this->Target];
+    auto it = propMap.find(this->Property);
+    if (it != propMap.end()) {
+      this->CheckResult = ALREADY_SEEN;
+      top->SkipFloor = std::min(top->SkipFloor, it->second);
+      return;
+    }
+    propMap.emplace(this->Property, top->SeenOrder.size());
+    top->SeenOrder.emplace_back(this->Target, this->Property);
+  } else if (this->CheckResult != DAG) {
+    top->SawCycle = true;
+  }
+}
+
+cmGeneratorExpressionDAGChecker::RecordingMark
+cmGeneratorExpressionDAGChecker::BeginRecording() const
+{
+  auto const* top = this->Top;
+  RecordingMark mark{ top->SeenOrder.size(), top->SkipFloor, top->SawCycle };
+  top->SkipFloor = std::numeric_limits<std::size_t>::max();
+  top->SawCycle = false;
+  return mark;
+}
+
+bool cmGeneratorExpressionDAGChecker::EndRecording(RecordingMark const& mark,
+                                                   Visits& visits) const
+{
+  auto const* top = this->Top;
+  std::size_t const floor = top->SkipFloor;
+  bool const sawCycle = top->SawCycle;
+  top->SkipFloor = std::min(mark.OuterFloor, floor);
+  top->SawCycle = mark.OuterCycle || sawCycle;
+  if (sawCycle || floor < mark.Begin) {
+    return false;
+  }
+  visits.assign(top->SeenOrder.begin() + mark.Begin, top->SeenOrder.end());
+  return true;
+}
+
+bool cmGeneratorExpressionDAGChecker::Replay(Visits const& visits) const
+{
+  auto const* top = this->Top;
+  for (auto const& visit : visits) {
+    for (auto const* checker = this; checker; checker = checker->Parent) {
+      if (checker->Target == visit.first &&
+          checker->Property == visit.second) {
+        return false;
       }
     }
-    top->Seen[this->Target].insert(this->Property);
+    auto it = top->Seen.find(visit.first);
+    if (it != top->Seen.end() &&
+        it->second.find(visit.second) != it->second.end()) {
+      return false;
+    }
+  }
+  for (auto const& visit : visits) {
+    top->Seen[visit.first].emplace(visit.second, top->SeenOrder.size());
+    top->SeenOrder.push_back(visit);
   }
+  return true;
 }
 
 cmGeneratorExpressionDAGChecker::Result
@@ -227,3 +279,8 @@ cmGeneratorTarget const* cmGeneratorExpressionDAGChecker::TopTarget() const
 {
   return this->Top->Target;
 }
+
+std::string const& cmGeneratorExpressionDAGChecker::TopProperty() const
+{
+  return this->Top->Property;
+}
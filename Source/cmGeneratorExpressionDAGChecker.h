@@ -4,9 +4,11 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <map>
-#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "cmListFileCache.h"
 
@@ -75,6 +77,33 @@ struct cmGeneratorExpressionDAGChecker
   void SetTransitivePropertiesOnlyCMP0131() { this->CMP0131 = true; }
 
   cmGeneratorTarget const* TopTarget() const;
+  std::string const& TopProperty() const;
+
+  /** Checks made under the top checker while evaluating a transitive
+      property, as pairs of target and property.  */
+  using Visits = std::vector<std::pair<cmGeneratorTarget const*, std::string>>;
+
+  struct RecordingMark
+  {
+    std::size_t Begin;
+    std::size_t OuterFloor;
+    bool OuterCycle;
+  };
+
+  /** Start recording the checks made while evaluating this checker's
+      property.  Must be paired with EndRecording.  */
+  RecordingMark BeginRecording() const;
+
+  /** Stop recording.  If no check since the mark was skipped because of
+      a check made before it, and none found a cycle or self reference,
+      store the checks in @a visits and return true.  The evaluation then
+      depended on no earlier check.  */
+  bool EndRecording(RecordingMark const& mark, Visits& visits) const;
+
+  /** Make the recorded checks as if the evaluation were repeated under
+      this checker.  Returns false, changing nothing, if one of them
+      would now be skipped as cyclic or already seen.  */
+  bool Replay(Visits const& visits) const;
 
 private:
   Result CheckGraph() const;
@@ -83,7 +112,17 @@ private:
   cmGeneratorExpressionDAGChecker const* const Top;
   cmGeneratorTarget const* Target;
   std::string const Property;
-  mutable std::map<cmGeneratorTarget const*, std::set<std::string>> Seen;
+  // Transitive property checks made under this top checker, in order.
+  // Seen maps each check to its position in SeenOrder.
+  mutable std::map<cmGeneratorTarget const*,
+                   std::map<std::string, std::size_t>>
+    Seen;
+  mutable Visits SeenOrder;
+  // Position of the earliest check that caused a later one to be skipped
+  // since recording began.
+  mutable std::size_t SkipFloor = 0;
+  // Whether a check found a cycle or self reference since recording began.
+  mutable bool SawCycle = false;
   GeneratorExpressionContent const* const Content;
   cmListFileBacktrace const Backtrace;
   Result CheckResult;
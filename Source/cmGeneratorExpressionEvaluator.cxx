@@ -92,6 +92,10 @@ std::string GeneratorExpressionContent::Evaluate(
     return std::string();
   }
 
+  if (node->IsDirectorySensitive()) {
+    context->HadDirectorySensitiveCondition = true;
+  }
+
   if (!node->GeneratesContent()) {
     if (node->NumExpectedParameters() == 1 &&
         node->AcceptsArbitraryContentParameter()) {
@@ -67,9 +67,15 @@ std::string cmGeneratorExpressionNode::EvaluateDependentExpression(
   if (cge->GetHadContextSensitiveCondition()) {
     context->HadContextSensitiveCondition = true;
   }
+  if (cge->GetHadConfigSensitiveCondition()) {
+    context->HadConfigSensitiveCondition = true;
+  }
   if (cge->GetHadHeadSensitiveCondition()) {
     context->HadHeadSensitiveCondition = true;
   }
+  if (cge->GetHadDirectorySensitiveCondition()) {
+    context->HadDirectorySensitiveCondition = true;
+  }
   if (cge->GetHadLinkLanguageSensitiveCondition()) {
     context->HadLinkLanguageSensitiveCondition = true;
   }
@@ -300,6 +306,8 @@ static const struct InListNode : public cmGeneratorExpressionNode
 {
   InListNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -410,6 +418,8 @@ static const struct TargetExistsNode : public cmGeneratorExpressionNode
 {
   TargetExistsNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -441,6 +451,8 @@ static const struct TargetNameIfExistsNode : public cmGeneratorExpressionNode
 {
   TargetNameIfExistsNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -475,6 +487,8 @@ struct GenexEvaluator : public cmGeneratorExpressionNode
 {
   GenexEvaluator() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
 protected:
   std::string EvaluateExpression(
     std::string const& genexOperator, std::string const& expression,
@@ -556,8 +570,14 @@ static const struct TargetGenexEvalNode : public GenexEvaluator
       context->LG, context->Config, context->Quiet, target, target,
       context->EvaluateForBuildsystem, context->Backtrace, context->Language);
 
-    return this->EvaluateExpression("TARGET_GENEX_EVAL", expression,
-                                    &targetContext, content, dagCheckerParent);
+    std::string result =
+      this->EvaluateExpression("TARGET_GENEX_EVAL", expression,
+                               &targetContext, content, dagCheckerParent);
+    if (targetContext.HadContextSensitiveCondition ||
+        targetContext.HadConfigSensitiveCondition) {
+      context->HadConfigSensitiveCondition = true;
+    }
+    return result;
   }
 } targetGenexEvalNode;
 
@@ -1894,6 +1914,8 @@ static CharacterNode<'"'> const quoteNode;
 
 struct CompilerIdNode : public cmGeneratorExpressionNode
 {
+  bool IsDirectorySensitive() const override { return true; }
+
   CompilerIdNode(char const* compilerLang)
     : CompilerLanguage(compilerLang)
   {
@@ -1960,6 +1982,8 @@ static CompilerIdNode const cCompilerIdNode("C"), cxxCompilerIdNode("CXX"),
 
 struct CompilerVersionNode : public cmGeneratorExpressionNode
 {
+  bool IsDirectorySensitive() const override { return true; }
+
   CompilerVersionNode(char const* compilerLang)
     : CompilerLanguage(compilerLang)
   {
@@ -2025,6 +2049,8 @@ static CompilerVersionNode const cCompilerVersionNode("C"),
 
 struct CompilerFrontendVariantNode : public cmGeneratorExpressionNode
 {
+  bool IsDirectorySensitive() const override { return true; }
+
   CompilerFrontendVariantNode(char const* compilerLang)
     : CompilerLanguage(compilerLang)
   {
@@ -2097,6 +2123,8 @@ struct PlatformIdNode : public cmGeneratorExpressionNode
 {
   PlatformIdNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -2416,6 +2444,8 @@ static const struct LinkLanguageNode : public cmGeneratorExpressionNode
 {
   LinkLanguageNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -2817,6 +2847,8 @@ static const struct TargetPropertyNode : public cmGeneratorExpressionNode
 {
   TargetPropertyNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   // This node handles errors on parameter count itself.
   int NumExpectedParameters() const override { return OneOrMoreParameters; }
 
@@ -2950,6 +2982,9 @@ static const struct TargetPropertyNode : public cmGeneratorExpressionNode
           "link libraries for a static library");
         return std::string();
       }
+      // The linker language follows the languages of the libraries linked
+      // in the configuration.
+      context->HadConfigSensitiveCondition = true;
       return target->GetLinkerLanguage(context->Config);
     }
 
@@ -3121,6 +3156,8 @@ static const struct TargetObjectsNode : public cmGeneratorExpressionNode
 {
   TargetObjectsNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   std::string Evaluate(
     std::vector<std::string> const& parameters,
     cmGeneratorExpressionContext* context,
@@ -3207,6 +3244,8 @@ static const struct TargetObjectsNode : public cmGeneratorExpressionNode
 
 struct TargetRuntimeDllsBaseNode : public cmGeneratorExpressionNode
 {
+  bool IsDirectorySensitive() const override { return true; }
+
   std::vector<std::string> CollectDlls(
     std::vector<std::string> const& parameters,
     cmGeneratorExpressionContext* context,
@@ -3221,6 +3260,7 @@ struct TargetRuntimeDllsBaseNode : public cmGeneratorExpressionNode
       reportError(context, content->GetOriginalExpression(), e.str());
       return std::vector<std::string>();
     }
+    context->HadConfigSensitiveCondition = true;
     cmStateEnums::TargetType type = gt->GetType();
     if (type != cmStateEnums::EXECUTABLE &&
         type != cmStateEnums::SHARED_LIBRARY &&
@@ -3292,6 +3332,8 @@ static const struct CompileFeaturesNode : public cmGeneratorExpressionNode
 {
   CompileFeaturesNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   int NumExpectedParameters() const override { return OneOrMoreParameters; }
 
   std::string Evaluate(
@@ -3910,6 +3952,8 @@ struct TargetArtifactBase : public cmGeneratorExpressionNode
 {
   TargetArtifactBase() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
 protected:
   cmGeneratorTarget* GetTarget(
     std::vector<std::string> const& parameters,
@@ -3948,6 +3992,8 @@ protected:
       return nullptr;
     }
 
+    // Artifact names and locations may differ between configurations.
+    context->HadConfigSensitiveCondition = true;
     return target;
   }
 };
@@ -4483,6 +4529,8 @@ static const struct ShellPathNode : public cmGeneratorExpressionNode
 {
   ShellPathNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsDirectorySensitive() const override { return true; }
+
   std::string Evaluate(
     std::vector<std::string> const& parameters,
     cmGeneratorExpressionContext* context,
@@ -31,6 +31,10 @@ struct cmGeneratorExpressionNode
 
   virtual bool AcceptsArbitraryContentParameter() const { return false; }
 
+  // Whether the result may depend on the directory of the evaluation,
+  // e.g. through its variables, policies, or the targets visible in it.
+  virtual bool IsDirectorySensitive() const { return false; }
+
   virtual int NumExpectedParameters() const { return 1; }
 
   virtual bool ShouldEvaluateNextParameter(std::vector<std::string> const&,
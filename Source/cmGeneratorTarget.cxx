@@ -545,6 +545,8 @@ void cmGeneratorTarget::ClearSourcesCache()
   this->PrecompileHeadersCache.clear();
   this->LinkOptionsCache.clear();
   this->LinkDirectoriesCache.clear();
+  this->ConfigInvariantCache.clear();
+  this->InterfacePropertyCache.clear();
   this->RuntimeBinaryFullNameCache.clear();
   this->ImportLibraryFullNameCache.clear();
 }
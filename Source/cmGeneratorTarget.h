@@ -276,6 +276,12 @@ public:
     std::string const& config, cmGeneratorTarget const* headTarget,
     UseTo usage) const;
 
+  /** Return whether the given link interface libraries of this target,
+      computed for the given configuration, may name different
+      dependencies in other configurations.  */
+  bool IsLinkInterfaceConfigDependent(
+    std::string const& config, cmLinkInterfaceLibraries const& iface) const;
+
   void ComputeLinkInterfaceLibraries(std::string const& config,
                                      cmOptionalLinkInterface& iface,
                                      cmGeneratorTarget const* head,
@@ -635,6 +641,14 @@ private:
   mutable ConfigAndLanguageToBTStrings LinkOptionsCache;
   mutable ConfigAndLanguageToBTStrings LinkDirectoriesCache;
 
+  // Evaluations found not to depend on the configuration, keyed by
+  // property name and language and shared by all configurations.
+  using PropertyAndLanguage = std::pair<std::string, std::string>;
+  mutable std::map<PropertyAndLanguage, std::vector<BT<std::string>>>
+    ConfigInvariantCache;
+  std::vector<BT<std::string>> const* FindConfigInvariant(
+    std::string const& prop, std::string const& lang) const;
+
 public:
   /** Get the include directories for this target.  */
   std::vector<BT<std::string>> GetIncludeDirectories(
@@ -1217,6 +1231,7 @@ private:
   struct LinkImplClosure : public std::vector<cmGeneratorTarget const*>
   {
     bool Done = false;
+    bool ConfigDependent = false;
   };
   mutable std::map<std::string, LinkImplClosure> LinkImplClosureForLinkMap;
   mutable std::map<std::string, LinkImplClosure> LinkImplClosureForUsageMap;
@@ -1298,6 +1313,32 @@ private:
                                   cmGeneratorExpressionContext* context,
                                   UseTo usage) const;
 
+  // Transitive interface property values whose evaluation did not depend
+  // on the head target, shared by all heads evaluating them.  LG is set
+  // only for values that depended on the directory of the evaluation.
+  struct InterfacePropertyKey
+  {
+    std::string Property;
+    std::string Config;
+    std::string Language;
+    std::string TopProperty;
+    cmLocalGenerator const* LG;
+    bool EvaluateForBuildsystem;
+    bool TransitivePropertiesOnly;
+    bool TransitivePropertiesOnlyCMP0131;
+    bool ComputingLinkLibraries;
+    bool operator<(InterfacePropertyKey const& other) const;
+  };
+  struct InterfacePropertyValue
+  {
+    std::string Value;
+    bool ContextDependent = false;
+    bool ConfigDependent = false;
+    std::vector<std::pair<cmGeneratorTarget const*, std::string>> Visits;
+  };
+  mutable std::map<InterfacePropertyKey, InterfacePropertyValue>
+    InterfacePropertyCache;
+
   using TargetPropertyEntryVector =
     std::vector<std::unique_ptr<TargetPropertyEntry>>;
 
@@ -1542,6 +1583,7 @@ public:
   virtual cmListFileBacktrace GetBacktrace() const = 0;
   virtual std::string const& GetInput() const = 0;
   virtual bool GetHadContextSensitiveCondition() const;
+  virtual bool GetHadConfigSensitiveCondition() const;
 
   cmLinkImplItem const& LinkImplItem;
 };
@@ -229,6 +229,10 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
       return it->second;
     }
   }
+  if (auto const* shared =
+        this->FindConfigInvariant("INCLUDE_DIRECTORIES", lang)) {
+    return *shared;
+  }
   std::vector<BT<std::string>> includes;
   std::unordered_set<std::string> uniqueIncludes;
 
@@ -247,6 +251,10 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
   EvaluatedTargetPropertyEntries entries = EvaluateTargetPropertyEntries(
     this, config, lang, &dagChecker, this->IncludeDirectoriesEntries);
 
+  // Implicit language-specific and framework directories are named by
+  // per-config locations.
+  bool configDependent = lang == "Swift" || this->IsApple();
+
   if (lang == "Swift") {
     AddLangSpecificImplicitIncludeDirectories(
       this, lang, config, "Swift_MODULE_DIRECTORY",
@@ -260,6 +268,7 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
     // If this target has ISPC sources make sure to add the header
     // directory to other compilation units
     if (cm::contains(this->GetAllConfigCompileLanguages(), "ISPC")) {
+      configDependent = true;
       if (cmValue val = this->GetProperty(propertyName)) {
         includes.emplace_back(*val);
       } else {
@@ -275,6 +284,8 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
   AddInterfaceEntries(this, config, "INTERFACE_INCLUDE_DIRECTORIES", lang,
                       &dagChecker, entries, IncludeRuntimeInterface::Yes);
 
+  configDependent = configDependent || entries.IsConfigDependent();
+
   processIncludeDirectories(this, entries, includes, uniqueIncludes,
                             debugIncludes);
 
@@ -307,6 +318,11 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
     }
   }
 
-  this->IncludeDirectoriesCache.emplace(cacheKey, includes);
+  if (configDependent) {
+    this->IncludeDirectoriesCache.emplace(cacheKey, includes);
+  } else {
+    this->ConfigInvariantCache.emplace(
+      PropertyAndLanguage("INCLUDE_DIRECTORIES", lang), includes);
+  }
   return includes;
 }
@@ -284,14 +284,19 @@ static void processILibs(std::string const& config,
                          cmLinkItem const& item, cmGlobalGenerator* gg,
                          std::vector<cmGeneratorTarget const*>& tgts,
                          std::set<cmGeneratorTarget const*>& emitted,
-                         UseTo usage)
+                         UseTo usage, bool* configDependent = nullptr)
 {
   if (item.Target && emitted.insert(item.Target).second) {
     tgts.push_back(item.Target);
     if (cmLinkInterfaceLibraries const* iface =
           item.Target->GetLinkInterfaceLibraries(config, headTarget, usage)) {
+      if (configDependent &&
+          item.Target->IsLinkInterfaceConfigDependent(config, *iface)) {
+        *configDependent = true;
+      }
       for (cmLinkItem const& lib : iface->Libraries) {
-        processILibs(config, headTarget, lib, gg, tgts, emitted, usage);
+        processILibs(config, headTarget, lib, gg, tgts, emitted, usage,
+                     configDependent);
       }
     }
   }
@@ -324,9 +329,21 @@ cmGeneratorTarget::GetLinkImplementationClosure(std::string const& config,
     return empty;
   }
 
-  LinkImplClosure& tgts =
-    (usage == UseTo::Compile ? this->LinkImplClosureForUsageMap[config]
-                             : this->LinkImplClosureForLinkMap[config]);
+  std::map<std::string, LinkImplClosure>& closures =
+    (usage == UseTo::Compile ? this->LinkImplClosureForUsageMap
+                             : this->LinkImplClosureForLinkMap);
+
+  // Share a closure computed for another configuration if it does not
+  // depend on the configuration.  Link interface closures and the link
+  // interface libraries they are built from are still computed per
+  // configuration and head target.
+  for (auto const& c : closures) {
+    if (c.second.Done && !c.second.ConfigDependent) {
+      return c.second;
+    }
+  }
+
+  LinkImplClosure& tgts = closures[config];
   if (!tgts.Done) {
     tgts.Done = true;
     std::set<cmGeneratorTarget const*> emitted;
@@ -335,10 +352,11 @@ cmGeneratorTarget::GetLinkImplementationClosure(std::string const& config,
       this->GetLinkImplementationLibraries(config, usage);
     assert(impl);
 
+    tgts.ConfigDependent = impl->HadContextSensitiveCondition;
     for (cmLinkImplItem const& lib : impl->Libraries) {
       processILibs(config, this, lib,
                    this->LocalGenerator->GetGlobalGenerator(), tgts, emitted,
-                   usage);
+                   usage, &tgts.ConfigDependent);
     }
   }
   return tgts;
@@ -771,6 +789,23 @@ cmLinkInterfaceLibraries const* cmGeneratorTarget::GetLinkInterfaceLibraries(
   return iface.Exists ? &iface : nullptr;
 }
 
+bool cmGeneratorTarget::IsLinkInterfaceConfigDependent(
+  std::string const& config, cmLinkInterfaceLibraries const& iface) const
+{
+  if (iface.HadContextSensitiveCondition) {
+    return true;
+  }
+  // An imported target may name its link interface in a property
+  // specific to the configuration.
+  if (this->IsImported()) {
+    if (ImportInfo const* info = this->GetImportInfo(config)) {
+      return cmHasLiteralPrefix(info->LibrariesProp,
+                                "IMPORTED_LINK_INTERFACE_LIBRARIES_");
+    }
+  }
+  return false;
+}
+
 void cmGeneratorTarget::ComputeLinkInterfaceLibraries(
   std::string const& config, cmOptionalLinkInterface& iface,
   cmGeneratorTarget const* headTarget, UseTo usage) const
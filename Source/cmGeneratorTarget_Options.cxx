@@ -217,6 +217,16 @@ void cmGeneratorTarget::GetCompileOptions(std::vector<std::string>& result,
   }
 }
 
+std::vector<BT<std::string>> const* cmGeneratorTarget::FindConfigInvariant(
+  std::string const& prop, std::string const& lang) const
+{
+  auto it = this->ConfigInvariantCache.find(PropertyAndLanguage(prop, lang));
+  if (it != this->ConfigInvariantCache.end()) {
+    return &it->second;
+  }
+  return nullptr;
+}
+
 std::vector<BT<std::string>> cmGeneratorTarget::GetCompileOptions(
   std::string const& config, std::string const& language) const
 {
@@ -227,6 +237,10 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetCompileOptions(
       return it->second;
     }
   }
+  if (auto const* shared =
+        this->FindConfigInvariant("COMPILE_OPTIONS", language)) {
+    return *shared;
+  }
   std::vector<BT<std::string>> result;
   std::unordered_set<std::string> uniqueOptions;
 
@@ -247,10 +261,17 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetCompileOptions(
   AddInterfaceEntries(this, config, "INTERFACE_COMPILE_OPTIONS", language,
                       &dagChecker, entries, IncludeRuntimeInterface::Yes);
 
+  bool const configDependent = entries.IsConfigDependent();
+
   processOptions(this, entries, result, uniqueOptions, debugOptions,
                  "compile options", OptionsParse::Shell);
 
-  CompileOptionsCache.emplace(cacheKey, result);
+  if (configDependent) {
+    CompileOptionsCache.emplace(cacheKey, result);
+  } else {
+    this->ConfigInvariantCache.emplace(
+      PropertyAndLanguage("COMPILE_OPTIONS", language), result);
+  }
   return result;
 }
 
@@ -316,6 +337,10 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetCompileDefinitions(
       return it->second;
     }
   }
+  if (auto const* shared =
+        this->FindConfigInvariant("COMPILE_DEFINITIONS", language)) {
+    return *shared;
+  }
   std::vector<BT<std::string>> list;
   std::unordered_set<std::string> uniqueOptions;
 
@@ -337,10 +362,17 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetCompileDefinitions(
   AddInterfaceEntries(this, config, "INTERFACE_COMPILE_DEFINITIONS", language,
                       &dagChecker, entries, IncludeRuntimeInterface::Yes);
 
+  bool const configDependent = entries.IsConfigDependent();
+
   processOptions(this, entries, list, uniqueOptions, debugDefines,
                  "compile definitions", OptionsParse::None);
 
-  this->CompileDefinitionsCache.emplace(cacheKey, list);
+  if (configDependent) {
+    this->CompileDefinitionsCache.emplace(cacheKey, list);
+  } else {
+    this->ConfigInvariantCache.emplace(
+      PropertyAndLanguage("COMPILE_DEFINITIONS", language), list);
+  }
   return list;
 }
 
@@ -410,6 +442,10 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetLinkOptions(
       return it->second;
     }
   }
+  if (auto const* shared =
+        this->FindConfigInvariant("LINK_OPTIONS", cacheKey.second)) {
+    return *shared;
+  }
   std::vector<BT<std::string>> result;
   std::unordered_set<std::string> uniqueOptions;
 
@@ -433,6 +469,8 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetLinkOptions(
                         ? UseTo::Link
                         : UseTo::Compile);
 
+  bool const configDependent = entries.IsConfigDependent();
+
   processOptions(this, entries, result, uniqueOptions, debugOptions,
                  "link options", OptionsParse::Shell, this->IsDeviceLink());
 
@@ -487,7 +525,12 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetLinkOptions(
   // actual linker wrapper
   result = this->ResolveLinkerWrapper(result, language);
 
-  this->LinkOptionsCache.emplace(cacheKey, result);
+  if (configDependent) {
+    this->LinkOptionsCache.emplace(cacheKey, result);
+  } else {
+    this->ConfigInvariantCache.emplace(
+      PropertyAndLanguage("LINK_OPTIONS", cacheKey.second), result);
+  }
   return result;
 }
 
@@ -85,6 +85,11 @@ public:
     return this->ge->GetHadContextSensitiveCondition();
   }
 
+  bool GetHadConfigSensitiveCondition() const override
+  {
+    return this->ge->GetHadConfigSensitiveCondition();
+  }
+
 private:
   std::unique_ptr<cmCompiledGeneratorExpression> const ge;
 };
@@ -141,6 +146,11 @@ public:
       this->EntryCge->GetHadContextSensitiveCondition();
   }
 
+  bool GetHadConfigSensitiveCondition() const override
+  {
+    return this->EntryCge->GetHadConfigSensitiveCondition();
+  }
+
 private:
   std::vector<std::string> const BaseDirs;
   bool const ContextSensitiveDirs;
@@ -187,3 +197,9 @@ bool cmGeneratorTarget::TargetPropertyEntry::GetHadContextSensitiveCondition()
 {
   return false;
 }
+
+bool cmGeneratorTarget::TargetPropertyEntry::GetHadConfigSensitiveCondition()
+  const
+{
+  return false;
+}
@@ -4,8 +4,10 @@
 #include "cmGeneratorTarget.h"
 /* clang-format on */
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -136,6 +138,64 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
   cmGeneratorTarget const* headTarget =
     context->HeadTarget ? context->HeadTarget : this;
 
+  // Reuse an evaluation made for another head target if it did not depend
+  // on the head and replaying its checks skips nothing that it included.
+  // Link usage is excluded because $<HOST_LINK> and $<DEVICE_LINK> depend
+  // on the head without reporting it.
+  bool const reusable = usage == UseTo::Compile &&
+    dagChecker.EvaluatingTransitiveProperty() &&
+    !dagChecker.EvaluatingSources() && !dagChecker.EvaluatingLinkLibraries();
+  // Values that did not depend on the directory of the evaluation are
+  // stored without it and shared by all directories.
+  InterfacePropertyKey key;
+  if (reusable) {
+    key = { prop,
+            context->Config,
+            context->Language,
+            dagChecker.TopProperty(),
+            nullptr,
+            context->EvaluateForBuildsystem,
+            dagChecker.GetTransitivePropertiesOnly(),
+            dagChecker.GetTransitivePropertiesOnlyCMP0131(),
+            dagChecker.IsComputingLinkLibraries() };
+    auto i = this->InterfacePropertyCache.find(key);
+    if (i == this->InterfacePropertyCache.end()) {
+      key.LG = context->LG;
+      i = this->InterfacePropertyCache.find(key);
+    }
+    if (i != this->InterfacePropertyCache.end() &&
+        dagChecker.Replay(i->second.Visits)) {
+      context->HadContextSensitiveCondition =
+        context->HadContextSensitiveCondition || i->second.ContextDependent;
+      context->HadConfigSensitiveCondition =
+        context->HadConfigSensitiveCondition || i->second.ConfigDependent;
+      context->HadDirectorySensitiveCondition =
+        context->HadDirectorySensitiveCondition || key.LG != nullptr;
+      return i->second.Value;
+    }
+  }
+
+  // Evaluate with clear condition flags to learn what this evaluation
+  // alone depends on, and merge them into the caller's flags at the end.
+  bool const hadContextSensitiveCondition =
+    context->HadContextSensitiveCondition;
+  bool const hadConfigSensitiveCondition =
+    context->HadConfigSensitiveCondition;
+  bool const hadHeadSensitiveCondition = context->HadHeadSensitiveCondition;
+  bool const hadDirectorySensitiveCondition =
+    context->HadDirectorySensitiveCondition;
+  bool const hadError = context->HadError;
+  context->HadContextSensitiveCondition = false;
+  context->HadConfigSensitiveCondition = false;
+  context->HadHeadSensitiveCondition = false;
+  context->HadDirectorySensitiveCondition = false;
+  context->HadError = false;
+  bool ifaceHeadSensitive = false;
+  cmGeneratorExpressionDAGChecker::RecordingMark mark{ 0, 0, false };
+  if (reusable) {
+    mark = dagChecker.BeginRecording();
+  }
+
   if (cmValue p = this->GetProperty(prop)) {
     result = cmGeneratorExpressionNode::EvaluateDependentExpression(
       *p, context->LG, context, headTarget, &dagChecker, this);
@@ -143,9 +203,13 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
 
   if (cmLinkInterfaceLibraries const* iface =
         this->GetLinkInterfaceLibraries(context->Config, headTarget, usage)) {
+    ifaceHeadSensitive = iface->HadHeadSensitiveCondition;
     context->HadContextSensitiveCondition =
       context->HadContextSensitiveCondition ||
       iface->HadContextSensitiveCondition;
+    context->HadConfigSensitiveCondition =
+      context->HadConfigSensitiveCondition ||
+      this->IsLinkInterfaceConfigDependent(context->Config, *iface);
     for (cmLinkItem const& lib : iface->Libraries) {
       // Broken code can have a target in its own link interface.
       // Don't follow such link interface entries so as not to create a
@@ -173,16 +237,67 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
         context->HadContextSensitiveCondition =
           context->HadContextSensitiveCondition ||
           libContext.HadContextSensitiveCondition;
+        context->HadConfigSensitiveCondition =
+          context->HadConfigSensitiveCondition ||
+          libContext.HadConfigSensitiveCondition;
         context->HadHeadSensitiveCondition =
           context->HadHeadSensitiveCondition ||
           libContext.HadHeadSensitiveCondition;
+        context->HadDirectorySensitiveCondition =
+          context->HadDirectorySensitiveCondition ||
+          libContext.HadDirectorySensitiveCondition;
       }
     }
   }
 
+  if (reusable) {
+    cmGeneratorExpressionDAGChecker::Visits visits;
+    bool const recorded = dagChecker.EndRecording(mark, visits);
+    using Visit = cmGeneratorExpressionDAGChecker::Visits::value_type;
+    if (recorded && !context->HadHeadSensitiveCondition &&
+        !context->HadError && !ifaceHeadSensitive &&
+        std::none_of(visits.begin(), visits.end(),
+                     [headTarget](Visit const& visit) {
+                       return visit.first == headTarget;
+                     })) {
+      key.LG =
+        context->HadDirectorySensitiveCondition ? context->LG : nullptr;
+      InterfacePropertyValue& value = this->InterfacePropertyCache[key];
+      value.Value = result;
+      value.ContextDependent = context->HadContextSensitiveCondition;
+      value.ConfigDependent = context->HadConfigSensitiveCondition;
+      value.Visits = std::move(visits);
+    }
+  }
+
+  context->HadContextSensitiveCondition =
+    context->HadContextSensitiveCondition || hadContextSensitiveCondition;
+  context->HadConfigSensitiveCondition =
+    context->HadConfigSensitiveCondition || hadConfigSensitiveCondition;
+  context->HadHeadSensitiveCondition =
+    context->HadHeadSensitiveCondition || hadHeadSensitiveCondition;
+  context->HadDirectorySensitiveCondition =
+    context->HadDirectorySensitiveCondition || hadDirectorySensitiveCondition;
+  context->HadError = context->HadError || hadError;
+
   return result;
 }
 
+bool cmGeneratorTarget::InterfacePropertyKey::operator<(
+  InterfacePropertyKey const& other) const
+{
+  return std::tie(this->Property, this->Config, this->Language,
+                  this->TopProperty, this->LG, this->EvaluateForBuildsystem,
+                  this->TransitivePropertiesOnly,
+                  this->TransitivePropertiesOnlyCMP0131,
+                  this->ComputingLinkLibraries) <
+    std::tie(other.Property, other.Config, other.Language, other.TopProperty,
+             other.LG, other.EvaluateForBuildsystem,
+             other.TransitivePropertiesOnly,
+             other.TransitivePropertiesOnlyCMP0131,
+             other.ComputingLinkLibraries);
+}
+
 cm::optional<cmGeneratorTarget::TransitiveProperty>
 cmGeneratorTarget::IsTransitiveProperty(
   cm::string_view prop, cmLocalGenerator const* lg, std::string const& config,
@@ -1713,6 +1713,10 @@ void cmGlobalGenerator::WriteInstallJson() const
 
 bool cmGlobalGenerator::ComputeTargetDepends()
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  auto profilingRAII = this->GetCMakeInstance()->CreateProfilingEntry(
+    "project", "compute_target_depends");
+#endif
   cmComputeTargetDepends ctd(this);
   if (!ctd.Compute()) {
     return false;
@@ -1989,6 +1993,7 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   this->DirectoryContentMap.clear();
   this->BinaryDirectories.clear();
   this->GeneratedFiles.clear();
+  this->PathTable.Clear();
   this->RuntimeDependencySets.clear();
   this->RuntimeDependencySetsByName.clear();
 }
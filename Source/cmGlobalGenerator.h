@@ -24,6 +24,7 @@
 #include "cmDuration.h"
 #include "cmExportSet.h"
 #include "cmLocalGenerator.h"
+#include "cmPathTable.h"
 #include "cmStateSnapshot.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
@@ -290,6 +291,9 @@ public:
   //! Get the CMake instance
   cmake* GetCMakeInstance() const { return this->CMakeInstance; }
 
+  //! Get the table of paths converted during generation
+  cmPathTable& GetPathTable() const { return this->PathTable; }
+
   void SetConfiguredFilesPath(cmGlobalGenerator* gen);
   std::vector<std::unique_ptr<cmMakefile>> const& GetMakefiles() const
   {
@@ -913,6 +917,8 @@ private:
 
   std::unordered_set<std::string> GeneratedFiles;
 
+  mutable cmPathTable PathTable;
+
   std::vector<std::unique_ptr<cmInstallRuntimeDependencySet>>
     RuntimeDependencySets;
   std::map<std::string, cmInstallRuntimeDependencySet*>
@@ -42,6 +42,7 @@
 #include "cmMessageType.h"
 #include "cmNinjaLinkLineComputer.h"
 #include "cmOutputConverter.h"
+#include "cmPathTable.h"
 #include "cmRange.h"
 #include "cmScanDepFormat.h"
 #include "cmSourceFile.h"
@@ -331,6 +332,31 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
   os << buildStr << arguments << assignments << "\n";
 }
 
+void cmGlobalNinjaGenerator::PoolCompileVariables(std::ostream& os,
+                                                  cmNinjaVars& vars)
+{
+  // Ninja evaluates build statement bindings when parsing them, so a
+  // reference to a file scope variable binds the value it has right here.
+  auto& pool = this->PooledVariables[&os];
+  for (char const* name : { "FLAGS", "DEFINES", "INCLUDES" }) {
+    auto it = vars.find(name);
+    if (it == vars.end()) {
+      continue;
+    }
+    std::string value = cmTrimWhitespace(it->second);
+    if (value.empty()) {
+      continue;
+    }
+    auto inserted = pool.emplace(cmStrCat(name, '=', value), std::string());
+    std::string& pooledName = inserted.first->second;
+    if (inserted.second) {
+      pooledName = cmStrCat(name, '_', pool.size());
+      cmGlobalNinjaGenerator::WriteVariable(os, pooledName, value);
+    }
+    it->second = cmStrCat('$', pooledName);
+  }
+}
+
 void cmGlobalNinjaGenerator::AddCustomCommandRule()
 {
   cmNinjaRule rule("CUSTOM_COMMAND");
@@ -609,6 +635,12 @@ void cmGlobalNinjaGenerator::Generate()
     return;
   }
   this->InitOutputPathPrefix();
+  this->SubninjaPerDirectory =
+    this->LocalGenerators[0]->GetMakefile()->IsOn(
+      "CMAKE_NINJA_SUBNINJA_PER_DIRECTORY");
+  this->DyndepBatched =
+    this->LocalGenerators[0]->GetMakefile()->IsOn("CMAKE_NINJA_BATCH_DYNDEP");
+  this->DyndepBatches.clear();
   if (!this->OpenBuildFileStreams()) {
     return;
   }
@@ -623,11 +655,13 @@ void cmGlobalNinjaGenerator::Generate()
   this->TargetAll = this->NinjaOutputPath("all");
   this->CMakeCacheFile = this->NinjaOutputPath("CMakeCache.txt");
   this->DiagnosedCxxModuleNinjaSupport = false;
+  this->PooledVariables.clear();
   this->ClangTidyExportFixesDirs.clear();
   this->ClangTidyExportFixesFiles.clear();
 
   this->cmGlobalGenerator::Generate();
 
+  this->WriteDyndepBatches();
   this->WriteAssumedSourceDependencies();
   this->WriteTargetAliases(*this->GetCommonFileStream());
   this->WriteFolderTargets(*this->GetCommonFileStream());
@@ -1094,6 +1128,57 @@ bool cmGlobalNinjaGenerator::OpenFileStream(
   return true;
 }
 
+bool cmGlobalNinjaGenerator::OpenDirectoryFileStream(
+  std::unique_ptr<cmGeneratedFileStream>& stream, std::ostream& parent,
+  std::string const& name)
+{
+  if (!this->OpenFileStream(stream, name)) {
+    return false;
+  }
+  // Keep the file untouched if its content did not change.
+  stream->SetCopyIfDifferent(true);
+  *stream << "# This file contains the build statements of one directory.\n"
+          << "# It is included by a 'subninja' statement.\n\n";
+
+  parent << "subninja " << this->EncodePath(this->NinjaOutputPath(name))
+         << "\n";
+  return true;
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryFileStream(
+  std::unique_ptr<cmGeneratedFileStream>& stream)
+{
+  if (!stream) {
+    return;
+  }
+  if (cmSystemTools::GetErrorOccurredFlag()) {
+    stream->setstate(std::ios::failbit);
+  }
+  // The variables of a subninja file are not visible outside of it.
+  this->PooledVariables.erase(stream.get());
+  stream.reset();
+}
+
+bool cmGlobalNinjaGenerator::OpenDirectoryFileStreams(
+  std::string const& homeRelativeDir)
+{
+  // Directories outside of the build tree stay in the main build file.
+  if (!this->SubninjaPerDirectory ||
+      cmSystemTools::FileIsFullPath(homeRelativeDir)) {
+    return true;
+  }
+  std::string const dir =
+    homeRelativeDir.empty() ? std::string() : cmStrCat(homeRelativeDir, '/');
+  return this->OpenDirectoryFileStream(
+    this->DirectoryFileStream, *this->BuildFileStream,
+    cmStrCat(dir, "CMakeFiles/directory.ninja"));
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryFileStreams()
+{
+  this->CloseDirectoryFileStream(this->DirectoryFileStream);
+}
+
 cm::optional<std::set<std::string>> cmGlobalNinjaGenerator::ListSubsetWithAll(
   std::set<std::string> const& all, std::set<std::string> const& defaults,
   std::vector<std::string> const& items)
@@ -1173,19 +1258,16 @@ static void EnsureTrailingSlash(std::string& path)
 std::string const& cmGlobalNinjaGenerator::ConvertToNinjaPath(
   std::string const& path) const
 {
-  auto const f = this->ConvertToNinjaPathCache.find(path);
-  if (f != this->ConvertToNinjaPathCache.end()) {
-    return f->second;
-  }
-
-  std::string convPath =
-    this->LocalGenerators[0]->MaybeRelativeToTopBinDir(path);
-  convPath = this->NinjaOutputPath(convPath);
+  return this->GetPathTable().GetForm(
+    path, cmPathTable::Form::Ninja, [this](std::string const& p) {
+      std::string convPath =
+        this->LocalGenerators[0]->MaybeRelativeToTopBinDir(p);
+      convPath = this->NinjaOutputPath(convPath);
 #ifdef _WIN32
-  std::replace(convPath.begin(), convPath.end(), '/', '\\');
+      std::replace(convPath.begin(), convPath.end(), '/', '\\');
 #endif
-  return this->ConvertToNinjaPathCache.emplace(path, std::move(convPath))
-    .first->second;
+      return convPath;
+    });
 }
 
 std::string cmGlobalNinjaGenerator::ConvertToNinjaAbsPath(
@@ -1275,6 +1357,117 @@ void cmGlobalNinjaGenerator::WriteAssumedSourceDependencies()
   }
 }
 
+void cmGlobalNinjaGenerator::AddDyndepBatchTarget(std::string const& config,
+                                                  DyndepBatchTarget target)
+{
+  this->DyndepBatches[config].emplace_back(std::move(target));
+}
+
+void cmGlobalNinjaGenerator::WriteDyndepBatches()
+{
+  cmLocalNinjaGenerator const* lg =
+    static_cast<cmLocalNinjaGenerator const*>(this->LocalGenerators[0].get());
+  std::string const cmakeCmd = lg->ConvertToOutputFormat(
+    cmSystemTools::GetCMakeCommand(), cmOutputConverter::SHELL);
+
+  for (auto const& batch : this->DyndepBatches) {
+    std::string const& config = batch.first;
+    std::vector<DyndepBatchTarget> const& targets = batch.second;
+
+    std::set<std::string> batchOutputs;
+    for (DyndepBatchTarget const& target : targets) {
+      batchOutputs.insert(target.Build.Outputs.begin(),
+                          target.Build.Outputs.end());
+      batchOutputs.insert(target.Build.ImplicitOuts.begin(),
+                          target.Build.ImplicitOuts.end());
+    }
+
+    // A target reads the module information written for the targets it
+    // links to, so collate those first.
+    std::vector<DyndepBatchTarget const*> ordered;
+    std::set<std::string> written;
+    std::vector<bool> done(targets.size(), false);
+    while (ordered.size() < targets.size()) {
+      size_t const count = ordered.size();
+      for (size_t i = 0; i < targets.size(); ++i) {
+        cmNinjaBuild const& tb = targets[i].Build;
+        if (done[i] ||
+            !std::all_of(tb.ImplicitDeps.begin(), tb.ImplicitDeps.end(),
+                         [&](std::string const& dep) {
+                           return !cm::contains(batchOutputs, dep) ||
+                             cm::contains(written, dep);
+                         })) {
+          continue;
+        }
+        done[i] = true;
+        ordered.push_back(&targets[i]);
+        written.insert(tb.Outputs.begin(), tb.Outputs.end());
+        written.insert(tb.ImplicitOuts.begin(), tb.ImplicitOuts.end());
+      }
+      if (ordered.size() == count) {
+        // The targets depend on each other.  Keep their original order.
+        for (size_t i = 0; i < targets.size(); ++i) {
+          if (!done[i]) {
+            ordered.push_back(&targets[i]);
+          }
+        }
+      }
+    }
+
+    cmNinjaBuild build(cmStrCat("DYNDEP_BATCH_", config));
+    build.Comment = "Collate the dyndep files of all targets.";
+    build.RspFile = this->NinjaOutputPath(
+      cmStrCat("CMakeFiles/dyndep_batch", config.empty() ? "" : "_", config,
+               ".rsp"));
+    std::set<std::string> implicitDeps;
+    std::string args;
+    for (DyndepBatchTarget const* target : ordered) {
+      cmNinjaBuild const& tb = target->Build;
+      args += cmStrCat(
+        " --tdi=",
+        lg->ConvertToOutputFormat(target->TargetDependInfo,
+                                  cmOutputConverter::SHELL),
+        " --lang=", target->Language);
+      if (!target->ModuleMapFormat.empty()) {
+        args += cmStrCat(" --modmapfmt=", target->ModuleMapFormat);
+      }
+      args += cmStrCat(
+        " --dd=",
+        lg->ConvertToOutputFormat(tb.Outputs.front(),
+                                  cmOutputConverter::SHELL));
+      for (std::string const& ddi : tb.ExplicitDeps) {
+        args += cmStrCat(
+          ' ', lg->ConvertToOutputFormat(ddi, cmOutputConverter::SHELL));
+      }
+      cm::append(build.Outputs, tb.Outputs);
+      cm::append(build.ImplicitOuts, tb.ImplicitOuts);
+      cm::append(build.ExplicitDeps, tb.ExplicitDeps);
+      for (std::string const& dep : tb.ImplicitDeps) {
+        if (!cm::contains(batchOutputs, dep) &&
+            implicitDeps.insert(dep).second) {
+          build.ImplicitDeps.push_back(dep);
+        }
+      }
+    }
+    build.Variables["DYNDEP_BATCH_ARGS"] = this->EncodeLiteral(args);
+
+    cmNinjaRule rule(build.Rule);
+    rule.Command = lg->BuildCommandLine(
+      { cmStrCat(cmakeCmd, " -E cmake_ninja_dyndep @$RSP_FILE") }, config,
+      config);
+    rule.RspFile = "$RSP_FILE";
+    rule.RspContent = "$DYNDEP_BATCH_ARGS";
+    // The collator only updates files whose content changes.
+    rule.Restat = "1";
+    rule.Comment = "Rule to generate the ninja dyndep files of all targets.";
+    rule.Description = "Generating dyndep files";
+    this->AddRule(rule);
+
+    this->WriteBuild(*this->GetImplFileStream(config), build,
+                     /*cmdLineLimit=*/-1);
+  }
+}
+
 std::string cmGlobalNinjaGenerator::OrderDependsTargetForTarget(
   cmGeneratorTarget const* target, std::string const& /*config*/) const
 {
@@ -2321,6 +2514,12 @@ Compilation of source files within a target is split into the following steps:
    is placed in the ``Fortran.dd`` file for ninja to load later.  It also
    writes the expected location of modules provided by this target into
    ``FortranModules.json`` for use by dependent targets.
+   Several targets may be collated by one invocation by repeating the
+   ``--tdi=``, ``--lang=`` and ``--dd=`` argument group for each of them in
+   dependency order, in which case ``FortranModules.json`` files written for
+   earlier targets are reused from memory by later ones.  The
+   ``CMAKE_NINJA_BATCH_DYNDEP`` variable makes the generator collate all
+   targets of a configuration this way.
 
 3. Compile all sources after loading dynamically discovered dependencies
    of the compilation build statements from their ``dyndep`` bindings.
@@ -2569,6 +2768,33 @@ cm::optional<cmSourceInfo> cmcmd_cmake_ninja_depends_fortran(
 }
 }
 
+Json::Value const* cmGlobalNinjaGenerator::ReadDyndepModuleInfo(
+  std::string const& target_dir, std::string const& arg_lang)
+{
+  std::string const tmn = cmSystemTools::CollapseFullPath(
+    cmStrCat(target_dir, '/', arg_lang, "Modules.json"));
+  auto const cached = this->DyndepModuleInfo.find(tmn);
+  if (cached != this->DyndepModuleInfo.end()) {
+    return &cached->second;
+  }
+
+  Json::Value tm;
+  cmsys::ifstream tmf(tmn.c_str(), std::ios::in | std::ios::binary);
+  if (!tmf) {
+    cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to open ", tmn,
+                                  " for module information"));
+    return nullptr;
+  }
+  Json::Reader reader;
+  if (!reader.parse(tmf, tm, false)) {
+    cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                  target_dir,
+                                  reader.getFormattedErrorMessages()));
+    return nullptr;
+  }
+  return &(this->DyndepModuleInfo[tmn] = std::move(tm));
+}
+
 bool cmGlobalNinjaGenerator::WriteDyndepFile(
   std::string const& dir_top_src, std::string const& dir_top_bld,
   std::string const& dir_cur_src, std::string const& dir_cur_bld,
@@ -2614,22 +2840,12 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
 
   // Populate the module map with those provided by linked targets first.
   for (std::string const& linked_target_dir : linked_target_dirs) {
-    std::string const ltmn =
-      cmStrCat(linked_target_dir, '/', arg_lang, "Modules.json");
-    Json::Value ltm;
-    cmsys::ifstream ltmf(ltmn.c_str(), std::ios::in | std::ios::binary);
-    if (!ltmf) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to open ",
-                                    ltmn, " for module information"));
-      return false;
-    }
-    Json::Reader reader;
-    if (!reader.parse(ltmf, ltm, false)) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    linked_target_dir,
-                                    reader.getFormattedErrorMessages()));
+    Json::Value const* ltmp =
+      this->ReadDyndepModuleInfo(linked_target_dir, arg_lang);
+    if (!ltmp) {
       return false;
     }
+    Json::Value const& ltm = *ltmp;
     if (ltm.isObject()) {
       Json::Value const& target_modules = ltm["modules"];
       if (target_modules.isObject()) {
@@ -2867,22 +3083,12 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
   // Populate the module map with those provided by linked targets first.
   for (std::string const& forward_modules_from_target_dir :
        forward_modules_from_target_dirs) {
-    std::string const fmftn =
-      cmStrCat(forward_modules_from_target_dir, '/', arg_lang, "Modules.json");
-    Json::Value fmft;
-    cmsys::ifstream fmftf(fmftn.c_str(), std::ios::in | std::ios::binary);
-    if (!fmftf) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to open ",
-                                    fmftn, " for module information"));
-      return false;
-    }
-    Json::Reader reader;
-    if (!reader.parse(fmftf, fmft, false)) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    forward_modules_from_target_dir,
-                                    reader.getFormattedErrorMessages()));
+    Json::Value const* fmftp =
+      this->ReadDyndepModuleInfo(forward_modules_from_target_dir, arg_lang);
+    if (!fmftp) {
       return false;
     }
+    Json::Value const& fmft = *fmftp;
     if (!fmft.isObject()) {
       continue;
     }
@@ -2911,6 +3117,8 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
   cmGeneratedFileStream tmf(target_mods_file);
   tmf.SetCopyIfDifferent(true);
   tmf << target_module_info;
+  this->DyndepModuleInfo[cmSystemTools::CollapseFullPath(target_mods_file)] =
+    std::move(target_module_info);
 
   cmDyndepMetadataCallbacks cb;
   cb.ModuleFile =
@@ -2926,113 +3134,165 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
                                                 cb);
 }
 
+namespace {
+struct cmNinjaDyndepTargetArgs
+{
+  std::string DD;
+  std::string Lang;
+  std::string TDI;
+  std::string ModMapFmt;
+  std::vector<std::string> DDIs;
+};
+}
+
 int cmcmd_cmake_ninja_dyndep(std::vector<std::string>::const_iterator argBeg,
                              std::vector<std::string>::const_iterator argEnd)
 {
   std::vector<std::string> arg_full =
     cmSystemTools::HandleResponseFile(argBeg, argEnd);
 
-  std::string arg_dd;
-  std::string arg_lang;
-  std::string arg_tdi;
-  std::string arg_modmapfmt;
-  std::vector<std::string> arg_ddis;
+  // The options of a target may be given in any order, and its '.ddi'
+  // files follow the first of them.  A '--tdi=' option given after the
+  // current target already has one starts the arguments of another target,
+  // so every target of a batch after the first must start with '--tdi='.
+  // Batching targets in dependency order collates all of them in a single
+  // process that shares the module information of the targets it wrote.
+  std::vector<cmNinjaDyndepTargetArgs> targets(1);
+  auto option = [&targets](std::string cmNinjaDyndepTargetArgs::*field,
+                           cm::string_view name, std::string value) -> bool {
+    if (!(targets.back().*field).empty()) {
+      cmSystemTools::Error(
+        cmStrCat("-E cmake_ninja_dyndep given ", name,
+                 " more than once for one target.  "
+                 "Each batched target must start with --tdi="));
+      return false;
+    }
+    targets.back().*field = std::move(value);
+    return true;
+  };
   for (std::string const& arg : arg_full) {
+    bool ok = true;
     if (cmHasLiteralPrefix(arg, "--tdi=")) {
-      arg_tdi = arg.substr(6);
+      if (!targets.back().TDI.empty()) {
+        targets.emplace_back();
+      }
+      targets.back().TDI = arg.substr(6);
     } else if (cmHasLiteralPrefix(arg, "--lang=")) {
-      arg_lang = arg.substr(7);
+      ok = option(&cmNinjaDyndepTargetArgs::Lang, "--lang="_s, arg.substr(7));
     } else if (cmHasLiteralPrefix(arg, "--dd=")) {
-      arg_dd = arg.substr(5);
+      ok = option(&cmNinjaDyndepTargetArgs::DD, "--dd="_s, arg.substr(5));
     } else if (cmHasLiteralPrefix(arg, "--modmapfmt=")) {
-      arg_modmapfmt = arg.substr(12);
+      ok = option(&cmNinjaDyndepTargetArgs::ModMapFmt, "--modmapfmt="_s,
+                  arg.substr(12));
     } else if (!cmHasLiteralPrefix(arg, "--") &&
                cmHasLiteralSuffix(arg, ".ddi")) {
-      arg_ddis.push_back(arg);
+      targets.back().DDIs.push_back(arg);
     } else {
       cmSystemTools::Error(
         cmStrCat("-E cmake_ninja_dyndep unknown argument: ", arg));
       return 1;
     }
+    if (!ok) {
+      return 1;
+    }
   }
-  if (arg_tdi.empty()) {
-    cmSystemTools::Error("-E cmake_ninja_dyndep requires value for --tdi=");
-    return 1;
-  }
-  if (arg_lang.empty()) {
-    cmSystemTools::Error("-E cmake_ninja_dyndep requires value for --lang=");
-    return 1;
-  }
-  if (arg_dd.empty()) {
-    cmSystemTools::Error("-E cmake_ninja_dyndep requires value for --dd=");
-    return 1;
-  }
-
-  Json::Value tdio;
-  Json::Value const& tdi = tdio;
-  {
-    cmsys::ifstream tdif(arg_tdi.c_str(), std::ios::in | std::ios::binary);
-    Json::Reader reader;
-    if (!reader.parse(tdif, tdio, false)) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    arg_tdi,
-                                    reader.getFormattedErrorMessages()));
+  for (cmNinjaDyndepTargetArgs const& target : targets) {
+    if (target.TDI.empty()) {
+      cmSystemTools::Error("-E cmake_ninja_dyndep requires value for --tdi=");
+      return 1;
+    }
+    if (target.Lang.empty()) {
+      cmSystemTools::Error("-E cmake_ninja_dyndep requires value for --lang=");
+      return 1;
+    }
+    if (target.DD.empty()) {
+      cmSystemTools::Error("-E cmake_ninja_dyndep requires value for --dd=");
       return 1;
     }
   }
 
-  std::string const dir_cur_bld = tdi["dir-cur-bld"].asString();
-  std::string const dir_cur_src = tdi["dir-cur-src"].asString();
-  std::string const dir_top_bld = tdi["dir-top-bld"].asString();
-  std::string const dir_top_src = tdi["dir-top-src"].asString();
-  std::string module_dir = tdi["module-dir"].asString();
-  if (!module_dir.empty() && !cmHasLiteralSuffix(module_dir, "/")) {
-    module_dir += '/';
-  }
-  std::vector<std::string> linked_target_dirs;
-  Json::Value const& tdi_linked_target_dirs = tdi["linked-target-dirs"];
-  if (tdi_linked_target_dirs.isArray()) {
-    for (auto const& tdi_linked_target_dir : tdi_linked_target_dirs) {
-      linked_target_dirs.push_back(tdi_linked_target_dir.asString());
+  std::unique_ptr<cmake> cm;
+  std::unique_ptr<cmGlobalGenerator> ggd;
+  std::string batch_top_src;
+  std::string batch_top_bld;
+  for (cmNinjaDyndepTargetArgs const& target : targets) {
+    Json::Value tdio;
+    Json::Value const& tdi = tdio;
+    {
+      cmsys::ifstream tdif(target.TDI.c_str(),
+                           std::ios::in | std::ios::binary);
+      Json::Reader reader;
+      if (!reader.parse(tdif, tdio, false)) {
+        cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                      target.TDI,
+                                      reader.getFormattedErrorMessages()));
+        return 1;
+      }
     }
-  }
-  std::vector<std::string> forward_modules_from_target_dirs;
-  Json::Value const& tdi_forward_modules_from_target_dirs =
-    tdi["forward-modules-from-target-dirs"];
-  if (tdi_forward_modules_from_target_dirs.isArray()) {
-    for (auto const& tdi_forward_modules_from_target_dir :
-         tdi_forward_modules_from_target_dirs) {
-      forward_modules_from_target_dirs.push_back(
-        tdi_forward_modules_from_target_dir.asString());
+
+    std::string const dir_cur_bld = tdi["dir-cur-bld"].asString();
+    std::string const dir_cur_src = tdi["dir-cur-src"].asString();
+    std::string const dir_top_bld = tdi["dir-top-bld"].asString();
+    std::string const dir_top_src = tdi["dir-top-src"].asString();
+    std::string module_dir = tdi["module-dir"].asString();
+    if (!module_dir.empty() && !cmHasLiteralSuffix(module_dir, "/")) {
+      module_dir += '/';
     }
-  }
-  std::string const compilerId = tdi["compiler-id"].asString();
-  std::string const simulateId = tdi["compiler-simulate-id"].asString();
-  std::string const compilerFrontendVariant =
-    tdi["compiler-frontend-variant"].asString();
+    std::vector<std::string> linked_target_dirs;
+    Json::Value const& tdi_linked_target_dirs = tdi["linked-target-dirs"];
+    if (tdi_linked_target_dirs.isArray()) {
+      for (auto const& tdi_linked_target_dir : tdi_linked_target_dirs) {
+        linked_target_dirs.push_back(tdi_linked_target_dir.asString());
+      }
+    }
+    std::vector<std::string> forward_modules_from_target_dirs;
+    Json::Value const& tdi_forward_modules_from_target_dirs =
+      tdi["forward-modules-from-target-dirs"];
+    if (tdi_forward_modules_from_target_dirs.isArray()) {
+      for (auto const& tdi_forward_modules_from_target_dir :
+           tdi_forward_modules_from_target_dirs) {
+        forward_modules_from_target_dirs.push_back(
+          tdi_forward_modules_from_target_dir.asString());
+      }
+    }
+    std::string const compilerId = tdi["compiler-id"].asString();
+    std::string const simulateId = tdi["compiler-simulate-id"].asString();
+    std::string const compilerFrontendVariant =
+      tdi["compiler-frontend-variant"].asString();
 
-  auto export_info = cmDyndepCollation::ParseExportInfo(tdi);
+    auto export_info = cmDyndepCollation::ParseExportInfo(tdi);
 
-  cmake cm(cmake::RoleInternal, cmState::Unknown);
-  cm.SetHomeDirectory(dir_top_src);
-  cm.SetHomeOutputDirectory(dir_top_bld);
-  auto ggd = cm.CreateGlobalGenerator("Ninja");
-  if (!ggd) {
-    return 1;
-  }
-  cmGlobalNinjaGenerator& gg =
-    cm::static_reference_cast<cmGlobalNinjaGenerator>(ggd);
+    if (!cm) {
+      cm = cm::make_unique<cmake>(cmake::RoleInternal, cmState::Unknown);
+      cm->SetHomeDirectory(dir_top_src);
+      cm->SetHomeOutputDirectory(dir_top_bld);
+      ggd = cm->CreateGlobalGenerator("Ninja");
+      if (!ggd) {
+        return 1;
+      }
+      batch_top_src = dir_top_src;
+      batch_top_bld = dir_top_bld;
+    } else if (dir_top_src != batch_top_src || dir_top_bld != batch_top_bld) {
+      cmSystemTools::Error(
+        cmStrCat("-E cmake_ninja_dyndep cannot batch ", target.TDI,
+                 " with targets from another build tree"));
+      return 1;
+    }
+    cmGlobalNinjaGenerator& gg =
+      cm::static_reference_cast<cmGlobalNinjaGenerator>(ggd);
 #  ifdef _WIN32
-  if (DetectGCCOnWindows(compilerId, simulateId, compilerFrontendVariant)) {
-    gg.MarkAsGCCOnWindows();
-  }
+    gg.MarkAsGCCOnWindows(
+      DetectGCCOnWindows(compilerId, simulateId, compilerFrontendVariant));
 #  endif
-  return gg.WriteDyndepFile(dir_top_src, dir_top_bld, dir_cur_src, dir_cur_bld,
-                            arg_dd, arg_ddis, module_dir, linked_target_dirs,
-                            forward_modules_from_target_dirs, arg_lang,
-                            arg_modmapfmt, *export_info)
-    ? 0
-    : 1;
+    if (!gg.WriteDyndepFile(dir_top_src, dir_top_bld, dir_cur_src,
+                            dir_cur_bld, target.DD, target.DDIs, module_dir,
+                            linked_target_dirs,
+                            forward_modules_from_target_dirs, target.Lang,
+                            target.ModMapFmt, *export_info)) {
+      return 1;
+    }
+  }
+  return 0;
 }
 
 #endif
@@ -3177,6 +3437,33 @@ void cmGlobalNinjaMultiGenerator::CloseBuildFileStreams()
   }
 }
 
+bool cmGlobalNinjaMultiGenerator::OpenDirectoryFileStreams(
+  std::string const& homeRelativeDir)
+{
+  // Directories outside of the build tree stay in the main build files.
+  if (!this->SubninjaPerDirectory ||
+      cmSystemTools::FileIsFullPath(homeRelativeDir)) {
+    return true;
+  }
+  std::string const dir =
+    homeRelativeDir.empty() ? std::string() : cmStrCat(homeRelativeDir, '/');
+  std::vector<std::string> const& configs = this->GetConfigNames();
+  return std::all_of(
+    configs.begin(), configs.end(),
+    [this, &dir](std::string const& config) -> bool {
+      return this->OpenDirectoryFileStream(
+        this->DirectoryFileStreams[config], *this->ImplFileStreams[config],
+        cmStrCat(dir, "CMakeFiles/directory-", config, ".ninja"));
+    });
+}
+
+void cmGlobalNinjaMultiGenerator::CloseDirectoryFileStreams()
+{
+  for (auto& stream : this->DirectoryFileStreams) {
+    this->CloseDirectoryFileStream(stream.second);
+  }
+}
+
 void cmGlobalNinjaMultiGenerator::AppendNinjaFileArgument(
   GeneratedMakeCommand& command, std::string const& config) const
 {
@@ -16,6 +16,10 @@
 
 #include <cm/optional>
 
+#if !defined(CMAKE_BOOTSTRAP)
+#  include <cm3p/json/value.h>
+#endif
+
 #include "cm_codecvt_Encoding.hxx"
 
 #include "cmBuildOptions.h"
@@ -111,6 +115,30 @@ public:
   void WriteBuild(std::ostream& os, cmNinjaBuild const& build,
                   int cmdLineLimit = 0, bool* usedResponseFile = nullptr);
 
+  /**
+   * Replace the FLAGS, DEFINES and INCLUDES values in @a vars by
+   * references to file scope variables of @a os.  Each distinct value
+   * is written to @a os once, before its first use, so compile
+   * statements sharing flags do not repeat them.
+   */
+  void PoolCompileVariables(std::ostream& os, cmNinjaVars& vars);
+
+  /// The dyndep collation of one target and language, when all targets of
+  /// a configuration are collated by one statement.
+  struct DyndepBatchTarget
+  {
+    std::string Language;
+    std::string TargetDependInfo;
+    std::string ModuleMapFormat;
+    /// The statement that would collate this target on its own.
+    cmNinjaBuild Build;
+  };
+
+  /// Whether CMAKE_NINJA_BATCH_DYNDEP is enabled.
+  bool IsDyndepBatched() const { return this->DyndepBatched; }
+  void AddDyndepBatchTarget(std::string const& config,
+                            DyndepBatchTarget target);
+
   class CCOutputs
   {
     cmGlobalNinjaGenerator* GG;
@@ -168,7 +196,7 @@ public:
                            std::string const& comment = "");
 
   bool IsGCCOnWindows() const { return this->UsingGCCOnWindows; }
-  void MarkAsGCCOnWindows() { this->UsingGCCOnWindows = true; }
+  void MarkAsGCCOnWindows(bool gcc = true) { this->UsingGCCOnWindows = gcc; }
 
   cmGlobalNinjaGenerator(cmake* cm);
 
@@ -244,9 +272,21 @@ public:
   virtual cmGeneratedFileStream* GetImplFileStream(
     std::string const& /*config*/) const
   {
+    if (this->DirectoryFileStream) {
+      return this->DirectoryFileStream.get();
+    }
     return this->BuildFileStream.get();
   }
 
+  /**
+   * Write the build statements of the directory @a homeRelativeDir to
+   * subninja files of that directory until CloseDirectoryFileStreams() is
+   * called, if CMAKE_NINJA_SUBNINJA_PER_DIRECTORY is enabled.  This
+   * redirects GetImplFileStream().
+   */
+  virtual bool OpenDirectoryFileStreams(std::string const& homeRelativeDir);
+  virtual void CloseDirectoryFileStreams();
+
   virtual cmGeneratedFileStream* GetConfigFileStream(
     std::string const& /*config*/) const
   {
@@ -440,6 +480,13 @@ public:
     std::string const& arg_lang, std::string const& arg_modmapfmt,
     cmCxxModuleExportInfo const& export_info);
 
+#if !defined(CMAKE_BOOTSTRAP)
+  /// Load the ``<lang>Modules.json`` file of a target directory, reusing
+  /// the content if this process already read or wrote it.
+  Json::Value const* ReadDyndepModuleInfo(std::string const& target_dir,
+                                          std::string const& arg_lang);
+#endif
+
   virtual std::string BuildAlias(std::string const& alias,
                                  std::string const& /*config*/) const
   {
@@ -499,6 +546,10 @@ protected:
 
   bool OpenFileStream(std::unique_ptr<cmGeneratedFileStream>& stream,
                       std::string const& name);
+  bool OpenDirectoryFileStream(std::unique_ptr<cmGeneratedFileStream>& stream,
+                               std::ostream& parent, std::string const& name);
+  void CloseDirectoryFileStream(
+    std::unique_ptr<cmGeneratedFileStream>& stream);
 
   static cm::optional<std::set<std::string>> ListSubsetWithAll(
     std::set<std::string> const& all, std::set<std::string> const& defaults,
@@ -508,6 +559,12 @@ protected:
   std::set<std::string> DefaultConfigs;
   std::string DefaultFileConfig;
 
+  /// Whether each directory writes its build statements to subninja files.
+  bool SubninjaPerDirectory = false;
+
+  /// Whether one statement per configuration collates all dyndep files.
+  bool DyndepBatched = false;
+
 private:
   bool FindMakeProgram(cmMakefile* mf) override;
   void CheckNinjaFeatures();
@@ -527,6 +584,7 @@ private:
   void WriteDisclaimer(std::ostream& os) const;
 
   void WriteAssumedSourceDependencies();
+  void WriteDyndepBatches();
 
   void WriteTargetAliases(std::ostream& os);
   void WriteFolderTargets(std::ostream& os);
@@ -552,6 +610,8 @@ private:
   /// The file containing the build statement. (the relationship of the
   /// compilation DAG).
   std::unique_ptr<cmGeneratedFileStream> BuildFileStream;
+  /// The subninja file of the directory currently being generated.
+  std::unique_ptr<cmGeneratedFileStream> DirectoryFileStream;
   /// The file containing the rule statements. (The action attached to each
   /// edge of the compilation DAG).
   std::unique_ptr<cmGeneratedFileStream> RulesFileStream;
@@ -583,8 +643,21 @@ private:
   TargetAliasMap TargetAliases;
   TargetAliasMap DefaultTargetAliases;
 
-  /// the local cache for calls to ConvertToNinjaPath
-  mutable std::unordered_map<std::string, std::string> ConvertToNinjaPathCache;
+#if !defined(CMAKE_BOOTSTRAP)
+  /// Target module information seen by WriteDyndepFile, keyed by the full
+  /// path of its ``<lang>Modules.json`` file.  A batched dyndep invocation
+  /// collates targets in dependency order, so dependents find the modules
+  /// of the targets they link to here instead of re-parsing them.
+  std::map<std::string, Json::Value> DyndepModuleInfo;
+#endif
+
+  /// Targets collated by the batched dyndep statement, by configuration.
+  std::map<std::string, std::vector<DyndepBatchTarget>> DyndepBatches;
+
+  /// File scope variables written by PoolCompileVariables, by build file
+  /// and then by variable name and value.
+  std::map<std::ostream const*, std::unordered_map<std::string, std::string>>
+    PooledVariables;
 
   std::string NinjaCommand;
   std::string NinjaVersion;
@@ -705,9 +778,16 @@ public:
   cmGeneratedFileStream* GetImplFileStream(
     std::string const& config) const override
   {
+    auto const it = this->DirectoryFileStreams.find(config);
+    if (it != this->DirectoryFileStreams.end() && it->second) {
+      return it->second.get();
+    }
     return this->ImplFileStreams.at(config).get();
   }
 
+  bool OpenDirectoryFileStreams(std::string const& homeRelativeDir) override;
+  void CloseDirectoryFileStreams() override;
+
   cmGeneratedFileStream* GetConfigFileStream(
     std::string const& config) const override
   {
@@ -754,6 +834,8 @@ private:
     ImplFileStreams;
   std::map<std::string, std::unique_ptr<cmGeneratedFileStream>>
     ConfigFileStreams;
+  std::map<std::string, std::unique_ptr<cmGeneratedFileStream>>
+    DirectoryFileStreams;
   std::unique_ptr<cmGeneratedFileStream> CommonFileStream;
   std::unique_ptr<cmGeneratedFileStream> DefaultFileStream;
 };
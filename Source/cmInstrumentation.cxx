@@ -10,6 +10,7 @@
 
 #include <cm/optional>
 
+#include <cm3p/json/reader.h>
 #include <cm3p/json/writer.h>
 #include <cm3p/uv.h>
 
@@ -19,10 +20,16 @@
 
 #include "cmCryptoHash.h"
 #include "cmExperimental.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
 #include "cmInstrumentationQuery.h"
 #include "cmJSONState.h"
+#include "cmLocalGenerator.h"
+#include "cmState.h"
+#include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmTargetDepend.h"
 #include "cmTimestamp.h"
 #include "cmUVProcessChain.h"
 #include "cmValue.h"
@@ -222,6 +229,9 @@ int cmInstrumentation::CollectTimingData(cmInstrumentationQuery::Hook hook)
   std::string index_path = cmStrCat(directory, "/", file_name);
   cmSystemTools::Touch(index_path, true);
 
+  // Claim the snippets logged so far
+  std::string const snippet_log = this->ClaimSnippetLog(directory);
+
   // Gather Snippets
   using snippet = std::pair<std::string, std::string>;
   std::vector<snippet> files;
@@ -262,6 +272,9 @@ int cmInstrumentation::CollectTimingData(cmInstrumentationQuery::Hook hook)
   if (this->HasQuery(cmInstrumentationQuery::Query::StaticSystemInformation)) {
     this->InsertStaticSystemInformation(index);
   }
+  if (!snippet_log.empty()) {
+    index["snippetLog"] = snippet_log;
+  }
   for (auto const& file : files) {
     if (last_index.empty()) {
       index["snippets"].append(file.first);
@@ -291,11 +304,61 @@ int cmInstrumentation::CollectTimingData(cmInstrumentationQuery::Hook hook)
   for (auto const& f : index["snippets"]) {
     cmSystemTools::RemoveFile(cmStrCat(directory, "/", f.asString()));
   }
+  if (!snippet_log.empty()) {
+    cmSystemTools::RemoveFile(cmStrCat(directory, '/', snippet_log));
+  }
   cmSystemTools::RemoveFile(index_path);
 
   return 0;
 }
 
+namespace {
+bool IsLibraryType(cmStateEnums::TargetType type)
+{
+  switch (type) {
+    case cmStateEnums::STATIC_LIBRARY:
+    case cmStateEnums::SHARED_LIBRARY:
+    case cmStateEnums::MODULE_LIBRARY:
+    case cmStateEnums::OBJECT_LIBRARY:
+      return true;
+    default:
+      return false;
+  }
+}
+}
+
+/** Write the dependencies between the targets of the build system, used
+ * by cmInstrumentationAnalysis to order the timing data of the targets.
+ **/
+void cmInstrumentation::WriteTargetGraph(cmGlobalGenerator* gg)
+{
+  Json::Value root(Json::objectValue);
+  root["version"] = 1;
+  Json::Value& targets = root["targets"] = Json::objectValue;
+  for (auto const& lg : gg->GetLocalGenerators()) {
+    for (auto const& gt : lg->GetGeneratorTargets()) {
+      if (!gt->IsInBuildSystem()) {
+        continue;
+      }
+      Json::Value& target = targets[gt->GetName()] = Json::objectValue;
+      target["type"] = cmState::GetTargetTypeName(gt->GetType());
+      Json::Value& dependencies = target["dependencies"] = Json::arrayValue;
+      Json::Value& compileDependencies = target["compileDependencies"] =
+        Json::arrayValue;
+      for (cmTargetDepend const& dep : gg->GetTargetDirectDepends(gt.get())) {
+        dependencies.append(dep->GetName());
+        // The Ninja generators order the compiles of a target after those
+        // of the libraries it depends on may start, not after the
+        // libraries are built.  The other generators order whole targets.
+        if (!gg->IsNinja() || !IsLibraryType(dep->GetType())) {
+          compileDependencies.append(dep->GetName());
+        }
+      }
+    }
+  }
+  this->WriteInstrumentationJson(root, "graph", "targets.json");
+}
+
 void cmInstrumentation::InsertDynamicSystemInformation(
   Json::Value& root, std::string const& prefix)
 {
@@ -384,6 +447,96 @@ void cmInstrumentation::WriteInstrumentationJson(Json::Value& root,
   ftmp.close();
 }
 
+/*
+ * With the snippetLog query, each snippet is appended as one line of the
+ * form "<file name>\t<json>" to a log in the data directory instead of being
+ * written to its own file.  Each record is appended with a single write to
+ * the log opened in append mode, which the system does not interleave with
+ * the writes of other commands, so writers need no lock.  Indexing claims
+ * the log by renaming it and names it in the index for callbacks to read.
+ */
+void cmInstrumentation::WriteSnippet(Json::Value& root,
+                                     std::string const& file_name)
+{
+  if (!this->HasQuery(cmInstrumentationQuery::Query::SnippetLog)) {
+    this->WriteInstrumentationJson(root, "data", file_name);
+    return;
+  }
+
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+  std::string record =
+    cmStrCat(file_name, '\t', Json::writeString(wbuilder, root), '\n');
+  std::string const& directory = cmStrCat(this->timingDirv1, "/data");
+  cmSystemTools::MakeDirectory(directory);
+
+  uv_fs_t req;
+  int fd = uv_fs_open(nullptr, &req,
+                      cmStrCat(directory, "/.snippets.log").c_str(),
+                      UV_FS_O_WRONLY | UV_FS_O_APPEND | UV_FS_O_CREAT, 0644,
+                      nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0) {
+    this->WriteInstrumentationJson(root, "data", file_name);
+    return;
+  }
+  uv_buf_t buf =
+    uv_buf_init(&record[0], static_cast<unsigned int>(record.size()));
+  int n;
+  do {
+    n = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+  } while (n == UV_EINTR);
+  if (n != static_cast<int>(record.size())) {
+    // A short write, e.g. to a full disk, leaves a partial line that
+    // readers drop.  End it, and keep the snippet in its own file.
+    if (n > 0) {
+      char newline = '\n';
+      buf = uv_buf_init(&newline, 1);
+      uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+    }
+    this->WriteInstrumentationJson(root, "data", file_name);
+  }
+  uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+}
+
+std::string cmInstrumentation::ClaimSnippetLog(std::string const& data_dir)
+{
+  std::string const log = cmStrCat(data_dir, "/.snippets.log");
+  std::string const claimed =
+    cmStrCat(".snippets-", ComputeSuffixTime(), ".log");
+  if (!cmSystemTools::FileExists(log) ||
+      !cmSystemTools::RenameFile(log, cmStrCat(data_dir, '/', claimed))) {
+    return std::string();
+  }
+  return claimed;
+}
+
+void cmInstrumentation::ReadSnippetLog(
+  std::string const& log,
+  std::function<void(std::string const&, Json::Value const&)> const&
+    snippet)
+{
+  cmsys::ifstream fin(log.c_str(), std::ios::in | std::ios::binary);
+  Json::CharReaderBuilder rbuilder;
+  std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader());
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    std::string::size_type const tab = line.find('\t');
+    if (tab == std::string::npos) {
+      continue;
+    }
+    Json::Value root;
+    char const* begin = line.data() + tab + 1;
+    if (reader->parse(begin, line.data() + line.size(), &root, nullptr) &&
+        root.isObject()) {
+      snippet(line.substr(0, tab), root);
+    }
+  }
+}
+
 std::string cmInstrumentation::InstrumentTest(
   std::string const& name, std::string const& command,
   std::vector<std::string> const& args, int64_t result,
@@ -410,7 +563,7 @@ std::string cmInstrumentation::InstrumentTest(
   std::string file_name =
     cmStrCat("test-", this->ComputeSuffixHash(command_str),
              this->ComputeSuffixTime(), ".json");
-  this->WriteInstrumentationJson(root, "data", file_name);
+  this->WriteSnippet(root, file_name);
   return file_name;
 }
 
@@ -529,7 +682,7 @@ int cmInstrumentation::InstrumentCommand(
   std::string const& file_name =
     cmStrCat(command_type, "-", this->ComputeSuffixHash(command_str),
              this->ComputeSuffixTime(), ".json");
-  this->WriteInstrumentationJson(root, "data", file_name);
+  this->WriteSnippet(root, file_name);
   return ret;
 }
 
@@ -667,6 +820,38 @@ void cmInstrumentation::PrepareDataForCDash(std::string const& data_dir,
     return;
   }
 
+  // Find the directory for snippets of the role of the given snippet.
+  auto getDestination = [this](Json::Value const& snippet_root,
+                               std::string& dst_dir) -> bool {
+    std::string snippet_role = snippet_root["role"].asString();
+    auto map_element = this->cdashSnippetsMap.find(snippet_role);
+    if (map_element == this->cdashSnippetsMap.end()) {
+      std::string message =
+        "Unexpected snippet type encountered: " + snippet_role;
+      cmSystemTools::Message(message, "Warning");
+      return false;
+    }
+
+    if (map_element->second == "skip") {
+      return false;
+    }
+
+    if (map_element->second == "build") {
+      // We organize snippets on a per-target basis (when possible)
+      // for Build.xml.
+      if (snippet_root.isMember("target")) {
+        dst_dir = cmStrCat(this->cdashDir, "/build/targets/",
+                           snippet_root["target"].asString());
+        cmSystemTools::MakeDirectory(dst_dir);
+      } else {
+        dst_dir = cmStrCat(this->cdashDir, "/build/commands");
+      }
+    } else {
+      dst_dir = cmStrCat(this->cdashDir, '/', map_element->second);
+    }
+    return true;
+  };
+
   std::string dst_dir;
   Json::Value snippets = root["snippets"];
   for (auto const& snippet : snippets) {
@@ -691,34 +876,10 @@ void cmInstrumentation::PrepareDataForCDash(std::string const& data_dir,
       cmSystemTools::Error(error_msg);
       continue;
     }
-
-    std::string snippet_role = snippet_root["role"].asString();
-    auto map_element = this->cdashSnippetsMap.find(snippet_role);
-    if (map_element == this->cdashSnippetsMap.end()) {
-      std::string message =
-        "Unexpected snippet type encountered: " + snippet_role;
-      cmSystemTools::Message(message, "Warning");
-      continue;
-    }
-
-    if (map_element->second == "skip") {
+    if (!getDestination(snippet_root, dst_dir)) {
       continue;
     }
 
-    if (map_element->second == "build") {
-      // We organize snippets on a per-target basis (when possible)
-      // for Build.xml.
-      if (snippet_root.isMember("target")) {
-        dst_dir = cmStrCat(this->cdashDir, "/build/targets/",
-                           snippet_root["target"].asString());
-        cmSystemTools::MakeDirectory(dst_dir);
-      } else {
-        dst_dir = cmStrCat(this->cdashDir, "/build/commands");
-      }
-    } else {
-      dst_dir = cmStrCat(this->cdashDir, '/', map_element->second);
-    }
-
     std::string dst = cmStrCat(dst_dir, '/', snippet_str);
     cmsys::Status copied = cmSystemTools::CopyFileAlways(snippet_path, dst);
     if (!copied) {
@@ -726,4 +887,28 @@ void cmInstrumentation::PrepareDataForCDash(std::string const& data_dir,
       cmSystemTools::Error(error_msg);
     }
   }
+
+  // Snippets in the log are written out to their own files.
+  if (root.isMember("snippetLog")) {
+    ReadSnippetLog(
+      cmStrCat(data_dir, '/', root["snippetLog"].asString()),
+      [&](std::string const& snippet_str, Json::Value const& snippet_root) {
+        if (!snippet_root.isMember("role") ||
+            !getDestination(snippet_root, dst_dir)) {
+          return;
+        }
+        Json::StreamWriterBuilder wbuilder;
+        wbuilder["indentation"] = "\t";
+        std::string dst = cmStrCat(dst_dir, '/', snippet_str);
+        cmsys::ofstream ftmp(dst.c_str());
+        std::unique_ptr<Json::StreamWriter> jsonWriter(
+          wbuilder.newStreamWriter());
+        jsonWriter->write(snippet_root, &ftmp);
+        ftmp << '\n';
+        if (!ftmp.good()) {
+          error_msg = cmStrCat("Failed to write ", dst);
+          cmSystemTools::Error(error_msg);
+        }
+      });
+  }
 }
@@ -18,6 +18,8 @@
 
 #include "cmInstrumentationQuery.h"
 
+class cmGlobalGenerator;
+
 class cmInstrumentation
 {
 public:
@@ -49,17 +51,24 @@ public:
                       std::vector<std::vector<std::string>> const& callback);
   void ClearGeneratedQueries();
   int CollectTimingData(cmInstrumentationQuery::Hook hook);
+  void WriteTargetGraph(cmGlobalGenerator* gg);
   int SpawnBuildDaemon();
   int CollectTimingAfterBuild(int ppid);
   void AddHook(cmInstrumentationQuery::Hook hook);
   void AddQuery(cmInstrumentationQuery::Query query);
   std::string errorMsg;
   std::string const& GetCDashDir();
+  static void ReadSnippetLog(
+    std::string const& log,
+    std::function<void(std::string const&, Json::Value const&)> const&
+      snippet);
 
 private:
   void WriteInstrumentationJson(Json::Value& index,
                                 std::string const& directory,
                                 std::string const& file_name);
+  void WriteSnippet(Json::Value& root, std::string const& file_name);
+  static std::string ClaimSnippetLog(std::string const& data_dir);
   static void InsertStaticSystemInformation(Json::Value& index);
   static void GetDynamicSystemInformation(double& memory, double& load);
   static void InsertDynamicSystemInformation(Json::Value& index,
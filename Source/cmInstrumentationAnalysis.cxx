@@ -0,0 +1,391 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmInstrumentationAnalysis.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include <cm3p/json/writer.h>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmInstrumentation.h"
+#include "cmJSONState.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+std::string Seconds(uint64_t ms)
+{
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(1) << static_cast<double>(ms) / 1000
+    << " s";
+  return s.str();
+}
+}
+
+bool cmInstrumentationAnalysis::ReadIndex(std::string const& indexFile,
+                                          std::string& error)
+{
+  Json::Value index;
+  cmJSONState parseState(indexFile, &index);
+  if (!parseState.errors.empty()) {
+    error = parseState.GetErrorMessage(true);
+    return false;
+  }
+  if (!index.isObject() || !index["dataDir"].isString() ||
+      !index["snippets"].isArray()) {
+    error = cmStrCat("Expected index file ", indexFile,
+                     " to contain an object with 'dataDir' and 'snippets'");
+    return false;
+  }
+
+  std::string const dataDir = index["dataDir"].asString();
+  std::string const graphFile = cmStrCat(
+    cmSystemTools::GetFilenamePath(dataDir), "/graph/targets.json");
+  if (cmSystemTools::FileExists(graphFile) &&
+      !this->ReadTargetGraph(graphFile, error)) {
+    return false;
+  }
+
+  for (Json::Value const& name : index["snippets"]) {
+    std::string const path = cmStrCat(dataDir, '/', name.asString());
+    Json::Value snippet;
+    parseState = cmJSONState(path, &snippet);
+    if (!parseState.errors.empty()) {
+      error = parseState.GetErrorMessage(true);
+      return false;
+    }
+    if (snippet.isObject()) {
+      this->AddSnippet(snippet);
+    }
+  }
+  if (index["snippetLog"].isString()) {
+    cmInstrumentation::ReadSnippetLog(
+      cmStrCat(dataDir, '/', index["snippetLog"].asString()),
+      [this](std::string const&, Json::Value const& snippet) {
+        this->AddSnippet(snippet);
+      });
+  }
+  return true;
+}
+
+bool cmInstrumentationAnalysis::ReadTargetGraph(std::string const& file,
+                                                std::string& error)
+{
+  Json::Value root;
+  cmJSONState parseState(file, &root);
+  if (!parseState.errors.empty()) {
+    error = parseState.GetErrorMessage(true);
+    return false;
+  }
+  if (!root.isObject() || !root["targets"].isObject()) {
+    error = cmStrCat("Expected target graph ", file,
+                     " to contain an object with 'targets'");
+    return false;
+  }
+  Json::Value const& targets = root["targets"];
+  for (std::string const& name : targets.getMemberNames()) {
+    Target& target = this->Targets[name];
+    for (Json::Value const& dep : targets[name]["dependencies"]) {
+      target.Dependencies.push_back(dep.asString());
+    }
+    // Without the compile dependencies, order the compiles after all.
+    Json::Value const& compileDeps = targets[name]["compileDependencies"];
+    if (compileDeps.isArray()) {
+      for (Json::Value const& dep : compileDeps) {
+        target.CompileDependencies.push_back(dep.asString());
+      }
+    } else {
+      target.CompileDependencies = target.Dependencies;
+    }
+  }
+  this->HaveGraph = true;
+  return true;
+}
+
+bool cmInstrumentationAnalysis::Target::IsCompileDependency(
+  std::string const& dep) const
+{
+  return std::find(this->CompileDependencies.begin(),
+                   this->CompileDependencies.end(),
+                   dep) != this->CompileDependencies.end();
+}
+
+void cmInstrumentationAnalysis::AddSnippet(Json::Value const& snippet)
+{
+  std::string const role = snippet["role"].asString();
+  if ((role != "compile" && role != "link") || !snippet["target"].isString()) {
+    return;
+  }
+  uint64_t const duration = snippet["duration"].asUInt64();
+  Target& target = this->Targets[snippet["target"].asString()];
+  // A target links once per configuration and build, so the longest link
+  // is the one a single build waits for.
+  if (role == "compile") {
+    target.LongestCompile = std::max(target.LongestCompile, duration);
+  } else {
+    target.Link = std::max(target.Link, duration);
+  }
+  target.Work += duration;
+  ++target.Commands;
+  this->TotalWork += duration;
+}
+
+void cmInstrumentationAnalysis::Compute()
+{
+  // Order targets so that each follows its dependencies.  The generated
+  // graph is acyclic; edges closing a cycle in other input are ignored.
+  std::vector<std::string const*> order;
+  std::map<std::string const*, int> state;
+  std::vector<std::pair<std::string const*, size_t>> stack;
+  for (auto const& entry : this->Targets) {
+    if (state[&entry.first]) {
+      continue;
+    }
+    state[&entry.first] = 1;
+    stack.emplace_back(&entry.first, 0);
+    while (!stack.empty()) {
+      std::string const* name = stack.back().first;
+      size_t& next = stack.back().second;
+      std::vector<std::string> const& deps =
+        this->Targets.at(*name).Dependencies;
+      if (next < deps.size()) {
+        auto dep = this->Targets.find(deps[next++]);
+        if (dep != this->Targets.end() && !state[&dep->first]) {
+          state[&dep->first] = 1;
+          stack.emplace_back(&dep->first, 0);
+        }
+        continue;
+      }
+      order.push_back(name);
+      stack.pop_back();
+    }
+  }
+
+  // Forward pass.  The compiles of a target start once the links of its
+  // compile dependencies are done and the compiles of its other
+  // dependencies may start.  The link starts once the compiles and the
+  // links of all dependencies are done.
+  this->Length = 0;
+  std::string const* last = nullptr;
+  for (std::string const* name : order) {
+    Target& target = this->Targets.at(*name);
+    target.EarliestStart = 0;
+    target.EarliestLinkStart = 0;
+    for (std::string const& depName : target.Dependencies) {
+      auto dep = this->Targets.find(depName);
+      if (dep == this->Targets.end()) {
+        continue;
+      }
+      target.EarliestStart = std::max(target.EarliestStart,
+                                      target.IsCompileDependency(depName)
+                                        ? dep->second.EarliestFinish()
+                                        : dep->second.EarliestStart);
+      target.EarliestLinkStart =
+        std::max(target.EarliestLinkStart, dep->second.EarliestFinish());
+    }
+    target.EarliestLinkStart = std::max(
+      target.EarliestLinkStart, target.EarliestStart + target.LongestCompile);
+    if (!last || target.EarliestFinish() > this->Length) {
+      this->Length = target.EarliestFinish();
+      last = name;
+    }
+  }
+
+  // Backward pass: latest finish of each link, and latest start of each
+  // target's compiles, that do not delay the build.  A compile dependency
+  // must link before its dependents may compile, and any other dependency
+  // must start compiling before they may.
+  std::map<std::string const*, uint64_t> latestFinish;
+  std::map<std::string const*, uint64_t> latestStart;
+  auto lower = [](std::map<std::string const*, uint64_t>& latest,
+                  std::string const* name, uint64_t value) {
+    auto ins = latest.emplace(name, value);
+    if (!ins.second) {
+      ins.first->second = std::min(ins.first->second, value);
+    }
+  };
+  for (auto i = order.rbegin(); i != order.rend(); ++i) {
+    Target& target = this->Targets.at(**i);
+    auto lf = latestFinish.find(*i);
+    uint64_t const linkFinish =
+      std::max(lf != latestFinish.end() ? lf->second : this->Length,
+               target.EarliestFinish());
+    uint64_t const linkStart = linkFinish - target.Link;
+    uint64_t const compileStart =
+      std::max(linkStart, target.EarliestStart + target.LongestCompile) -
+      target.LongestCompile;
+    target.Slack = std::min(linkFinish - target.EarliestFinish(),
+                            compileStart - target.EarliestStart);
+    target.Critical = false;
+    auto ls = latestStart.find(*i);
+    uint64_t const orderStart = std::max(
+      std::min(compileStart,
+               ls != latestStart.end() ? ls->second : compileStart),
+      target.EarliestStart);
+    for (std::string const& depName : target.Dependencies) {
+      auto dep = this->Targets.find(depName);
+      if (dep == this->Targets.end()) {
+        continue;
+      }
+      lower(latestFinish, &dep->first, linkStart);
+      if (target.IsCompileDependency(depName)) {
+        lower(latestFinish, &dep->first, orderStart);
+      } else {
+        lower(latestStart, &dep->first, orderStart);
+      }
+    }
+  }
+
+  // Walk back from the link finishing last.  A link waits for the compiles
+  // of its target or for the link of a dependency, and compiles wait for
+  // the link of a compile dependency or for the compiles of another
+  // dependency to start.  Targets are on the critical path when one of
+  // their steps is.
+  this->CriticalPath.clear();
+  enum class Step
+  {
+    Link,
+    Compile,
+    Start,
+  };
+  std::set<std::pair<std::string const*, Step>> visited;
+  Step step = Step::Link;
+  while (last && visited.emplace(last, step).second) {
+    Target& target = this->Targets.at(*last);
+    if (step != Step::Start && !target.Critical) {
+      target.Critical = true;
+      this->CriticalPath.push_back(*last);
+    }
+    std::string const* next = nullptr;
+    Step nextStep = Step::Link;
+    if (step == Step::Link) {
+      bool const afterCompile = target.EarliestLinkStart ==
+        target.EarliestStart + target.LongestCompile;
+      if (target.EarliestLinkStart > 0 &&
+          (!afterCompile || target.LongestCompile == 0)) {
+        for (std::string const& depName : target.Dependencies) {
+          auto dep = this->Targets.find(depName);
+          if (dep != this->Targets.end() &&
+              dep->second.EarliestFinish() == target.EarliestLinkStart) {
+            next = &dep->first;
+            break;
+          }
+        }
+      }
+      if (!next && afterCompile) {
+        next = last;
+        nextStep = Step::Compile;
+      }
+    } else if (target.EarliestStart > 0) {
+      for (std::string const& depName : target.Dependencies) {
+        auto dep = this->Targets.find(depName);
+        if (dep == this->Targets.end()) {
+          continue;
+        }
+        if (target.IsCompileDependency(depName)) {
+          if (dep->second.EarliestFinish() == target.EarliestStart) {
+            next = &dep->first;
+            break;
+          }
+        } else if (dep->second.EarliestStart == target.EarliestStart) {
+          next = &dep->first;
+          nextStep = Step::Start;
+          break;
+        }
+      }
+    }
+    last = next;
+    step = nextStep;
+  }
+  std::reverse(this->CriticalPath.begin(), this->CriticalPath.end());
+}
+
+void cmInstrumentationAnalysis::WriteReport(std::ostream& os) const
+{
+  os << "Critical path: " << Seconds(this->Length) << " through "
+     << this->CriticalPath.size() << " target(s)\n";
+  os << "Total work: " << Seconds(this->TotalWork);
+  if (this->Length > 0) {
+    os << " (average parallelism " << std::fixed << std::setprecision(1)
+       << static_cast<double>(this->TotalWork) /
+        static_cast<double>(this->Length)
+       << ")";
+  }
+  os << "\n";
+  if (!this->HaveGraph) {
+    os << "No target graph was found; targets are assumed independent.\n";
+  }
+
+  os << "\nTargets on the critical path:\n";
+  for (std::string const& name : this->CriticalPath) {
+    Target const& target = this->Targets.at(name);
+    os << "  " << name << ": start " << Seconds(target.EarliestStart)
+       << ", duration " << Seconds(target.Duration()) << "\n";
+  }
+
+  using Entry = std::map<std::string, Target>::value_type;
+  std::vector<Entry const*> bySlack;
+  for (Entry const& entry : this->Targets) {
+    if (entry.second.Commands > 0 && !entry.second.Critical) {
+      bySlack.push_back(&entry);
+    }
+  }
+  std::stable_sort(bySlack.begin(), bySlack.end(),
+                   [](Entry const* l, Entry const* r) {
+                     return l->second.Slack < r->second.Slack;
+                   });
+  if (!bySlack.empty()) {
+    os << "\nOther targets by slack:\n";
+    for (auto const* entry : bySlack) {
+      os << "  " << entry->first << ": slack " << Seconds(entry->second.Slack)
+         << ", duration " << Seconds(entry->second.Duration()) << "\n";
+    }
+  }
+}
+
+Json::Value cmInstrumentationAnalysis::ToJson() const
+{
+  Json::Value root(Json::objectValue);
+  root["version"] = 1;
+  root["length"] = static_cast<Json::Value::UInt64>(this->Length);
+  root["work"] = static_cast<Json::Value::UInt64>(this->TotalWork);
+  Json::Value& path = root["criticalPath"] = Json::arrayValue;
+  for (std::string const& name : this->CriticalPath) {
+    path.append(name);
+  }
+  Json::Value& targets = root["targets"] = Json::objectValue;
+  for (auto const& entry : this->Targets) {
+    Target const& target = entry.second;
+    Json::Value& value = targets[entry.first] = Json::objectValue;
+    value["earliestStart"] =
+      static_cast<Json::Value::UInt64>(target.EarliestStart);
+    value["earliestLinkStart"] =
+      static_cast<Json::Value::UInt64>(target.EarliestLinkStart);
+    value["duration"] = static_cast<Json::Value::UInt64>(target.Duration());
+    value["slack"] = static_cast<Json::Value::UInt64>(target.Slack);
+    value["work"] = static_cast<Json::Value::UInt64>(target.Work);
+    value["critical"] = target.Critical;
+  }
+  return root;
+}
+
+bool cmInstrumentationAnalysis::WriteJson(std::string const& file) const
+{
+  cmsys::ofstream fout(file.c_str(), std::ios::out | std::ios::trunc);
+  if (!fout) {
+    return false;
+  }
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  std::unique_ptr<Json::StreamWriter> jsonWriter(builder.newStreamWriter());
+  jsonWriter->write(this->ToJson(), &fout);
+  fout << '\n';
+  return static_cast<bool>(fout);
+}
@@ -0,0 +1,83 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cm3p/json/value.h>
+
+/** \class cmInstrumentationAnalysis
+ * \brief Critical path analysis of instrumented builds.
+ *
+ * Reads the compile and link snippets listed by an instrumentation index
+ * file and the target dependency graph written during the generate step.
+ * Each target is modeled as its longest compile, which is the duration of
+ * its compiles given enough parallelism, followed by its link.  A compile
+ * starts once the dependencies the generator orders it after are done,
+ * which need not include the links of its dependencies, and a link starts
+ * once the compile and the links of all dependencies are done.  The
+ * analysis then computes the earliest start and the slack of each target
+ * and the chain of targets that bounds the build time.
+ */
+class cmInstrumentationAnalysis
+{
+public:
+  struct Target
+  {
+    std::vector<std::string> Dependencies;
+    // The dependencies whose links the compiles wait for.  The compiles
+    // wait only for the compiles to start of the other dependencies.
+    std::vector<std::string> CompileDependencies;
+    // Milliseconds.
+    uint64_t LongestCompile = 0;
+    uint64_t Link = 0;
+    uint64_t Work = 0;
+    uint64_t Commands = 0;
+    uint64_t EarliestStart = 0;
+    uint64_t EarliestLinkStart = 0;
+    uint64_t Slack = 0;
+    bool Critical = false;
+
+    uint64_t Duration() const { return this->LongestCompile + this->Link; }
+    uint64_t EarliestFinish() const
+    {
+      return this->EarliestLinkStart + this->Link;
+    }
+    bool IsCompileDependency(std::string const& dep) const;
+  };
+
+  /** Read an index file, and the target graph of its build tree.  */
+  bool ReadIndex(std::string const& indexFile, std::string& error);
+
+  /** Compute start times, slack and the critical path.  */
+  void Compute();
+
+  void WriteReport(std::ostream& os) const;
+  Json::Value ToJson() const;
+  bool WriteJson(std::string const& file) const;
+
+  std::map<std::string, Target> const& GetTargets() const
+  {
+    return this->Targets;
+  }
+  std::vector<std::string> const& GetCriticalPath() const
+  {
+    return this->CriticalPath;
+  }
+
+private:
+  bool ReadTargetGraph(std::string const& file, std::string& error);
+  void AddSnippet(Json::Value const& snippet);
+
+  std::map<std::string, Target> Targets;
+  std::vector<std::string> CriticalPath;
+  uint64_t Length = 0;
+  uint64_t TotalWork = 0;
+  bool HaveGraph = false;
+};
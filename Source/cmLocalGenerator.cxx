@@ -95,6 +95,7 @@ cmLocalGenerator::cmLocalGenerator(cmGlobalGenerator* gg, cmMakefile* makefile)
   , DirectoryBacktrace(makefile->GetBacktrace())
 {
   this->GlobalGenerator = gg;
+  this->SetPathTable(&gg->GetPathTable());
 
   this->Makefile = makefile;
 
@@ -3239,6 +3240,85 @@ cmLocalGenerator::AddUnityFilesModeAuto(
   return unity_files;
 }
 
+std::vector<cmLocalGenerator::UnitySource>
+cmLocalGenerator::AddUnityFilesModeCost(
+  cmGeneratorTarget* target, std::string const& lang,
+  std::vector<std::string> const& configs,
+  std::vector<UnityBatchedSource> const& filtered_sources,
+  cmValue beforeInclude, cmValue afterInclude,
+  std::string const& filename_base, UnityPathMode pathMode, size_t batchSize)
+{
+  // Read the cost of each source.  Sources without a valid cost are
+  // assumed to cost the average of the others.
+  std::vector<double> costs;
+  costs.reserve(filtered_sources.size());
+  double known = 0;
+  size_t knownCount = 0;
+  for (UnityBatchedSource const& ubs : filtered_sources) {
+    unsigned long cost;
+    cmValue value = ubs.Source->GetProperty("UNITY_BUILD_COST");
+    if (value && cmStrToULong(*value, &cost)) {
+      costs.push_back(static_cast<double>(cost));
+      known += costs.back();
+      ++knownCount;
+    } else {
+      costs.push_back(-1);
+    }
+  }
+  double const average = knownCount ? known / knownCount : 1;
+  double total = 0;
+  for (double& cost : costs) {
+    if (cost < 0) {
+      cost = average;
+    }
+    total += cost;
+  }
+  if (total <= 0) {
+    return this->AddUnityFilesModeAuto(target, lang, configs, filtered_sources,
+                                       beforeInclude, afterInclude,
+                                       filename_base, pathMode, batchSize);
+  }
+
+  // Use as many unity sources as BATCH mode would.  Split the sources,
+  // in order, where the running cost crosses a multiple of the average
+  // batch cost.  Keeping the order keeps the batches stable when the
+  // cost of a few sources changes.
+  size_t const batches = batchSize
+    ? (filtered_sources.size() + batchSize - 1) / batchSize
+    : 1;
+  std::vector<UnitySource> unity_files;
+  auto begin = filtered_sources.begin();
+  size_t current = 0;
+  double prefix = 0;
+  for (size_t i = 0; i < filtered_sources.size(); ++i) {
+    size_t const target_batch = std::min(
+      batches - 1,
+      static_cast<size_t>((prefix + costs[i] / 2) * batches / total));
+    prefix += costs[i];
+    auto const it = filtered_sources.begin() + i;
+    if (target_batch != current && it != begin) {
+      std::string filename = cmStrCat(filename_base, "unity_",
+                                      unity_files.size(),
+                                      unity_file_extension(lang));
+      unity_files.emplace_back(this->WriteUnitySource(
+        target, configs, cmMakeRange(begin, it), beforeInclude, afterInclude,
+        std::move(filename), filename_base, pathMode));
+      begin = it;
+    }
+    current = target_batch;
+  }
+  if (begin != filtered_sources.end()) {
+    std::string filename = cmStrCat(filename_base, "unity_",
+                                    unity_files.size(),
+                                    unity_file_extension(lang));
+    unity_files.emplace_back(this->WriteUnitySource(
+      target, configs, cmMakeRange(begin, filtered_sources.end()),
+      beforeInclude, afterInclude, std::move(filename), filename_base,
+      pathMode));
+  }
+  return unity_files;
+}
+
 std::vector<cmLocalGenerator::UnitySource>
 cmLocalGenerator::AddUnityFilesModeGroup(
   cmGeneratorTarget* target, std::string const& lang,
@@ -3353,6 +3433,10 @@ void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
       unity_files = AddUnityFilesModeAuto(
         target, lang, configs, filtered_sources, beforeInclude, afterInclude,
         filename_base, pathMode, unityBatchSize);
+    } else if (unityMode && *unityMode == "COST") {
+      unity_files = AddUnityFilesModeCost(
+        target, lang, configs, filtered_sources, beforeInclude, afterInclude,
+        filename_base, pathMode, unityBatchSize);
     } else if (unityMode && *unityMode == "GROUP") {
       unity_files = AddUnityFilesModeGroup(
         target, lang, configs, filtered_sources, beforeInclude, afterInclude,
@@ -3361,7 +3445,7 @@ void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
       // unity mode is set to an unsupported value
       std::string e("Invalid UNITY_BUILD_MODE value of " + *unityMode +
                     " assigned to target " + target->GetName() +
-                    ". Acceptable values are BATCH and GROUP.");
+                    ". Acceptable values are BATCH, COST and GROUP.");
       this->IssueMessage(MessageType::FATAL_ERROR, e);
     }
 
@@ -690,6 +690,13 @@ private:
     cmValue beforeInclude, cmValue afterInclude,
     std::string const& filename_base, UnityPathMode pathMode,
     size_t batchSize);
+  std::vector<UnitySource> AddUnityFilesModeCost(
+    cmGeneratorTarget* target, std::string const& lang,
+    std::vector<std::string> const& configs,
+    std::vector<UnityBatchedSource> const& filtered_sources,
+    cmValue beforeInclude, cmValue afterInclude,
+    std::string const& filename_base, UnityPathMode pathMode,
+    size_t batchSize);
   std::vector<UnitySource> AddUnityFilesModeGroup(
     cmGeneratorTarget* target, std::string const& lang,
     std::vector<std::string> const& configs,
@@ -111,6 +111,11 @@ void cmLocalNinjaGenerator::Generate()
     }
   }
 
+  if (!this->GetGlobalNinjaGenerator()->OpenDirectoryFileStreams(
+        this->HomeRelativeOutputPath)) {
+    return;
+  }
+
   for (auto const& target : this->GetGeneratorTargets()) {
     if (!target->IsInBuildSystem()) {
       continue;
@@ -171,6 +176,8 @@ void cmLocalNinjaGenerator::Generate()
     this->WriteCustomCommandBuildStatements(config);
     this->AdditionalCleanFiles(config);
   }
+
+  this->GetGlobalNinjaGenerator()->CloseDirectoryFileStreams();
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
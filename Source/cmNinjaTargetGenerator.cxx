@@ -1274,8 +1274,20 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatements(
         cmStrCat(l, '/', language, "Modules.json"));
     }
 
-    this->GetGlobalGenerator()->WriteBuild(this->GetImplFileStream(fileConfig),
-                                           build);
+    if (this->GetGlobalGenerator()->IsDyndepBatched()) {
+      cmGlobalNinjaGenerator::DyndepBatchTarget batchTarget;
+      batchTarget.Language = language;
+      batchTarget.TargetDependInfo = this->ConvertToNinjaPath(
+        this->GetTargetDependInfoPath(language, config));
+      batchTarget.ModuleMapFormat = this->Makefile->GetSafeDefinition(
+        cmStrCat("CMAKE_", language, "_MODULE_MAP_FORMAT"));
+      batchTarget.Build = std::move(build);
+      this->GetGlobalGenerator()->AddDyndepBatchTarget(config,
+                                                       std::move(batchTarget));
+    } else {
+      this->GetGlobalGenerator()->WriteBuild(
+        this->GetImplFileStream(fileConfig), build);
+    }
   }
 
   this->GetImplFileStream(fileConfig) << '\n';
@@ -1743,6 +1755,8 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
   if (language == "Swift") {
     this->EmitSwiftDependencyInfo(source, config);
   } else {
+    this->GetGlobalGenerator()->PoolCompileVariables(
+      this->GetImplFileStream(fileConfig), vars);
     this->GetGlobalGenerator()->WriteBuild(this->GetImplFileStream(fileConfig),
                                            objBuild, commandLineLengthLimit);
   }
@@ -1900,6 +1914,8 @@ void cmNinjaTargetGenerator::WriteCxxModuleBmiBuildStatement(
 
   bmiBuild.RspFile = cmStrCat(bmiFileName, ".rsp");
 
+  this->GetGlobalGenerator()->PoolCompileVariables(
+    this->GetImplFileStream(fileConfig), vars);
   this->GetGlobalGenerator()->WriteBuild(this->GetImplFileStream(fileConfig),
                                          bmiBuild, commandLineLengthLimit);
 }
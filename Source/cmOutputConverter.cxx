@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstddef>
 #include <set>
 #include <vector>
 
@@ -14,17 +15,33 @@
 #endif
 
 #include "cmList.h"
+#include "cmPathTable.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmSystemTools.h"
 #include "cmValue.h"
 
 namespace {
+// Shorter paths are converted without the shared path table.
+std::size_t const MinSharedOutputFormatLength = 32;
+
 bool PathEqOrSubDir(std::string const& a, std::string const& b)
 {
   return (cmSystemTools::ComparePath(a, b) ||
           cmSystemTools::IsSubDirectory(a, b));
 }
+
+bool IsFullPath(cm::string_view path)
+{
+#if defined(_WIN32) || defined(__CYGWIN__)
+  if (path.size() >= 2 && path[1] == ':') {
+    return true;
+  }
+  return !path.empty() && (path[0] == '/' || path[0] == '\\');
+#else
+  return !path.empty() && path[0] == '/';
+#endif
+}
 }
 
 cmOutputConverter::cmOutputConverter(cmStateSnapshot const& snapshot)
@@ -101,6 +118,22 @@ void cmOutputConverter::SetRelativePathTop(std::string const& topSource,
   this->RelativePathTopSource = topSource;
   this->RelativePathTopBinary = topBinary;
   this->ComputeRelativePathTopRelation();
+  this->ComputePathTableRelative();
+}
+
+void cmOutputConverter::SetPathTable(cmPathTable* table)
+{
+  this->PathTable = table;
+  this->ComputePathTableRelative();
+}
+
+void cmOutputConverter::ComputePathTableRelative()
+{
+  // Conversions relative to the top of the build tree are the same for
+  // every converter whose relative path tops are those of the project.
+  this->PathTableRelative = this->PathTable &&
+    this->RelativePathTopSource == this->GetState()->GetSourceDirectory() &&
+    this->RelativePathTopBinary == this->GetState()->GetBinaryDirectory();
 }
 
 std::string cmOutputConverter::MaybeRelativeTo(
@@ -143,6 +176,14 @@ std::string cmOutputConverter::MaybeRelativeTo(
 std::string cmOutputConverter::MaybeRelativeToTopBinDir(
   std::string const& path) const
 {
+  if (this->PathTableRelative) {
+    return this->PathTable->GetForm(
+      path, cmPathTable::Form::RelativeToTopBinary,
+      [this](std::string const& p) {
+        return this->MaybeRelativeTo(this->GetState()->GetBinaryDirectory(),
+                                     p);
+      });
+  }
   return this->MaybeRelativeTo(this->GetState()->GetBinaryDirectory(), path);
 }
 
@@ -197,6 +238,25 @@ std::string cmOutputConverter::ConvertToOutputForExisting(
 std::string cmOutputConverter::ConvertToOutputFormat(cm::string_view source,
                                                      OutputFormat format,
                                                      bool useWatcomQuote) const
+{
+  // Full paths are converted over and over, so share their conversions.
+  // Short paths are converted faster than they are looked up.  The link
+  // script shell mode is specific to this converter.
+  if (this->PathTable && !this->LinkScriptShell &&
+      source.size() >= MinSharedOutputFormatLength && IsFullPath(source)) {
+    auto const form = static_cast<cmPathTable::Form>(
+      static_cast<int>(cmPathTable::Form::Shell) + format * 2 +
+      (useWatcomQuote ? 1 : 0));
+    return this->PathTable->GetForm(
+      source, form, [this, format, useWatcomQuote](std::string const& p) {
+        return this->ConvertToOutputFormatImpl(p, format, useWatcomQuote);
+      });
+  }
+  return this->ConvertToOutputFormatImpl(source, format, useWatcomQuote);
+}
+
+std::string cmOutputConverter::ConvertToOutputFormatImpl(
+  cm::string_view source, OutputFormat format, bool useWatcomQuote) const
 {
   std::string result(source);
   // Convert it to an output path.
@@ -10,6 +10,7 @@
 
 #include "cmStateSnapshot.h"
 
+class cmPathTable;
 class cmState;
 
 class cmOutputConverter
@@ -144,6 +145,13 @@ public:
 protected:
   cmStateSnapshot StateSnapshot;
 
+  /**
+   * Share converted paths through the given table.  Only paths whose
+   * conversion does not depend on this converter's own settings are
+   * cached there.
+   */
+  void SetPathTable(cmPathTable* table);
+
 private:
   cmState* GetState() const;
 
@@ -155,6 +163,11 @@ private:
 
   bool LinkScriptShell = false;
 
+  cmPathTable* PathTable = nullptr;
+  // Whether relative path conversions may be shared through PathTable.
+  bool PathTableRelative = false;
+  void ComputePathTableRelative();
+
   // The top-most directories for relative path conversion.  Both the
   // source and destination location of a relative path conversion
   // must be underneath one of these directories (both under source or
@@ -175,4 +188,7 @@ private:
   void ComputeRelativePathTopRelation();
   std::string MaybeRelativeTo(std::string const& local_path,
                               std::string const& remote_path) const;
+  std::string ConvertToOutputFormatImpl(cm::string_view source,
+                                        OutputFormat output,
+                                        bool useWatcomQuote) const;
 };
@@ -0,0 +1,62 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmPathTable.h"
+
+#include <utility>
+
+#include <cm/memory>
+
+cmPathTable::~cmPathTable() = default;
+
+cmPathTable::Entry::~Entry()
+{
+  for (auto& form : this->Forms) {
+    delete form.load(std::memory_order_relaxed);
+  }
+}
+
+cmPathTable::Entry const& cmPathTable::Intern(cm::string_view path)
+{
+  Shard& shard =
+    this->Shards[std::hash<cm::string_view>()(path) % ShardCount];
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+  auto it = shard.Entries.find(path);
+  if (it == shard.Entries.end()) {
+    auto entry = cm::make_unique<Entry>(path);
+    cm::string_view const key = entry->GetPath();
+    it = shard.Entries.emplace(key, std::move(entry)).first;
+  }
+  return *it->second;
+}
+
+std::string const& cmPathTable::StoreForm(
+  std::atomic<std::string const*>& slot, std::string value)
+{
+  std::unique_ptr<std::string const> computed =
+    cm::make_unique<std::string const>(std::move(value));
+  std::string const* expected = nullptr;
+  if (slot.compare_exchange_strong(expected, computed.get(),
+                                   std::memory_order_acq_rel,
+                                   std::memory_order_acquire)) {
+    return *computed.release();
+  }
+  // Another thread stored the form first.
+  return *expected;
+}
+
+std::size_t cmPathTable::Size() const
+{
+  std::size_t size = 0;
+  for (Shard const& shard : this->Shards) {
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    size += shard.Entries.size();
+  }
+  return size;
+}
+
+void cmPathTable::Clear()
+{
+  for (Shard& shard : this->Shards) {
+    shard.Entries.clear();
+  }
+}
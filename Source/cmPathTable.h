@@ -0,0 +1,128 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <cm/string_view>
+
+/** \class cmPathTable
+ * \brief Table of interned paths and their converted forms.
+ *
+ * Each distinct path is stored once.  The converted forms of a path are
+ * computed on first request and shared by all later requests.  Paths are
+ * interned as given, so callers should pass normalized paths.
+ *
+ * The table may be used from several threads at once.  Interning a path
+ * locks one of a fixed number of shards selected by the path's hash.
+ * Reading a form that has already been computed does not lock.
+ */
+class cmPathTable
+{
+public:
+  /** Converted forms cached for each path.  */
+  enum class Form
+  {
+    // Relative to the top of the build tree, if possible.
+    RelativeToTopBinary,
+    // Path as written to Ninja manifests.
+    Ninja,
+    // Converted by cmOutputConverter::ConvertToOutputFormat, in the order
+    // of its OutputFormat enumeration, without and with Watcom quoting.
+    Shell,
+    ShellWatcom,
+    NinjaMulti,
+    NinjaMultiWatcom,
+    Response,
+    ResponseWatcom,
+
+    Count
+  };
+
+  class Entry;
+
+  cmPathTable() = default;
+  ~cmPathTable();
+
+  cmPathTable(cmPathTable const&) = delete;
+  cmPathTable& operator=(cmPathTable const&) = delete;
+
+  /** Return the entry of the given path, adding it if needed.  The entry
+      stays valid until the table is cleared or destroyed.  */
+  Entry const& Intern(cm::string_view path);
+
+  /** Return the given form of a path.  If the form has not been computed
+      yet, @a compute is called with the path to produce it.  If several
+      threads compute the same form concurrently, the first result stored
+      wins and the others are discarded.  */
+  template <typename Compute>
+  std::string const& GetForm(Entry const& entry, Form form,
+                             Compute const& compute)
+  {
+    std::atomic<std::string const*>& slot =
+      entry.Forms[static_cast<std::size_t>(form)];
+    if (std::string const* value = slot.load(std::memory_order_acquire)) {
+      return *value;
+    }
+    return StoreForm(slot, compute(entry.Path));
+  }
+  template <typename Compute>
+  std::string const& GetForm(cm::string_view path, Form form,
+                             Compute const& compute)
+  {
+    return this->GetForm(this->Intern(path), form, compute);
+  }
+
+  /** Number of interned paths.  */
+  std::size_t Size() const;
+
+  /** Drop all interned paths.  Must not be called concurrently with any
+      other member.  */
+  void Clear();
+
+  class Entry
+  {
+  public:
+    Entry(cm::string_view path)
+      : Path(path)
+    {
+    }
+    ~Entry();
+
+    Entry(Entry const&) = delete;
+    Entry& operator=(Entry const&) = delete;
+
+    std::string const& GetPath() const { return this->Path; }
+
+  private:
+    friend class cmPathTable;
+
+    std::string const Path;
+    mutable std::array<std::atomic<std::string const*>,
+                       static_cast<std::size_t>(Form::Count)>
+      Forms{};
+  };
+
+private:
+  static constexpr std::size_t ShardCount = 16;
+
+  static std::string const& StoreForm(std::atomic<std::string const*>& slot,
+                                      std::string value);
+
+  struct Shard
+  {
+    mutable std::mutex Mutex;
+    // Keys view the path owned by the mapped entry.
+    std::unordered_map<cm::string_view, std::unique_ptr<Entry>> Entries;
+  };
+
+  std::array<Shard, ShardCount> Shards;
+};
@@ -524,6 +524,8 @@ bool cmQtAutoGenInitializer::InitCustomTargets()
                    "\" is not valid. Using AUTOGEN_PARALLEL=1"));
         this->AutogenTarget.Parallel = 1;
       }
+      this->AutogenTarget.UseJobServer =
+        this->GenTarget->GetPropertyAsBool("AUTOGEN_USE_JOBSERVER");
     }
 
 #ifdef _WIN32
@@ -573,6 +575,21 @@ bool cmQtAutoGenInitializer::InitCustomTargets()
       this->ConfigFileNames(this->AutogenTarget.ParseCacheFile,
                             cmStrCat(this->Dir.Info, "/ParseCache"), ".txt");
       this->ConfigFileClean(this->AutogenTarget.ParseCacheFile);
+
+      // Content hash file
+      if (this->GenTarget->GetPropertyAsBool("AUTOGEN_CONTENT_HASH")) {
+        this->ConfigFileNames(this->AutogenTarget.ContentHashFile,
+                              cmStrCat(this->Dir.Info, "/ContentHashes"),
+                              ".txt");
+        this->ConfigFileClean(this->AutogenTarget.ContentHashFile);
+      }
+
+      // Parse results shared by all targets of the build tree
+      if (this->GenTarget->GetPropertyAsBool("AUTOGEN_SHARED_PARSE_CACHE")) {
+        this->AutogenTarget.SharedParseCacheDir =
+          cmStrCat(this->Makefile->GetHomeOutputDirectory(),
+                   "/CMakeFiles/AutogenParseCache");
+      }
     }
 
     // Autogen target: Compute user defined dependencies
@@ -1573,6 +1590,7 @@ bool cmQtAutoGenInitializer::InitAutogenTarget()
       cc->SetEscapeOldStyle(false);
       cc->SetDepfile(depFile);
       cc->SetStdPipesUTF8(stdPipesUTF8);
+      cc->SetJobserverAware(this->AutogenTarget.UseJobServer);
       this->LocalGen->AddCustomCommandToOutput(std::move(cc));
       dependencies.clear();
       dependencies.emplace_back(std::move(outputFile));
@@ -1588,6 +1606,7 @@ bool cmQtAutoGenInitializer::InitAutogenTarget()
     cc->SetCommandLines(commandLines);
     cc->SetEscapeOldStyle(false);
     cc->SetComment(autogenComment.c_str());
+    cc->SetJobserverAware(this->AutogenTarget.UseJobServer);
     cmTarget* autogenTarget = this->LocalGen->AddUtilityCommand(
       this->AutogenTarget.Name, true, std::move(cc));
     // Create autogen generator target
@@ -1852,6 +1871,7 @@ bool cmQtAutoGenInitializer::SetupWriteAutogenInfo()
   info.SetBool("CROSS_CONFIG", this->CrossConfig);
   info.SetBool("USE_BETTER_GRAPH", this->UseBetterGraph);
   info.SetUInt("PARALLEL", this->AutogenTarget.Parallel);
+  info.SetBool("USE_JOBSERVER", this->AutogenTarget.UseJobServer);
 #ifdef _WIN32
   info.SetUInt("AUTOGEN_COMMAND_LINE_LENGTH_MAX",
                this->AutogenTarget.MaxCommandLineLength);
@@ -1874,6 +1894,8 @@ bool cmQtAutoGenInitializer::SetupWriteAutogenInfo()
   info.Set("CMAKE_EXECUTABLE", cmSystemTools::GetCMakeCommand());
   info.SetConfig("SETTINGS_FILE", this->AutogenTarget.SettingsFile);
   info.SetConfig("PARSE_CACHE_FILE", this->AutogenTarget.ParseCacheFile);
+  info.SetConfig("CONTENT_HASH_FILE", this->AutogenTarget.ContentHashFile);
+  info.Set("SHARED_PARSE_CACHE_DIR", this->AutogenTarget.SharedParseCacheDir);
   info.SetConfig("DEP_FILE", this->AutogenTarget.DepFile);
   info.SetConfig("DEP_FILE_RULE_NAME", this->AutogenTarget.DepFileRuleName);
   info.SetArray("CMAKE_LIST_FILES", this->Makefile->GetListFiles());
@@ -186,12 +186,15 @@ private:
     bool GlobalTarget = false;
     // Settings
     unsigned int Parallel = 1;
+    bool UseJobServer = false;
     unsigned int MaxCommandLineLength =
       std::numeric_limits<unsigned int>::max();
     // Configuration files
     std::string InfoFile;
     ConfigString SettingsFile;
     ConfigString ParseCacheFile;
+    ConfigString ContentHashFile;
+    std::string SharedParseCacheDir;
     // Dependencies
     bool DependOrigin = false;
     std::set<std::string> DependFiles;
@@ -5,8 +5,12 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdlib>
+#include <ctime>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <ostream>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -21,6 +25,7 @@
 
 #include <cm3p/json/value.h>
 
+#include "cmsys/Directory.hxx"
 #include "cmsys/FStream.hxx"
 #include "cmsys/RegularExpression.hxx"
 
@@ -33,6 +38,7 @@
 #include "cmQtAutoGenerator.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmVersion.h"
 #include "cmWorkerPool.h"
 
 #if defined(__APPLE__)
@@ -91,6 +97,8 @@ public:
     struct FileT
     {
       void Clear();
+      void ReadLine(std::string const& line);
+      void Write(std::ostream& os) const;
 
       struct MocT
       {
@@ -125,6 +133,32 @@ public:
     std::unordered_map<std::string, FileHandleT> Map_;
   };
 
+  /** Content digests of the inputs of generated files.  */
+  class ContentHashesT
+  {
+  public:
+    /** Entry of the content digest store.  */
+    struct EntryT
+    {
+      std::string Hash;
+      cmFileTime::TimeType OutputTime = 0;
+    };
+
+    bool ReadFromFile(std::string const& fileName);
+    bool WriteToFile(std::string const& fileName) const;
+
+    bool Changed() const { return this->Changed_; }
+    bool Matches(std::string const& outputFile, std::string const& hash,
+                 cmFileTime const& outputTime) const;
+    void Set(std::string const& outputFile, std::string hash,
+             cmFileTime const& outputTime);
+
+  private:
+    mutable std::mutex Mutex_;
+    std::unordered_map<std::string, EntryT> Map_;
+    bool Changed_ = false;
+  };
+
   /** Source file data.  */
   class SourceFileT
   {
@@ -152,6 +186,8 @@ public:
     std::string OutputFile;
     std::string IncludeString;
     std::vector<SourceFileHandleT> IncluderFiles;
+    // Digest of the generator inputs, computed only in content hash mode
+    std::string ContentHash;
   };
   using MappingHandleT = std::shared_ptr<MappingT>;
   using MappingMapT = std::map<std::string, MappingHandleT>;
@@ -174,6 +210,7 @@ public:
     bool UseBetterGraph = false;
     IntegerVersion QtVersion = { 4, 0 };
     unsigned int ThreadCount = 0;
+    bool UseJobServer = false;
     unsigned int MaxCommandLineLength =
       std::numeric_limits<unsigned int>::max();
     // - Directories
@@ -183,6 +220,9 @@ public:
     std::string CMakeExecutable;
     cmFileTime CMakeExecutableTime;
     std::string ParseCacheFile;
+    std::string ContentHashFile;
+    std::string SharedParseCacheDir;
+    std::string ParseSettings;
     std::string DepFile;
     std::string DepFileRuleName;
     std::vector<std::string> HeaderExtensions;
@@ -198,6 +238,9 @@ public:
     cmFileTime ParseCacheTime;
     ParseCacheT ParseCache;
 
+    // -- Content hashes
+    ContentHashesT ContentHashes;
+
     // -- Sources
     SourceFileMapT Headers;
     SourceFileMapT Sources;
@@ -246,6 +289,7 @@ public:
   public:
     // -- predefines file
     cmFileTime PredefsTime;
+    std::string PredefsHash;
     // -- Mappings
     MappingMapT HeaderMappings;
     MappingMapT SourceMappings;
@@ -386,9 +430,12 @@ public:
     void MocDependencies();
     void MocIncludes();
     void UicIncludes();
+    bool SharedCacheRead();
+    void SharedCacheWrite() const;
 
     SourceFileHandleT FileHandle;
     std::string Content;
+    std::string SharedCacheFile;
   };
 
   /** Header file parse job.  */
@@ -454,6 +501,10 @@ public:
   /** Dependency probing base job.  */
   class JobProbeDepsT : public JobT
   {
+  protected:
+    bool ContentUnchanged(MappingT& mapping,
+                          cmFileTime const& outputFileTime) const;
+    virtual std::string ContentHash(MappingT& mapping) const = 0;
   };
 
   /** Probes file dependencies and generates moc compile jobs.  */
@@ -461,7 +512,8 @@ public:
   {
     void Process() override;
     bool Generate(MappingHandleT const& mapping, bool compFile) const;
-    bool Probe(MappingT const& mapping, std::string* reason) const;
+    bool Probe(MappingT& mapping, std::string* reason) const;
+    std::string ContentHash(MappingT& mapping) const override;
     std::pair<std::string, cmFileTime> FindDependency(
       std::string const& sourceDir, std::string const& includeString) const;
   };
@@ -470,7 +522,8 @@ public:
   class JobProbeDepsUicT : public JobProbeDepsT
   {
     void Process() override;
-    bool Probe(MappingT const& mapping, std::string* reason) const;
+    bool Probe(MappingT& mapping, std::string* reason) const;
+    std::string ContentHash(MappingT& mapping) const override;
   };
 
   /** Dependency probing finish job.  */
@@ -490,6 +543,8 @@ public:
     }
 
   protected:
+    void RecordContentHash() const;
+
     MappingHandleT Mapping;
     std::unique_ptr<std::string> Reason;
   };
@@ -570,6 +625,11 @@ private:
   // -- Parse cache
   void ParseCacheRead();
   bool ParseCacheWrite();
+  // -- Content hashes
+  void ContentHashesRead();
+  bool ContentHashesWrite();
+  // -- Shared parse cache
+  void SharedParseCachePrune() const;
   // -- Thread processing
   void Abort(bool error);
   // -- Generation
@@ -615,6 +675,51 @@ void cmQtAutoMocUicT::ParseCacheT::FileT::Clear()
   this->Uic.Depends.clear();
 }
 
+void cmQtAutoMocUicT::ParseCacheT::FileT::ReadLine(std::string const& line)
+{
+  if (line.size() < 6) {
+    return;
+  }
+
+  constexpr std::size_t offset = 5;
+  if (cmHasLiteralPrefix(line, " mmc:")) {
+    this->Moc.Macro = line.substr(offset);
+  } else if (cmHasLiteralPrefix(line, " miu:")) {
+    this->Moc.Include.Underscore.emplace_back(line.substr(offset),
+                                              MocUnderscoreLength);
+  } else if (cmHasLiteralPrefix(line, " mid:")) {
+    this->Moc.Include.Dot.emplace_back(line.substr(offset), 0);
+  } else if (cmHasLiteralPrefix(line, " mdp:")) {
+    this->Moc.Depends.emplace_back(line.substr(offset));
+  } else if (cmHasLiteralPrefix(line, " uic:")) {
+    this->Uic.Include.emplace_back(line.substr(offset), UiUnderscoreLength);
+  } else if (cmHasLiteralPrefix(line, " udp:")) {
+    this->Uic.Depends.emplace_back(line.substr(offset));
+  }
+}
+
+void cmQtAutoMocUicT::ParseCacheT::FileT::Write(std::ostream& os) const
+{
+  if (!this->Moc.Macro.empty()) {
+    os << " mmc:" << this->Moc.Macro << '\n';
+  }
+  for (IncludeKeyT const& item : this->Moc.Include.Underscore) {
+    os << " miu:" << item.Key << '\n';
+  }
+  for (IncludeKeyT const& item : this->Moc.Include.Dot) {
+    os << " mid:" << item.Key << '\n';
+  }
+  for (std::string const& item : this->Moc.Depends) {
+    os << " mdp:" << item << '\n';
+  }
+  for (IncludeKeyT const& item : this->Uic.Include) {
+    os << " uic:" << item.Key << '\n';
+  }
+  for (std::string const& item : this->Uic.Depends) {
+    os << " udp:" << item << '\n';
+  }
+}
+
 cmQtAutoMocUicT::ParseCacheT::GetOrInsertT
 cmQtAutoMocUicT::ParseCacheT::GetOrInsert(std::string const& fileName)
 {
@@ -662,74 +767,103 @@ bool cmQtAutoMocUicT::ParseCacheT::ReadFromFile(std::string const& fileName)
       continue;
     }
 
-    // Bad line or bad file handle
-    if (!fileHandle || (line.size() < 6)) {
-      continue;
+    // Skip lines without file handle
+    if (fileHandle) {
+      fileHandle->ReadLine(line);
     }
+  }
+  return true;
+}
 
-    constexpr std::size_t offset = 5;
-    if (cmHasLiteralPrefix(line, " mmc:")) {
-      fileHandle->Moc.Macro = line.substr(offset);
-      continue;
-    }
-    if (cmHasLiteralPrefix(line, " miu:")) {
-      fileHandle->Moc.Include.Underscore.emplace_back(line.substr(offset),
-                                                      MocUnderscoreLength);
-      continue;
-    }
-    if (cmHasLiteralPrefix(line, " mid:")) {
-      fileHandle->Moc.Include.Dot.emplace_back(line.substr(offset), 0);
+bool cmQtAutoMocUicT::ParseCacheT::WriteToFile(std::string const& fileName)
+{
+  cmGeneratedFileStream ofs(fileName);
+  if (!ofs) {
+    return false;
+  }
+  ofs << "# Generated by CMake. Changes will be overwritten.\n";
+  for (auto const& pair : this->Map_) {
+    ofs << pair.first << '\n';
+    pair.second->Write(ofs);
+  }
+  return ofs.Close();
+}
+
+bool cmQtAutoMocUicT::ContentHashesT::ReadFromFile(
+  std::string const& fileName)
+{
+  cmsys::ifstream fin(fileName.c_str());
+  if (!fin) {
+    return false;
+  }
+
+  // Each line holds the digest, the output file time and the output file
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (line.empty() || line.front() == '#') {
       continue;
     }
-    if (cmHasLiteralPrefix(line, " mdp:")) {
-      fileHandle->Moc.Depends.emplace_back(line.substr(offset));
-      continue;
+    if (line.back() == '\r') {
+      line.pop_back();
     }
-    if (cmHasLiteralPrefix(line, " uic:")) {
-      fileHandle->Uic.Include.emplace_back(line.substr(offset),
-                                           UiUnderscoreLength);
+    std::string::size_type const hashEnd = line.find(' ');
+    if (hashEnd == std::string::npos) {
       continue;
     }
-    if (cmHasLiteralPrefix(line, " udp:")) {
-      fileHandle->Uic.Depends.emplace_back(line.substr(offset));
+    std::string::size_type const timeEnd = line.find(' ', hashEnd + 1);
+    if (timeEnd == std::string::npos || timeEnd + 1 == line.size()) {
       continue;
     }
+    EntryT& entry = this->Map_[line.substr(timeEnd + 1)];
+    entry.Hash = line.substr(0, hashEnd);
+    entry.OutputTime = std::strtoll(line.c_str() + hashEnd + 1, nullptr, 10);
   }
   return true;
 }
 
-bool cmQtAutoMocUicT::ParseCacheT::WriteToFile(std::string const& fileName)
+bool cmQtAutoMocUicT::ContentHashesT::WriteToFile(
+  std::string const& fileName) const
 {
   cmGeneratedFileStream ofs(fileName);
   if (!ofs) {
     return false;
   }
   ofs << "# Generated by CMake. Changes will be overwritten.\n";
+  std::lock_guard<std::mutex> lock(this->Mutex_);
   for (auto const& pair : this->Map_) {
-    ofs << pair.first << '\n';
-    FileT const& file = *pair.second;
-    if (!file.Moc.Macro.empty()) {
-      ofs << " mmc:" << file.Moc.Macro << '\n';
-    }
-    for (IncludeKeyT const& item : file.Moc.Include.Underscore) {
-      ofs << " miu:" << item.Key << '\n';
-    }
-    for (IncludeKeyT const& item : file.Moc.Include.Dot) {
-      ofs << " mid:" << item.Key << '\n';
-    }
-    for (std::string const& item : file.Moc.Depends) {
-      ofs << " mdp:" << item << '\n';
-    }
-    for (IncludeKeyT const& item : file.Uic.Include) {
-      ofs << " uic:" << item.Key << '\n';
-    }
-    for (std::string const& item : file.Uic.Depends) {
-      ofs << " udp:" << item << '\n';
+    // Drop the digests of outputs that no longer exist, so that the file
+    // does not keep growing as sources are removed from the target.
+    if (!cmSystemTools::FileExists(pair.first, true)) {
+      continue;
     }
+    ofs << pair.second.Hash << ' ' << pair.second.OutputTime << ' '
+        << pair.first << '\n';
   }
   return ofs.Close();
 }
 
+bool cmQtAutoMocUicT::ContentHashesT::Matches(
+  std::string const& outputFile, std::string const& hash,
+  cmFileTime const& outputTime) const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex_);
+  auto it = this->Map_.find(outputFile);
+  // The output must not have been written since the digest was recorded.
+  return it != this->Map_.end() && !hash.empty() &&
+    it->second.Hash == hash && it->second.OutputTime == outputTime.GetTime();
+}
+
+void cmQtAutoMocUicT::ContentHashesT::Set(std::string const& outputFile,
+                                          std::string hash,
+                                          cmFileTime const& outputTime)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex_);
+  EntryT& entry = this->Map_[outputFile];
+  entry.Hash = std::move(hash);
+  entry.OutputTime = outputTime.GetTime();
+  this->Changed_ = true;
+}
+
 cmQtAutoMocUicT::BaseSettingsT::BaseSettingsT() = default;
 cmQtAutoMocUicT::BaseSettingsT::~BaseSettingsT() = default;
 
@@ -1127,11 +1261,76 @@ void cmQtAutoMocUicT::JobParseT::UicIncludes()
                    UiUnderscoreLength);
 }
 
+bool cmQtAutoMocUicT::JobParseT::SharedCacheRead()
+{
+  std::string const& cacheDir = this->BaseConst().SharedParseCacheDir;
+  if (cacheDir.empty()) {
+    return false;
+  }
+
+  // The parse result depends only on the file content, the parse settings
+  // and on what is parsed in the file.
+  {
+    SourceFileT const& sourceFile = *this->FileHandle;
+    cmCryptoHash cryptoHash(cmCryptoHash::AlgoSHA256);
+    cryptoHash.Initialize();
+    cryptoHash.Append(cmVersion::GetCMakeVersion());
+    cryptoHash.Append(this->BaseConst().ParseSettings);
+    cryptoHash.Append(cmStrCat(sourceFile.IsHeader ? 'h' : 's',
+                               sourceFile.Moc ? 'm' : '-',
+                               sourceFile.Uic ? 'u' : '-', ';'));
+    cryptoHash.Append(this->Content);
+    this->SharedCacheFile =
+      cmStrCat(cacheDir, '/', cryptoHash.FinalizeHex(), ".txt");
+  }
+
+  cmsys::ifstream fin(this->SharedCacheFile.c_str());
+  if (!fin) {
+    return false;
+  }
+  if (this->Log().Verbose()) {
+    this->Log().Info(
+      GenT::GEN,
+      cmStrCat("Reusing the shared parse result of ",
+               this->MessagePath(this->FileHandle->FileName)));
+  }
+  // Mark the entry as used so that pruning keeps it
+  cmSystemTools::Touch(this->SharedCacheFile, false);
+  ParseCacheT::FileT& parseData = *this->FileHandle->ParseData;
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    parseData.ReadLine(line);
+  }
+  return true;
+}
+
+void cmQtAutoMocUicT::JobParseT::SharedCacheWrite() const
+{
+  if (this->SharedCacheFile.empty()) {
+    return;
+  }
+  // Other autogen steps may write the same entry concurrently.  The stream
+  // writes to a temporary file and renames it, so readers never see a
+  // partial entry.  Failing to store the entry is not an error.
+  cmGeneratedFileStream ofs(this->SharedCacheFile);
+  if (ofs) {
+    ofs << "# Generated by CMake. Changes will be overwritten.\n";
+    this->FileHandle->ParseData->Write(ofs);
+    ofs.Close();
+  }
+}
+
 void cmQtAutoMocUicT::JobParseHeaderT::Process()
 {
   if (!this->ReadFile()) {
     return;
   }
+  if (this->SharedCacheRead()) {
+    return;
+  }
   // Moc parsing
   if (this->FileHandle->Moc) {
     this->MocMacro();
@@ -1141,6 +1340,7 @@ void cmQtAutoMocUicT::JobParseHeaderT::Process()
   if (this->FileHandle->Uic) {
     this->UicIncludes();
   }
+  this->SharedCacheWrite();
 }
 
 void cmQtAutoMocUicT::JobParseSourceT::Process()
@@ -1148,6 +1348,9 @@ void cmQtAutoMocUicT::JobParseSourceT::Process()
   if (!this->ReadFile()) {
     return;
   }
+  if (this->SharedCacheRead()) {
+    return;
+  }
   // Moc parsing
   if (this->FileHandle->Moc) {
     this->MocMacro();
@@ -1158,6 +1361,7 @@ void cmQtAutoMocUicT::JobParseSourceT::Process()
   if (this->FileHandle->Uic) {
     this->UicIncludes();
   }
+  this->SharedCacheWrite();
 }
 
 std::string cmQtAutoMocUicT::JobEvalCacheT::MessageSearchLocations() const
@@ -1741,6 +1945,23 @@ void cmQtAutoMocUicT::JobEvalCacheFinishT::Process()
   }
 }
 
+bool cmQtAutoMocUicT::JobProbeDepsT::ContentUnchanged(
+  MappingT& mapping, cmFileTime const& outputFileTime) const
+{
+  mapping.ContentHash = this->ContentHash(mapping);
+  if (!this->BaseEval().ContentHashes.Matches(
+        mapping.OutputFile, mapping.ContentHash, outputFileTime)) {
+    return false;
+  }
+  if (this->Log().Verbose()) {
+    this->Log().Info(
+      GenT::GEN,
+      cmStrCat("Skipping ", this->MessagePath(mapping.OutputFile),
+               ", because the content of its inputs did not change."));
+  }
+  return true;
+}
+
 void cmQtAutoMocUicT::JobProbeDepsMocT::Process()
 {
   // Create moc header jobs
@@ -1772,6 +1993,11 @@ bool cmQtAutoMocUicT::JobProbeDepsMocT::Generate(MappingHandleT const& mapping,
     reason = cm::make_unique<std::string>();
   }
   if (this->Probe(*mapping, reason.get())) {
+    // Hash the inputs to record them once the output was generated
+    if (!this->BaseConst().ContentHashFile.empty() &&
+        mapping->ContentHash.empty()) {
+      mapping->ContentHash = this->ContentHash(*mapping);
+    }
     // Register the parent directory for creation
     this->MocEval().OutputDirs.emplace(
       cmQtAutoGen::ParentDir(mapping->OutputFile));
@@ -1790,7 +2016,7 @@ bool cmQtAutoMocUicT::JobProbeDepsMocT::Generate(MappingHandleT const& mapping,
   return true;
 }
 
-bool cmQtAutoMocUicT::JobProbeDepsMocT::Probe(MappingT const& mapping,
+bool cmQtAutoMocUicT::JobProbeDepsMocT::Probe(MappingT& mapping,
                                               std::string* reason) const
 {
   std::string const& sourceFile = mapping.SourceFile->FileName;
@@ -1817,6 +2043,21 @@ bool cmQtAutoMocUicT::JobProbeDepsMocT::Probe(MappingT const& mapping,
     return true;
   }
 
+  // Test if the moc executable is newer
+  if (outputFileTime.Older(this->MocConst().ExecutableTime)) {
+    if (reason) {
+      *reason = cmStrCat("Generating ", this->MessagePath(outputFile),
+                         ", because it's older than the moc executable, from ",
+                         this->MessagePath(sourceFile));
+    }
+    return true;
+  }
+
+  // The remaining tests compare the time stamps of the inputs whose content
+  // is covered by the content hash.
+  bool const contentHash = !this->BaseConst().ContentHashFile.empty();
+  bool newer = false;
+
   // Test if the source file is newer
   if (outputFileTime.Older(mapping.SourceFile->FileTime)) {
     if (reason) {
@@ -1824,11 +2065,11 @@ bool cmQtAutoMocUicT::JobProbeDepsMocT::Probe(MappingT const& mapping,
                          ", because it's older than its source file, from ",
                          this->MessagePath(sourceFile));
     }
-    return true;
+    newer = true;
   }
 
   // Test if the moc_predefs file is newer
-  if (!this->MocConst().PredefsFileAbs.empty()) {
+  if (!newer && !this->MocConst().PredefsFileAbs.empty()) {
     if (outputFileTime.Older(this->MocEval().PredefsTime)) {
       if (reason) {
         *reason = cmStrCat("Generating ", this->MessagePath(outputFile),
@@ -1836,22 +2077,12 @@ bool cmQtAutoMocUicT::JobProbeDepsMocT::Probe(MappingT const& mapping,
                            this->MessagePath(this->MocConst().PredefsFileAbs),
                            ", from ", this->MessagePath(sourceFile));
       }
-      return true;
+      newer = true;
     }
   }
 
-  // Test if the moc executable is newer
-  if (outputFileTime.Older(this->MocConst().ExecutableTime)) {
-    if (reason) {
-      *reason = cmStrCat("Generating ", this->MessagePath(outputFile),
-                         ", because it's older than the moc executable, from ",
-                         this->MessagePath(sourceFile));
-    }
-    return true;
-  }
-
   // Test if a dependency file is newer
-  {
+  if (!newer) {
     // Check dependency timestamps
     std::string const sourceDir = SubDirPrefix(sourceFile);
     auto& dependencies = mapping.SourceFile->ParseData->Moc.Depends;
@@ -1880,12 +2111,59 @@ bool cmQtAutoMocUicT::JobProbeDepsMocT::Probe(MappingT const& mapping,
                              this->MessagePath(depMatch.first), ", from ",
                              this->MessagePath(sourceFile));
         }
-        return true;
+        newer = true;
+        break;
       }
     }
   }
 
-  return false;
+  if (newer && contentHash &&
+      this->ContentUnchanged(mapping, outputFileTime)) {
+    return false;
+  }
+  return newer;
+}
+
+std::string cmQtAutoMocUicT::JobProbeDepsMocT::ContentHash(
+  MappingT& mapping) const
+{
+  cmCryptoHash cryptoHash(cmCryptoHash::AlgoSHA256);
+  cryptoHash.Initialize();
+  auto hashFile = [&cryptoHash](std::string const& fileName) -> bool {
+    std::string const fileHash =
+      cmCryptoHash(cmCryptoHash::AlgoSHA256).HashFile(fileName);
+    if (fileHash.empty()) {
+      return false;
+    }
+    cryptoHash.Append(fileName);
+    cryptoHash.Append(";");
+    cryptoHash.Append(fileHash);
+    cryptoHash.Append(";");
+    return true;
+  };
+
+  std::string const& sourceFile = mapping.SourceFile->FileName;
+  if (!hashFile(sourceFile)) {
+    return std::string();
+  }
+  // Hash moc_predefs.h only once per run
+  if (!this->MocConst().PredefsFileAbs.empty()) {
+    std::string& predefsHash = this->MocEval().PredefsHash;
+    if (predefsHash.empty()) {
+      predefsHash = cmCryptoHash(cmCryptoHash::AlgoSHA256)
+                      .HashFile(this->MocConst().PredefsFileAbs);
+    }
+    cryptoHash.Append(predefsHash);
+    cryptoHash.Append(";");
+  }
+  std::string const sourceDir = SubDirPrefix(sourceFile);
+  for (std::string const& dep : mapping.SourceFile->ParseData->Moc.Depends) {
+    auto const depMatch = this->FindDependency(sourceDir, dep);
+    if (depMatch.first.empty() || !hashFile(depMatch.first)) {
+      return std::string();
+    }
+  }
+  return cryptoHash.FinalizeHex();
 }
 
 std::pair<std::string, cmFileTime>
@@ -1931,6 +2209,11 @@ void cmQtAutoMocUicT::JobProbeDepsUicT::Process()
       continue;
     }
 
+    // Hash the inputs to record them once the output was generated
+    if (!this->BaseConst().ContentHashFile.empty() &&
+        mapping->ContentHash.empty()) {
+      mapping->ContentHash = this->ContentHash(*mapping);
+    }
     // Register the parent directory for creation
     this->UicEval().OutputDirs.emplace(
       cmQtAutoGen::ParentDir(mapping->OutputFile));
@@ -1940,7 +2223,7 @@ void cmQtAutoMocUicT::JobProbeDepsUicT::Process()
   }
 }
 
-bool cmQtAutoMocUicT::JobProbeDepsUicT::Probe(MappingT const& mapping,
+bool cmQtAutoMocUicT::JobProbeDepsUicT::Probe(MappingT& mapping,
                                               std::string* reason) const
 {
   std::string const& sourceFile = mapping.SourceFile->FileName;
@@ -1967,29 +2250,40 @@ bool cmQtAutoMocUicT::JobProbeDepsUicT::Probe(MappingT const& mapping,
     return true;
   }
 
-  // Test if the source file is newer
-  if (outputFileTime.Older(mapping.SourceFile->FileTime)) {
+  // Test if the uic executable is newer
+  if (outputFileTime.Older(this->UicConst().ExecutableTime)) {
     if (reason) {
       *reason = cmStrCat("Generating ", this->MessagePath(outputFile),
-                         " because it's older than the source file ",
+                         ", because it's older than the uic executable, from ",
                          this->MessagePath(sourceFile));
     }
     return true;
   }
 
-  // Test if the uic executable is newer
-  if (outputFileTime.Older(this->UicConst().ExecutableTime)) {
+  // Test if the source file is newer
+  if (outputFileTime.Older(mapping.SourceFile->FileTime)) {
     if (reason) {
       *reason = cmStrCat("Generating ", this->MessagePath(outputFile),
-                         ", because it's older than the uic executable, from ",
+                         " because it's older than the source file ",
                          this->MessagePath(sourceFile));
     }
+    if (!this->BaseConst().ContentHashFile.empty() &&
+        this->ContentUnchanged(mapping, outputFileTime)) {
+      return false;
+    }
     return true;
   }
 
   return false;
 }
 
+std::string cmQtAutoMocUicT::JobProbeDepsUicT::ContentHash(
+  MappingT& mapping) const
+{
+  return cmCryptoHash(cmCryptoHash::AlgoSHA256)
+    .HashFile(mapping.SourceFile->FileName);
+}
+
 void cmQtAutoMocUicT::JobProbeDepsFinishT::Process()
 {
   // Create output directories
@@ -2031,6 +2325,18 @@ void cmQtAutoMocUicT::JobProbeDepsFinishT::Process()
   this->Gen()->WorkerPool().EmplaceJob<JobFinishT>();
 }
 
+void cmQtAutoMocUicT::JobCompileT::RecordContentHash() const
+{
+  if (this->Mapping->ContentHash.empty()) {
+    return;
+  }
+  cmFileTime outputFileTime;
+  if (outputFileTime.Load(this->Mapping->OutputFile)) {
+    this->BaseEval().ContentHashes.Set(
+      this->Mapping->OutputFile, this->Mapping->ContentHash, outputFileTime);
+  }
+}
+
 void cmQtAutoMocUicT::JobCompileMocT::Process()
 {
   std::string const& sourceFile = this->Mapping->SourceFile->FileName;
@@ -2115,6 +2421,7 @@ void cmQtAutoMocUicT::JobCompileMocT::Process()
   if (!result.StdOut.empty()) {
     this->Log().Info(GenT::MOC, result.StdOut);
   }
+  this->RecordContentHash();
 
   // Extract dependencies from the dep file moc generated for us
   if (this->MocConst().CanOutputDependencies) {
@@ -2162,6 +2469,7 @@ void cmQtAutoMocUicT::JobCompileUicT::Process()
     if (!result.StdOut.empty()) {
       this->Log().Info(GenT::UIC, result.StdOut);
     }
+    this->RecordContentHash();
   } else {
     // Uic command failed
     std::string includers;
@@ -2389,6 +2697,7 @@ bool cmQtAutoMocUicT::InitFromInfo(InfoT const& info)
       !info.GetUInt("QT_VERSION_MINOR", this->BaseConst_.QtVersion.Minor,
                     true) ||
       !info.GetUInt("PARALLEL", this->BaseConst_.ThreadCount, false) ||
+      !info.GetBool("USE_JOBSERVER", this->BaseConst_.UseJobServer, false) ||
 #ifdef _WIN32
       !info.GetUInt("AUTOGEN_COMMAND_LINE_LENGTH_MAX",
                     this->BaseConst_.MaxCommandLineLength, false) ||
@@ -2400,6 +2709,10 @@ bool cmQtAutoMocUicT::InitFromInfo(InfoT const& info)
                       true) ||
       !info.GetStringConfig("PARSE_CACHE_FILE",
                             this->BaseConst_.ParseCacheFile, true) ||
+      !info.GetStringConfig("CONTENT_HASH_FILE",
+                            this->BaseConst_.ContentHashFile, false) ||
+      !info.GetString("SHARED_PARSE_CACHE_DIR",
+                      this->BaseConst_.SharedParseCacheDir, false) ||
       !info.GetStringConfig("SETTINGS_FILE", this->SettingsFile_, true) ||
       !info.GetArray("CMAKE_LIST_FILES", this->BaseConst_.ListFiles, true) ||
       !info.GetArray("HEADER_EXTENSIONS", this->BaseConst_.HeaderExtensions,
@@ -2457,6 +2770,7 @@ bool cmQtAutoMocUicT::InitFromInfo(InfoT const& info)
   this->BaseConst_.ThreadCount =
     std::min(this->BaseConst_.ThreadCount, ParallelMax);
   this->WorkerPool_.SetThreadCount(this->BaseConst_.ThreadCount);
+  this->WorkerPool_.SetUseJobServer(this->BaseConst_.UseJobServer);
 
   // -- Moc
   if (!this->MocConst_.Executable.empty()) {
@@ -2495,6 +2809,7 @@ bool cmQtAutoMocUicT::InitFromInfo(InfoT const& info)
     for (std::string const& item : tmp.MacroNames) {
       this->MocConst_.MacroFilters.emplace_back(
         item, ("[\n][ \t]*{?[ \t]*" + item).append("[^a-zA-Z0-9_]"));
+      this->BaseConst_.ParseSettings += cmStrCat("mmc:", item, '\n');
     }
     // Can moc output dependencies or do we need to setup dependency filters?
     if (this->BaseConst_.QtVersion >= IntegerVersion(5, 15)) {
@@ -2539,6 +2854,8 @@ bool cmQtAutoMocUicT::InitFromInfo(InfoT const& info)
         }
 
         this->MocConst_.DependFilters.emplace_back(key, exp);
+        this->BaseConst_.ParseSettings +=
+          cmStrCat("mdp:", key, '\n', exp, '\n');
         if (testEntry(
               this->MocConst_.DependFilters.back().Exp.is_valid(),
               cmStrCat("Regular expression compilation failed.\nKeyword: ",
@@ -2859,6 +3176,7 @@ bool cmQtAutoMocUicT::Process()
 {
   this->SettingsFileRead();
   this->ParseCacheRead();
+  this->ContentHashesRead();
   if (!this->CreateDirectories()) {
     return false;
   }
@@ -2872,6 +3190,10 @@ bool cmQtAutoMocUicT::Process()
   if (!this->ParseCacheWrite()) {
     return false;
   }
+  if (!this->ContentHashesWrite()) {
+    return false;
+  }
+  this->SharedParseCachePrune();
   if (!this->SettingsFileWrite()) {
     return false;
   }
@@ -3045,6 +3367,44 @@ bool cmQtAutoMocUicT::ParseCacheWrite()
   return true;
 }
 
+void cmQtAutoMocUicT::ContentHashesRead()
+{
+  if (this->BaseConst().ContentHashFile.empty()) {
+    return;
+  }
+  // Digests recorded with other settings describe outputs that will be
+  // regenerated anyway.
+  if (this->MocConst().SettingsChanged || this->UicConst().SettingsChanged) {
+    return;
+  }
+  this->BaseEval().ContentHashes.ReadFromFile(
+    this->BaseConst().ContentHashFile);
+}
+
+bool cmQtAutoMocUicT::ContentHashesWrite()
+{
+  if (this->BaseConst().ContentHashFile.empty() ||
+      !this->BaseEval().ContentHashes.Changed()) {
+    return true;
+  }
+  if (this->Log().Verbose()) {
+    this->Log().Info(
+      GenT::GEN,
+      cmStrCat("Writing the content hash file ",
+               this->MessagePath(this->BaseConst().ContentHashFile)));
+  }
+  if (!this->BaseEval().ContentHashes.WriteToFile(
+        this->BaseConst().ContentHashFile)) {
+    this->Log().Error(
+      GenT::GEN,
+      cmStrCat("Writing the content hash file ",
+               this->MessagePath(this->BaseConst().ContentHashFile),
+               " failed."));
+    return false;
+  }
+  return true;
+}
+
 bool cmQtAutoMocUicT::CreateDirectories()
 {
   // Create AUTOGEN include directory
@@ -3072,6 +3432,59 @@ std::vector<std::string> cmQtAutoMocUicT::dependenciesFromDepFile(
   return content->front().paths;
 }
 
+void cmQtAutoMocUicT::SharedParseCachePrune() const
+{
+  std::string const& cacheDir = this->BaseConst().SharedParseCacheDir;
+  if (cacheDir.empty()) {
+    return;
+  }
+
+  // Prune at most once a day
+  long const day = 24 * 60 * 60;
+  long const now = static_cast<long>(std::time(nullptr));
+  std::string const stampFile = cmStrCat(cacheDir, "/LastPrune.stamp");
+  if (cmSystemTools::FileExists(stampFile) &&
+      now - cmSystemTools::ModifiedTime(stampFile) < day) {
+    return;
+  }
+  if (!cmSystemTools::Touch(stampFile, true)) {
+    return;
+  }
+
+  // Remove the entries that were not used for a week.  Removing an entry
+  // that another autogen step still reads is harmless, it only causes a
+  // reparse.  Temporary files of entries are left behind by interrupted
+  // writers, and are removed once they are older than an hour, which no
+  // writer takes.  Failing to remove a file is not an error.
+  cmsys::Directory dir;
+  if (!dir.Load(cacheDir)) {
+    return;
+  }
+  std::size_t removed = 0;
+  for (unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i) {
+    std::string const& name = dir.GetFileName(i);
+    long maxAge;
+    if (cmHasLiteralSuffix(name, ".txt")) {
+      maxAge = 7 * day;
+    } else if (name.find(".txt.tmp") != std::string::npos) {
+      maxAge = 60 * 60;
+    } else {
+      continue;
+    }
+    std::string const entry = cmStrCat(cacheDir, '/', name);
+    if (now - cmSystemTools::ModifiedTime(entry) >= maxAge &&
+        cmSystemTools::RemoveFile(entry)) {
+      ++removed;
+    }
+  }
+  if (removed != 0 && this->Log().Verbose()) {
+    this->Log().Info(GenT::GEN,
+                     cmStrCat("Removed ", removed,
+                              " unused entries from the shared parse cache ",
+                              this->MessagePath(cacheDir)));
+  }
+}
+
 void cmQtAutoMocUicT::Abort(bool error)
 {
   if (error) {
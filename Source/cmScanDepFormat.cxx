@@ -4,14 +4,17 @@
 #include "cmScanDepFormat.h"
 
 #include <cctype>
+#include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <iterator>
 #include <utility>
 
 #include <cm/optional>
 #include <cm/string_view>
+#include <cmext/algorithm>
 #include <cmext/string_view>
 
-#include <cm3p/json/reader.h>
 #include <cm3p/json/value.h>
 #include <cm3p/json/writer.h>
 
@@ -21,17 +24,6 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
-static bool ParseFilename(Json::Value const& val, std::string& result)
-{
-  if (val.isString()) {
-    result = val.asString();
-  } else {
-    return false;
-  }
-
-  return true;
-}
-
 static Json::Value EncodeFilename(std::string const& path)
 {
   std::string data;
@@ -57,234 +49,618 @@ static Json::Value EncodeFilename(std::string const& path)
   return data;
 }
 
-#define PARSE_BLOB(val, res)                                                  \
-  do {                                                                        \
-    if (!ParseFilename(val, res)) {                                           \
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ", \
-                                    arg_pp, ": invalid blob"));               \
-      return false;                                                           \
-    }                                                                         \
-  } while (0)
-
-#define PARSE_FILENAME(val, res)                                              \
-  do {                                                                        \
-    if (!ParseFilename(val, res)) {                                           \
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ", \
-                                    arg_pp, ": invalid filename"));           \
-      return false;                                                           \
-    }                                                                         \
-                                                                              \
-    if (work_directory && !work_directory->empty() &&                         \
-        !cmSystemTools::FileIsFullPath(res)) {                                \
-      res = cmStrCat(*work_directory, '/', res);                              \
-    }                                                                         \
-  } while (0)
+namespace {
 
-bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
-                                 cmScanDepInfo* info)
+// Read a P1689 dependency file directly into a cmScanDepInfo.  The file is
+// scanned once, front to back, without building a JSON document for it;
+// members that are not needed are skipped without being stored.
+class P1689Reader
 {
-  Json::Value ppio;
-  Json::Value const& ppi = ppio;
-  cmsys::ifstream ppf(arg_pp.c_str(), std::ios::in | std::ios::binary);
+public:
+  P1689Reader(std::string const& arg_pp, std::string const& content)
+    : ArgPP(arg_pp)
+    , Cur(content.data())
+    , End(content.data() + content.size())
+    , Begin(content.data())
   {
-    Json::Reader reader;
-    if (!reader.parse(ppf, ppio, false)) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    arg_pp,
-                                    reader.getFormattedErrorMessages()));
-      return false;
-    }
   }
 
-  Json::Value const& version = ppi["version"];
-  if (version.asUInt() > 1) {
+  bool Parse(cmScanDepInfo* info);
+
+private:
+  enum class Kind
+  {
+    Object,
+    Array,
+    String,
+    Number,
+    True,
+    False,
+    Null,
+    Invalid,
+  };
+
+  std::string const& ArgPP;
+  char const* Cur;
+  char const* End;
+  char const* Begin;
+  unsigned int Depth = 0;
+  bool Failed = false;
+
+  bool Error(cm::string_view msg);
+  bool SyntaxError(cm::string_view msg);
+
+  void SkipWhitespace();
+  Kind PeekKind();
+  bool Expect(char c);
+  bool ReadString(std::string& out);
+  bool ReadHex4(unsigned int& out);
+  bool ReadNumber(std::string& out);
+  bool ReadBool(bool& out);
+  bool ReadLiteral(cm::string_view literal);
+  bool SkipValue();
+  template <typename F>
+  bool ReadObject(F member);
+  template <typename F>
+  bool ReadArray(F element);
+
+  bool ReadRule(cmScanDepInfo& rule, cm::optional<std::string>& workdir);
+  bool ReadFilename(std::string& out);
+  bool ReadRequirement(cmSourceReqInfo& req, bool is_provides);
+};
+
+bool P1689Reader::Error(cm::string_view msg)
+{
+  if (!this->Failed) {
+    this->Failed = true;
     cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                  arg_pp, ": version ", version.asString()));
-    return false;
+                                  this->ArgPP, ": ", msg));
   }
+  return false;
+}
 
-  Json::Value const& rules = ppi["rules"];
-  if (rules.isArray()) {
-    if (rules.size() != 1) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    arg_pp, ": expected 1 source entry"));
-      return false;
+bool P1689Reader::SyntaxError(cm::string_view msg)
+{
+  unsigned long line = 1;
+  unsigned long column = 1;
+  for (char const* c = this->Begin; c != this->Cur; ++c) {
+    if (*c == '\n') {
+      ++line;
+      column = 1;
+    } else {
+      ++column;
     }
+  }
+  return this->Error(cmStrCat(msg, " at line ", line, ", column ", column));
+}
 
-    for (auto const& rule : rules) {
-      cm::optional<std::string> work_directory;
-      Json::Value const& workdir = rule["work-directory"];
-      if (workdir.isString()) {
-        std::string wd;
-        PARSE_BLOB(workdir, wd);
-        work_directory = std::move(wd);
-      } else if (!workdir.isNull()) {
-        cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                      arg_pp,
-                                      ": work-directory is not a string"));
-        return false;
-      }
+void P1689Reader::SkipWhitespace()
+{
+  while (this->Cur != this->End &&
+         (*this->Cur == ' ' || *this->Cur == '\t' || *this->Cur == '\n' ||
+          *this->Cur == '\r')) {
+    ++this->Cur;
+  }
+}
 
-      if (rule.isMember("primary-output")) {
-        Json::Value const& primary_output = rule["primary-output"];
-        PARSE_FILENAME(primary_output, info->PrimaryOutput);
-      }
+P1689Reader::Kind P1689Reader::PeekKind()
+{
+  this->SkipWhitespace();
+  if (this->Cur == this->End) {
+    return Kind::Invalid;
+  }
+  switch (*this->Cur) {
+    case '{':
+      return Kind::Object;
+    case '[':
+      return Kind::Array;
+    case '"':
+      return Kind::String;
+    case 't':
+      return Kind::True;
+    case 'f':
+      return Kind::False;
+    case 'n':
+      return Kind::Null;
+    case '-':
+      return Kind::Number;
+    default:
+      break;
+  }
+  if (*this->Cur >= '0' && *this->Cur <= '9') {
+    return Kind::Number;
+  }
+  return Kind::Invalid;
+}
 
-      if (rule.isMember("outputs")) {
-        Json::Value const& outputs = rule["outputs"];
-        if (outputs.isArray()) {
-          for (auto const& output : outputs) {
-            std::string extra_output;
-            PARSE_FILENAME(output, extra_output);
+bool P1689Reader::Expect(char c)
+{
+  this->SkipWhitespace();
+  if (this->Cur == this->End || *this->Cur != c) {
+    return this->SyntaxError(cmStrCat("expected '", c, '\''));
+  }
+  ++this->Cur;
+  return true;
+}
 
-            info->ExtraOutputs.emplace_back(extra_output);
-          }
-        }
-      }
+bool P1689Reader::ReadHex4(unsigned int& out)
+{
+  out = 0;
+  for (int i = 0; i < 4; ++i, ++this->Cur) {
+    if (this->Cur == this->End) {
+      return this->SyntaxError("truncated unicode escape");
+    }
+    char const c = *this->Cur;
+    out <<= 4;
+    if (c >= '0' && c <= '9') {
+      out |= static_cast<unsigned int>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      out |= static_cast<unsigned int>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      out |= static_cast<unsigned int>(c - 'A' + 10);
+    } else {
+      return this->SyntaxError("invalid unicode escape");
+    }
+  }
+  return true;
+}
 
-      if (rule.isMember("provides")) {
-        Json::Value const& provides = rule["provides"];
-        if (!provides.isArray()) {
-          cmSystemTools::Error(
-            cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                     ": provides is not an array"));
+bool P1689Reader::ReadString(std::string& out)
+{
+  if (!this->Expect('"')) {
+    return false;
+  }
+  out.clear();
+  while (this->Cur != this->End) {
+    // Copy unescaped runs in one go.
+    char const* run = this->Cur;
+    while (this->Cur != this->End && *this->Cur != '"' &&
+           *this->Cur != '\\') {
+      ++this->Cur;
+    }
+    out.append(run, this->Cur);
+    if (this->Cur == this->End) {
+      break;
+    }
+    if (*this->Cur++ == '"') {
+      return true;
+    }
+    if (this->Cur == this->End) {
+      break;
+    }
+    char const esc = *this->Cur++;
+    switch (esc) {
+      case '"':
+      case '\\':
+      case '/':
+        out += esc;
+        break;
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        unsigned int cp;
+        if (!this->ReadHex4(cp)) {
           return false;
         }
-
-        for (auto const& provide : provides) {
-          cmSourceReqInfo provide_info;
-
-          Json::Value const& logical_name = provide["logical-name"];
-          PARSE_BLOB(logical_name, provide_info.LogicalName);
-
-          if (provide.isMember("compiled-module-path")) {
-            Json::Value const& compiled_module_path =
-              provide["compiled-module-path"];
-            PARSE_FILENAME(compiled_module_path,
-                           provide_info.CompiledModulePath);
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+          unsigned int low;
+          if (this->End - this->Cur < 2 || this->Cur[0] != '\\' ||
+              this->Cur[1] != 'u') {
+            return this->SyntaxError("expected low surrogate escape");
           }
-
-          if (provide.isMember("unique-on-source-path")) {
-            Json::Value const& unique_on_source_path =
-              provide["unique-on-source-path"];
-            if (!unique_on_source_path.isBool()) {
-              cmSystemTools::Error(
-                cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                         ": unique-on-source-path is not a boolean"));
-              return false;
-            }
-            provide_info.UseSourcePath = unique_on_source_path.asBool();
-          } else {
-            provide_info.UseSourcePath = false;
-          }
-
-          if (provide.isMember("source-path")) {
-            Json::Value const& source_path = provide["source-path"];
-            PARSE_FILENAME(source_path, provide_info.SourcePath);
-          } else if (provide_info.UseSourcePath) {
-            cmSystemTools::Error(
-              cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                       ": source-path is missing"));
+          this->Cur += 2;
+          if (!this->ReadHex4(low)) {
             return false;
           }
-
-          if (provide.isMember("is-interface")) {
-            Json::Value const& is_interface = provide["is-interface"];
-            if (!is_interface.isBool()) {
-              cmSystemTools::Error(
-                cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                         ": is-interface is not a boolean"));
-              return false;
-            }
-            provide_info.IsInterface = is_interface.asBool();
-          } else {
-            provide_info.IsInterface = true;
+          if (low < 0xDC00 || low > 0xDFFF) {
+            return this->SyntaxError("invalid low surrogate");
           }
-
-          info->Provides.push_back(provide_info);
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
         }
-      }
-
-      if (rule.isMember("requires")) {
-        Json::Value const& reqs = rule["requires"];
-        if (!reqs.isArray()) {
-          cmSystemTools::Error(
-            cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                     ": requires is not an array"));
-          return false;
+        if (cp < 0x80) {
+          out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+          out += static_cast<char>(0xC0 | (cp >> 6));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+          out += static_cast<char>(0xE0 | (cp >> 12));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+          out += static_cast<char>(0xF0 | (cp >> 18));
+          out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
         }
+      } break;
+      default:
+        return this->SyntaxError("invalid escape sequence");
+    }
+  }
+  return this->SyntaxError("unterminated string");
+}
 
-        for (auto const& require : reqs) {
-          cmSourceReqInfo require_info;
+bool P1689Reader::ReadNumber(std::string& out)
+{
+  this->SkipWhitespace();
+  char const* start = this->Cur;
+  while (this->Cur != this->End &&
+         ((*this->Cur >= '0' && *this->Cur <= '9') || *this->Cur == '-' ||
+          *this->Cur == '+' || *this->Cur == '.' || *this->Cur == 'e' ||
+          *this->Cur == 'E')) {
+    ++this->Cur;
+  }
+  if (start == this->Cur) {
+    return this->SyntaxError("expected number");
+  }
+  out.assign(start, this->Cur);
+  return true;
+}
 
-          Json::Value const& logical_name = require["logical-name"];
-          PARSE_BLOB(logical_name, require_info.LogicalName);
+bool P1689Reader::ReadLiteral(cm::string_view literal)
+{
+  this->SkipWhitespace();
+  if (static_cast<std::size_t>(this->End - this->Cur) < literal.size() ||
+      cm::string_view(this->Cur, literal.size()) != literal) {
+    return this->SyntaxError("invalid literal");
+  }
+  this->Cur += literal.size();
+  return true;
+}
 
-          if (require.isMember("compiled-module-path")) {
-            Json::Value const& compiled_module_path =
-              require["compiled-module-path"];
-            PARSE_FILENAME(compiled_module_path,
-                           require_info.CompiledModulePath);
-          }
+bool P1689Reader::ReadBool(bool& out)
+{
+  switch (this->PeekKind()) {
+    case Kind::True:
+      out = true;
+      return this->ReadLiteral("true"_s);
+    case Kind::False:
+      out = false;
+      return this->ReadLiteral("false"_s);
+    default:
+      return this->SyntaxError("expected boolean");
+  }
+}
 
-          if (require.isMember("unique-on-source-path")) {
-            Json::Value const& unique_on_source_path =
-              require["unique-on-source-path"];
-            if (!unique_on_source_path.isBool()) {
-              cmSystemTools::Error(
-                cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                         ": unique-on-source-path is not a boolean"));
-              return false;
-            }
-            require_info.UseSourcePath = unique_on_source_path.asBool();
-          } else {
-            require_info.UseSourcePath = false;
-          }
+bool P1689Reader::SkipValue()
+{
+  std::string ignored;
+  switch (this->PeekKind()) {
+    case Kind::Object:
+      return this->ReadObject(
+        [this](std::string const&) -> bool { return this->SkipValue(); });
+    case Kind::Array:
+      return this->ReadArray([this]() -> bool { return this->SkipValue(); });
+    case Kind::String:
+      return this->ReadString(ignored);
+    case Kind::Number:
+      return this->ReadNumber(ignored);
+    case Kind::True:
+      return this->ReadLiteral("true"_s);
+    case Kind::False:
+      return this->ReadLiteral("false"_s);
+    case Kind::Null:
+      return this->ReadLiteral("null"_s);
+    case Kind::Invalid:
+      break;
+  }
+  return this->SyntaxError("expected value");
+}
 
-          if (require.isMember("source-path")) {
-            Json::Value const& source_path = require["source-path"];
-            PARSE_FILENAME(source_path, require_info.SourcePath);
-          } else if (require_info.UseSourcePath) {
-            cmSystemTools::Error(
-              cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                       ": source-path is missing"));
-            return false;
-          }
+template <typename F>
+bool P1689Reader::ReadObject(F member)
+{
+  // Guard against unbounded recursion on malformed input.
+  if (this->Depth >= 1000) {
+    return this->SyntaxError("nesting too deep");
+  }
+  if (!this->Expect('{')) {
+    return false;
+  }
+  ++this->Depth;
+  std::string key;
+  this->SkipWhitespace();
+  if (this->Cur != this->End && *this->Cur == '}') {
+    ++this->Cur;
+    --this->Depth;
+    return true;
+  }
+  for (;;) {
+    if (!this->ReadString(key) || !this->Expect(':') || !member(key)) {
+      return false;
+    }
+    this->SkipWhitespace();
+    if (this->Cur != this->End && *this->Cur == ',') {
+      ++this->Cur;
+      continue;
+    }
+    if (!this->Expect('}')) {
+      return false;
+    }
+    --this->Depth;
+    return true;
+  }
+}
 
-          if (require.isMember("lookup-method")) {
-            Json::Value const& lookup_method = require["lookup-method"];
-            if (!lookup_method.isString()) {
-              cmSystemTools::Error(
-                cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                         ": lookup-method is not a string"));
-              return false;
-            }
-
-            std::string lookup_method_str = lookup_method.asString();
-            if (lookup_method_str == "by-name"_s) {
-              require_info.Method = LookupMethod::ByName;
-            } else if (lookup_method_str == "include-angle"_s) {
-              require_info.Method = LookupMethod::IncludeAngle;
-            } else if (lookup_method_str == "include-quote"_s) {
-              require_info.Method = LookupMethod::IncludeQuote;
-            } else {
-              cmSystemTools::Error(cmStrCat(
-                "-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                ": lookup-method is not a valid: ", lookup_method_str));
-              return false;
-            }
-          } else if (require_info.UseSourcePath) {
-            require_info.Method = LookupMethod::ByName;
-          }
+template <typename F>
+bool P1689Reader::ReadArray(F element)
+{
+  if (this->Depth >= 1000) {
+    return this->SyntaxError("nesting too deep");
+  }
+  if (!this->Expect('[')) {
+    return false;
+  }
+  ++this->Depth;
+  this->SkipWhitespace();
+  if (this->Cur != this->End && *this->Cur == ']') {
+    ++this->Cur;
+    --this->Depth;
+    return true;
+  }
+  for (;;) {
+    if (!element()) {
+      return false;
+    }
+    this->SkipWhitespace();
+    if (this->Cur != this->End && *this->Cur == ',') {
+      ++this->Cur;
+      continue;
+    }
+    if (!this->Expect(']')) {
+      return false;
+    }
+    --this->Depth;
+    return true;
+  }
+}
 
-          info->Requires.push_back(require_info);
+bool P1689Reader::ReadFilename(std::string& out)
+{
+  if (this->PeekKind() != Kind::String) {
+    return this->Error("invalid filename");
+  }
+  return this->ReadString(out);
+}
+
+bool P1689Reader::ReadRequirement(cmSourceReqInfo& req, bool is_provides)
+{
+  if (this->PeekKind() != Kind::Object) {
+    return this->Error("invalid blob");
+  }
+  bool have_logical_name = false;
+  bool have_source_path = false;
+  bool have_lookup_method = false;
+  bool ok = this->ReadObject([&](std::string const& key) -> bool {
+    if (key == "logical-name"_s) {
+      if (this->PeekKind() != Kind::String) {
+        return this->Error("invalid blob");
+      }
+      have_logical_name = true;
+      return this->ReadString(req.LogicalName);
+    }
+    if (key == "compiled-module-path"_s) {
+      return this->ReadFilename(req.CompiledModulePath);
+    }
+    if (key == "unique-on-source-path"_s) {
+      Kind const kind = this->PeekKind();
+      if (kind != Kind::True && kind != Kind::False) {
+        return this->Error("unique-on-source-path is not a boolean");
+      }
+      return this->ReadBool(req.UseSourcePath);
+    }
+    if (key == "source-path"_s) {
+      have_source_path = true;
+      return this->ReadFilename(req.SourcePath);
+    }
+    if (is_provides && key == "is-interface"_s) {
+      Kind const kind = this->PeekKind();
+      if (kind != Kind::True && kind != Kind::False) {
+        return this->Error("is-interface is not a boolean");
+      }
+      return this->ReadBool(req.IsInterface);
+    }
+    if (!is_provides && key == "lookup-method"_s) {
+      if (this->PeekKind() != Kind::String) {
+        return this->Error("lookup-method is not a string");
+      }
+      std::string lookup_method;
+      if (!this->ReadString(lookup_method)) {
+        return false;
+      }
+      if (lookup_method == "by-name"_s) {
+        req.Method = LookupMethod::ByName;
+      } else if (lookup_method == "include-angle"_s) {
+        req.Method = LookupMethod::IncludeAngle;
+      } else if (lookup_method == "include-quote"_s) {
+        req.Method = LookupMethod::IncludeQuote;
+      } else {
+        return this->Error(
+          cmStrCat("lookup-method is not a valid: ", lookup_method));
+      }
+      have_lookup_method = true;
+      return true;
+    }
+    return this->SkipValue();
+  });
+  if (!ok) {
+    return false;
+  }
+  if (!have_logical_name) {
+    return this->Error("invalid blob");
+  }
+  if (req.UseSourcePath && !have_source_path) {
+    return this->Error("source-path is missing");
+  }
+  if (req.UseSourcePath && !have_lookup_method) {
+    req.Method = LookupMethod::ByName;
+  }
+  return true;
+}
+
+bool P1689Reader::ReadRule(cmScanDepInfo& rule,
+                           cm::optional<std::string>& workdir)
+{
+  if (this->PeekKind() != Kind::Object) {
+    return this->Error("invalid rule");
+  }
+  return this->ReadObject([&](std::string const& key) -> bool {
+    if (key == "work-directory"_s) {
+      Kind const kind = this->PeekKind();
+      if (kind == Kind::Null) {
+        return this->ReadLiteral("null"_s);
+      }
+      if (kind != Kind::String) {
+        return this->Error("work-directory is not a string");
+      }
+      std::string wd;
+      if (!this->ReadString(wd)) {
+        return false;
+      }
+      workdir = std::move(wd);
+      return true;
+    }
+    if (key == "primary-output"_s) {
+      return this->ReadFilename(rule.PrimaryOutput);
+    }
+    if (key == "outputs"_s) {
+      if (this->PeekKind() != Kind::Array) {
+        return this->SkipValue();
+      }
+      return this->ReadArray([&]() -> bool {
+        std::string extra_output;
+        if (!this->ReadFilename(extra_output)) {
+          return false;
+        }
+        rule.ExtraOutputs.emplace_back(std::move(extra_output));
+        return true;
+      });
+    }
+    if (key == "provides"_s || key == "requires"_s) {
+      bool const is_provides = key == "provides"_s;
+      if (this->PeekKind() != Kind::Array) {
+        return this->Error(is_provides ? "provides is not an array"_s
+                                       : "requires is not an array"_s);
+      }
+      auto& reqs = is_provides ? rule.Provides : rule.Requires;
+      return this->ReadArray([&]() -> bool {
+        cmSourceReqInfo req;
+        if (!this->ReadRequirement(req, is_provides)) {
+          return false;
+        }
+        reqs.emplace_back(std::move(req));
+        return true;
+      });
+    }
+    return this->SkipValue();
+  });
+}
+
+bool P1689Reader::Parse(cmScanDepInfo* info)
+{
+  if (this->PeekKind() != Kind::Object) {
+    return this->SyntaxError("expected object");
+  }
+  cm::optional<std::size_t> rule_count;
+  cmScanDepInfo rule;
+  cm::optional<std::string> workdir;
+  bool ok = this->ReadObject([&](std::string const& key) -> bool {
+    if (key == "version"_s) {
+      std::string version;
+      if (this->PeekKind() != Kind::Number || !this->ReadNumber(version)) {
+        return this->Error("invalid version");
+      }
+      if (std::strtod(version.c_str(), nullptr) >= 2) {
+        return this->Error(cmStrCat("version ", version));
+      }
+      return true;
+    }
+    if (key == "rules"_s) {
+      if (this->PeekKind() != Kind::Array) {
+        return this->SkipValue();
+      }
+      rule_count = 0;
+      return this->ReadArray([&]() -> bool {
+        if (++*rule_count > 1) {
+          return this->Error("expected 1 source entry");
         }
+        return this->ReadRule(rule, workdir);
+      });
+    }
+    return this->SkipValue();
+  });
+  if (!ok) {
+    return false;
+  }
+  this->SkipWhitespace();
+  if (this->Cur != this->End) {
+    return this->SyntaxError("unexpected trailing content");
+  }
+  if (!rule_count) {
+    return true;
+  }
+  if (*rule_count != 1) {
+    return this->Error("expected 1 source entry");
+  }
+
+  // The work directory may appear after the paths it applies to.
+  if (workdir && !workdir->empty()) {
+    auto const anchor = [&workdir](std::string& path) {
+      if (!path.empty() && !cmSystemTools::FileIsFullPath(path)) {
+        path = cmStrCat(*workdir, '/', path);
       }
+    };
+    anchor(rule.PrimaryOutput);
+    for (std::string& output : rule.ExtraOutputs) {
+      anchor(output);
+    }
+    for (cmSourceReqInfo& req : rule.Provides) {
+      anchor(req.CompiledModulePath);
+      anchor(req.SourcePath);
+    }
+    for (cmSourceReqInfo& req : rule.Requires) {
+      anchor(req.CompiledModulePath);
+      anchor(req.SourcePath);
     }
   }
 
+  info->PrimaryOutput = std::move(rule.PrimaryOutput);
+  cm::append(info->ExtraOutputs, std::move(rule.ExtraOutputs));
+  cm::append(info->Provides, std::move(rule.Provides));
+  cm::append(info->Requires, std::move(rule.Requires));
   return true;
 }
+}
+
+bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
+                                 cmScanDepInfo* info)
+{
+  std::string content;
+  {
+    cmsys::ifstream ppf(arg_pp.c_str(), std::ios::in | std::ios::binary);
+    if (!ppf) {
+      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to open ",
+                                    arg_pp));
+      return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(ppf),
+                   std::istreambuf_iterator<char>());
+  }
+  return P1689Reader(arg_pp, content).Parse(info);
+}
 
 bool cmScanDepFormat_P1689_Write(std::string const& path,
                                  cmScanDepInfo const& info)
@@ -12,6 +12,7 @@
 #include <thread>
 
 #include <cm/memory>
+#include <cm/optional>
 
 #include <cm3p/uv.h>
 
@@ -19,6 +20,7 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmUVHandlePtr.h"
+#include "cmUVJobServerClient.h"
 
 /**
  * @brief libuv pipe buffer class
@@ -377,13 +379,71 @@ void cmUVReadOnlyProcess::UVTryFinish()
   this->FinishedCallback_();
 }
 
+/**
+ * @brief Hands out job server tokens to waiting worker processes
+ *
+ * All methods must be called from the libuv loop thread.
+ */
+class cmWorkerPoolJobServer
+{
+public:
+  /**
+   * Connect to the ambient job server, if any.
+   */
+  void Connect(uv_loop_t& uvLoop);
+
+  /**
+   * Disconnect from the job server and release its libuv handles.
+   */
+  void Disconnect() { this->Client_.reset(); }
+
+  bool IsConnected() const { return this->Client_.has_value(); }
+
+  /**
+   * Request a token.  @a onToken is called once the token is held.
+   */
+  void RequestToken(std::function<void()> onToken);
+
+  /**
+   * Release a token received through RequestToken().
+   */
+  void ReleaseToken() { this->Client_->ReleaseToken(); }
+
+private:
+  void OnToken();
+
+  cm::optional<cmUVJobServerClient> Client_;
+  std::deque<std::function<void()>> Waiting_;
+};
+
+void cmWorkerPoolJobServer::Connect(uv_loop_t& uvLoop)
+{
+  this->Client_ = cmUVJobServerClient::Connect(
+    uvLoop, [this]() { this->OnToken(); },
+    // Without the job server we still make progress on the implicit token.
+    [](int) {});
+}
+
+void cmWorkerPoolJobServer::RequestToken(std::function<void()> onToken)
+{
+  this->Waiting_.emplace_back(std::move(onToken));
+  this->Client_->RequestToken();
+}
+
+void cmWorkerPoolJobServer::OnToken()
+{
+  std::function<void()> onToken = std::move(this->Waiting_.front());
+  this->Waiting_.pop_front();
+  onToken();
+}
+
 /**
  * @brief Worker pool worker thread
  */
 class cmWorkerPoolWorker
 {
 public:
-  cmWorkerPoolWorker(uv_loop_t& uvLoop);
+  cmWorkerPoolWorker(uv_loop_t& uvLoop, cmWorkerPoolJobServer& jobServer);
   ~cmWorkerPoolWorker();
 
   cmWorkerPoolWorker(cmWorkerPoolWorker const&) = delete;
@@ -404,6 +464,7 @@ public:
 private:
   // -- Libuv callbacks
   static void UVProcessStart(uv_async_t* handle);
+  void UVProcessStartWithToken(bool hasToken);
   void UVProcessFinished();
 
   // -- Process management
@@ -414,11 +475,16 @@ private:
     std::condition_variable Condition;
     std::unique_ptr<cmUVReadOnlyProcess> ROP;
   } Proc_;
+  // -- Job server token, only accessed from the libuv loop thread
+  cmWorkerPoolJobServer& JobServer_;
+  bool HoldsToken_ = false;
   // -- System thread
   std::thread Thread_;
 };
 
-cmWorkerPoolWorker::cmWorkerPoolWorker(uv_loop_t& uvLoop)
+cmWorkerPoolWorker::cmWorkerPoolWorker(uv_loop_t& uvLoop,
+                                       cmWorkerPoolJobServer& jobServer)
+  : JobServer_(jobServer)
 {
   this->Proc_.Request.init(uvLoop, &cmWorkerPoolWorker::UVProcessStart, this);
 }
@@ -459,18 +525,38 @@ bool cmWorkerPoolWorker::RunProcess(cmWorkerPool::ProcessResultT& result,
 void cmWorkerPoolWorker::UVProcessStart(uv_async_t* handle)
 {
   auto* worker = reinterpret_cast<cmWorkerPoolWorker*>(handle->data);
+  if (worker->JobServer_.IsConnected()) {
+    // Start the process once the job server grants a token
+    worker->JobServer_.RequestToken(
+      [worker] { worker->UVProcessStartWithToken(true); });
+  } else {
+    worker->UVProcessStartWithToken(false);
+  }
+}
+
+void cmWorkerPoolWorker::UVProcessStartWithToken(bool hasToken)
+{
+  bool started = false;
   bool startFailed = false;
   {
-    auto& Proc = worker->Proc_;
-    std::lock_guard<std::mutex> lock(Proc.Mutex);
-    if (Proc.ROP && !Proc.ROP->IsStarted()) {
-      startFailed = !Proc.ROP->start(
-        handle->loop, [worker] { worker->UVProcessFinished(); });
+    std::lock_guard<std::mutex> lock(this->Proc_.Mutex);
+    if (this->Proc_.ROP && !this->Proc_.ROP->IsStarted()) {
+      started = this->Proc_.ROP->start(
+        this->Proc_.Request->loop, [this] { this->UVProcessFinished(); });
+      startFailed = !started;
+    }
+    // The token is held only while the process runs
+    if (started && hasToken) {
+      this->HoldsToken_ = true;
     }
   }
+  // Return a token that no process will use
+  if (hasToken && !started) {
+    this->JobServer_.ReleaseToken();
+  }
   // Clean up if starting of the process failed
   if (startFailed) {
-    worker->UVProcessFinished();
+    this->UVProcessFinished();
   }
 }
 
@@ -480,6 +566,11 @@ void cmWorkerPoolWorker::UVProcessFinished()
   if (this->Proc_.ROP &&
       (this->Proc_.ROP->IsFinished() || !this->Proc_.ROP->IsStarted())) {
     this->Proc_.ROP.reset();
+    // Return the token to the job server
+    if (this->HoldsToken_) {
+      this->HoldsToken_ = false;
+      this->JobServer_.ReleaseToken();
+    }
   }
   // Notify idling thread
   this->Proc_.Condition.notify_one();
@@ -523,6 +614,7 @@ public:
   std::unique_ptr<uv_loop_t> UVLoop;
   cm::uv_async_ptr UVRequestBegin;
   cm::uv_async_ptr UVRequestEnd;
+  cmWorkerPoolJobServer JobServer;
 
   // -- Thread pool and job queue
   std::mutex Mutex;
@@ -624,6 +716,10 @@ inline bool cmWorkerPoolInternal::PushJob(cmWorkerPool::JobHandleT&& jobHandle)
 void cmWorkerPoolInternal::UVSlotBegin(uv_async_t* handle)
 {
   auto& gint = *reinterpret_cast<cmWorkerPoolInternal*>(handle->data);
+  // Connect to the job server
+  if (gint.Pool->UseJobServer()) {
+    gint.JobServer.Connect(*gint.UVLoop);
+  }
   // Create worker threads
   {
     unsigned int const num = gint.Pool->ThreadCount();
@@ -631,7 +727,7 @@ void cmWorkerPoolInternal::UVSlotBegin(uv_async_t* handle)
     gint.Workers.reserve(num);
     for (unsigned int ii = 0; ii != num; ++ii) {
       gint.Workers.emplace_back(
-        cm::make_unique<cmWorkerPoolWorker>(*gint.UVLoop));
+        cm::make_unique<cmWorkerPoolWorker>(*gint.UVLoop, gint.JobServer));
     }
     // Start worker threads
     for (unsigned int ii = 0; ii != num; ++ii) {
@@ -648,6 +744,8 @@ void cmWorkerPoolInternal::UVSlotEnd(uv_async_t* handle)
   auto& gint = *reinterpret_cast<cmWorkerPoolInternal*>(handle->data);
   // Join and destroy worker threads
   gint.Workers.clear();
+  // Close the job server connection
+  gint.JobServer.Disconnect();
   // Destroy end request
   gint.UVRequestEnd.reset();
 }
@@ -756,6 +854,13 @@ void cmWorkerPool::SetThreadCount(unsigned int threadCount)
   }
 }
 
+void cmWorkerPool::SetUseJobServer(bool useJobServer)
+{
+  if (!this->Int_->Processing) {
+    this->UseJobServer_ = useJobServer;
+  }
+}
+
 bool cmWorkerPool::Process(void* userData)
 {
   // Setup user data
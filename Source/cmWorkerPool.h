@@ -168,6 +168,20 @@ public:
    */
   void SetThreadCount(unsigned int threadCount);
 
+  /**
+   * Whether external processes are limited by job server tokens.
+   */
+  bool UseJobServer() const { return this->UseJobServer_; }
+
+  /**
+   * Limit concurrently running external processes by tokens of the
+   * ambient job server described by the MAKEFLAGS environment variable.
+   * Without an ambient job server only the thread count applies.
+   *
+   * Calling this method during Process() has no effect.
+   */
+  void SetUseJobServer(bool useJobServer);
+
   /**
    * Blocking function that starts threads to process all Jobs in the queue.
    *
@@ -216,5 +230,6 @@ public:
 private:
   void* UserData_ = nullptr;
   unsigned int ThreadCount_ = 1;
+  bool UseJobServer_ = false;
   std::unique_ptr<cmWorkerPoolInternal> Int_;
 };
@@ -4,7 +4,7 @@
 
 #include <cstring>
 #include <iostream>
-#include <sstream>
+#include <vector>
 
 #include <cm3p/expat.h>
 
@@ -38,13 +38,22 @@ int cmXMLParser::ParseFile(char const* file)
   }
 
   cmsys::ifstream ifs(file);
-  if (!ifs) {
+  if (!ifs || !this->InitializeParser()) {
     return 0;
   }
 
-  std::ostringstream str;
-  str << ifs.rdbuf();
-  return this->Parse(str.str().c_str());
+  // Feed the file to the parser in blocks instead of loading it whole.
+  std::vector<char> buffer(64 * 1024);
+  while (ifs) {
+    ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    std::streamsize const n = ifs.gcount();
+    if (n > 0 &&
+        !this->ParseChunk(buffer.data(),
+                          static_cast<std::string::size_type>(n))) {
+      break;
+    }
+  }
+  return this->CleanupParser();
 }
 
 int cmXMLParser::InitializeParser()
@@ -3043,6 +3043,9 @@ int cmake::Generate()
       return -1;
     }
     this->GlobalGenerator->Generate();
+    if (this->Instrumentation->HasQuery()) {
+      this->Instrumentation->WriteTargetGraph(this->GlobalGenerator.get());
+    }
     return 0;
   };
 
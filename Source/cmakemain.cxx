@@ -29,6 +29,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmInstallScriptHandler.h"
 #include "cmInstrumentation.h"
+#include "cmInstrumentationAnalysis.h"
 #include "cmInstrumentationQuery.h"
 #include "cmList.h"
 #include "cmMakefile.h"
@@ -73,7 +74,7 @@ cmDocumentationEntry const cmDocumentationUsageNote = {
   "Run 'cmake --help' for more information."
 };
 
-cmDocumentationEntry const cmDocumentationOptions[35] = {
+cmDocumentationEntry const cmDocumentationOptions[36] = {
   { "--preset <preset>,--preset=<preset>", "Specify a configure preset." },
   { "--list-presets[=<type>]", "List available presets." },
   { "--workflow [<options>]", "Run a workflow preset." },
@@ -89,6 +90,8 @@ cmDocumentationEntry const cmDocumentationOptions[35] = {
     "Install a CMake-generated project binary tree. Run \"cmake --install\" "
     "to see compatible options and a quick help." },
   { "--open <dir>", "Open generated project in the associated application." },
+  { "--instrumentation-analyze <index>",
+    "Report the critical path of a build from instrumentation data." },
   { "-N", "View mode only." },
   { "-P <file>", "Process script mode." },
   { "--find-package", "Legacy pkg-config like mode.  Do not use." },
@@ -1135,6 +1138,57 @@ int do_open(int ac, char const* const* av)
   return cm.Open(dir, false) ? 0 : 1;
 #endif
 }
+
+int do_instrumentation_analyze(int ac, char const* const* av)
+{
+#ifdef CMAKE_BOOTSTRAP
+  std::cerr << "This cmake does not support --instrumentation-analyze\n";
+  return -1;
+#else
+  std::string indexFile;
+  std::string jsonFile;
+
+  enum Doing
+  {
+    DoingNone,
+    DoingJson,
+  };
+  Doing doing = DoingNone;
+  bool badArgs = false;
+  for (int i = 2; i < ac; ++i) {
+    if (doing == DoingJson) {
+      jsonFile = av[i];
+      doing = DoingNone;
+    } else if (strcmp(av[i], "--json") == 0) {
+      doing = DoingJson;
+    } else if (indexFile.empty()) {
+      indexFile = av[i];
+    } else {
+      std::cerr << "Unknown argument " << av[i] << std::endl;
+      badArgs = true;
+    }
+  }
+  if (badArgs || indexFile.empty() || doing != DoingNone) {
+    std::cerr << "Usage: cmake --instrumentation-analyze [--json <file>] "
+                 "<index>\n";
+    return 1;
+  }
+
+  cmInstrumentationAnalysis analysis;
+  std::string error;
+  if (!analysis.ReadIndex(indexFile, error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  analysis.Compute();
+  analysis.WriteReport(std::cout);
+  if (!jsonFile.empty() && !analysis.WriteJson(jsonFile)) {
+    std::cerr << "Unable to write " << jsonFile << std::endl;
+    return 1;
+  }
+  return 0;
+#endif
+}
 } // namespace
 
 int main(int ac, char const* const* av)
@@ -1162,6 +1216,9 @@ int main(int ac, char const* const* av)
     if (strcmp(av[1], "--open") == 0) {
       return do_open(ac, av);
     }
+    if (strcmp(av[1], "--instrumentation-analyze") == 0) {
+      return do_instrumentation_analyze(ac, av);
+    }
     if (strcmp(av[1], "--workflow") == 0) {
       return do_workflow(ac, av);
     }
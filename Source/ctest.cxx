@@ -111,6 +111,10 @@ cmDocumentationEntry const cmDocumentationOptions[] = {
   { "--tests-from-file <file>", "Run the tests listed in the given file" },
   { "--exclude-from-file <file>",
     "Run tests except those listed in the given file" },
+  { "--shard <index>/<count>",
+    "Run one of <count> shards of the tests, balanced by cost" },
+  { "--shard-cost-file <file>",
+    "Balance shards by the test costs measured in the given file" },
   { "--repeat until-fail:<n>, --repeat-until-fail <n>",
     "Require each test to run <n> times without failing in order to pass" },
   { "--repeat until-pass:<n>",
@@ -149,6 +153,8 @@ cmDocumentationEntry const cmDocumentationOptions[] = {
   { "--extra-submit <file>[;<file>]", "Submit extra files to the dashboard." },
   { "--http-header <header>", "Append HTTP header when submitting" },
   { "--schedule-random", "Use a random order for scheduling tests" },
+  { "--schedule-critical-path",
+    "Schedule tests by their critical path through dependencies" },
   { "--submit-index",
     "Submit individual dashboard tests with specific index" },
   { "--timeout <seconds>", "Set the default test timeout." },
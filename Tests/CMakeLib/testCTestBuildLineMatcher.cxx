@@ -0,0 +1,153 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmsys/RegularExpression.hxx"
+
+#include "cmCTestBuildLineMatcher.h"
+
+#include "testCommon.h"
+
+struct ExpectedLiteral
+{
+  std::string Regex;
+  std::string Literal;
+  bool Anchored;
+};
+
+static std::vector<ExpectedLiteral> const expectedLiterals{
+  /* clang-format off */
+  { "^[Bb]us [Ee]rror", "rror", false },
+  { "^Error ([0-9]+):", "Error ", true },
+  { "^Fatal", "Fatal", true },
+  { "([^:]+): error[ \\t]*[0-9]+[ \\t]*:", ": error", false },
+  { R"(make\[.*\]: \*\*\*.*Error)", "]: ***", false },
+  { "ab*c", "a", false },
+  { "^ab?", "a", true },
+  { "abc+d", "abc", false },
+  { "x\\.yz", "x.yz", false },
+  { "^(Warning|Warnung)[ :]", "", false },
+  { "foo|barbaz", "", false },
+  { ".*file: .* has no symbols", " has no symbols", false },
+  { "", "", false },
+  /* clang-format on */
+};
+
+static bool testRequiredLiteral()
+{
+  for (ExpectedLiteral const& expected : expectedLiterals) {
+    bool anchored = true;
+    std::string const literal =
+      cmCTestBuildLineMatcher::RequiredLiteral(expected.Regex, anchored);
+    if (literal != expected.Literal || anchored != expected.Anchored) {
+      std::cout << "RequiredLiteral(\"" << expected.Regex << "\") returned \""
+                << literal << "\" (anchored " << BOOL_STRING(anchored)
+                << "), should be \"" << expected.Literal << "\" (anchored "
+                << BOOL_STRING(expected.Anchored) << ")\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool testFind()
+{
+  std::vector<std::string> const regexes{
+    "^Error ([0-9]+):",
+    "([^:]+): error[ \\t]*[0-9]+[ \\t]*:",
+    ": syntax error ",
+    "([^ :]+):([0-9]+): ([^ \\t])",
+    "^(Warning|Warnung)",
+    "[0-9] ERROR: ",
+  };
+  std::vector<std::string> const lines{
+    "",
+    "Error 1: something",
+    "  Error 1: not at the start",
+    "foo.c: error 42 : bar",
+    "foo.c:12: something",
+    "foo.c:12:  nothing",
+    "a: syntax error here",
+    "Warnung 3",
+    "3 ERROR: x",
+    "x ERROR: x",
+    "no match at all",
+  };
+
+  cmCTestBuildLineMatcher matcher;
+  std::vector<cmsys::RegularExpression> plain;
+  for (std::string const& regex : regexes) {
+    matcher.Add(cmCTestBuildLineMatcher::ErrorMatch, regex);
+    plain.emplace_back(regex);
+  }
+  // Only the literals of the other groups are found in this line.
+  matcher.Add(cmCTestBuildLineMatcher::WarningMatch, "no match");
+
+  for (std::string const& line : lines) {
+    int expected = -1;
+    for (size_t i = 0; i < plain.size(); ++i) {
+      if (plain[i].find(line)) {
+        expected = static_cast<int>(i);
+        break;
+      }
+    }
+    matcher.SetLine(line);
+    int const actual = matcher.Find(cmCTestBuildLineMatcher::ErrorMatch);
+    if (actual != expected) {
+      std::cout << "Find() on \"" << line << "\" returned " << actual
+                << ", should be " << expected << '\n';
+      return false;
+    }
+  }
+
+  std::string const line = "no match at all";
+  matcher.SetLine(line);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::WarningMatch), 0);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::ErrorException), -1);
+
+  return true;
+}
+
+static bool testRegexOnly()
+{
+  cmCTestBuildLineMatcher matcher;
+  matcher.Add(cmCTestBuildLineMatcher::WarningMatch, "warning: ");
+  // Neither of these can be reduced to a literal.
+  matcher.Add(cmCTestBuildLineMatcher::WarningMatch, "^(Warning|Warnung)");
+  matcher.Add(cmCTestBuildLineMatcher::WarningMatch, "[0-9]+[.][0-9]+");
+  matcher.Add(cmCTestBuildLineMatcher::ErrorMatch, "error: ");
+
+  // No literal of any group is found in these lines, so they are only
+  // classified if the regexes without a literal are still tried.
+  std::string line = "Warnung 3";
+  matcher.SetLine(line);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::ErrorMatch), -1);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::WarningMatch), 1);
+
+  line = "version 1.2 is deprecated";
+  matcher.SetLine(line);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::WarningMatch), 2);
+
+  line = "nothing to see";
+  matcher.SetLine(line);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::WarningMatch), -1);
+
+  // A regex with a literal that comes first is still reported first.
+  line = "Warning: 1.2";
+  matcher.SetLine(line);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::WarningMatch), 1);
+  line = "a.c: warning: 1.2";
+  matcher.SetLine(line);
+  ASSERT_EQUAL(matcher.Find(cmCTestBuildLineMatcher::WarningMatch), 0);
+
+  return true;
+}
+
+int testCTestBuildLineMatcher(int /*unused*/, char* /*unused*/[])
+{
+  return runTests({
+    testRequiredLiteral,
+    testFind,
+    testRegexOnly,
+  });
+}
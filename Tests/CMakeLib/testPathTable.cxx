@@ -0,0 +1,96 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cmPathTable.h"
+
+#include "testCommon.h"
+
+namespace {
+
+bool testIntern()
+{
+  std::cout << "testIntern()\n";
+
+  cmPathTable table;
+  cmPathTable::Entry const& a = table.Intern("/src/a.c");
+  cmPathTable::Entry const& b = table.Intern("/src/b.c");
+  ASSERT_TRUE(&a != &b);
+  ASSERT_TRUE(&table.Intern(std::string("/src/a.c")) == &a);
+  ASSERT_EQUAL(a.GetPath(), "/src/a.c");
+  ASSERT_TRUE(table.Size() == 2);
+
+  table.Clear();
+  ASSERT_TRUE(table.Size() == 0);
+
+  return true;
+}
+
+bool testForms()
+{
+  std::cout << "testForms()\n";
+
+  cmPathTable table;
+  int calls = 0;
+  auto relative = [&calls](std::string const& p) {
+    ++calls;
+    return p.substr(5);
+  };
+  std::string const& r1 = table.GetForm(
+    "/bld/a.o", cmPathTable::Form::RelativeToTopBinary, relative);
+  std::string const& r2 = table.GetForm(
+    "/bld/a.o", cmPathTable::Form::RelativeToTopBinary, relative);
+  ASSERT_EQUAL(r1, "a.o");
+  ASSERT_TRUE(&r1 == &r2);
+  ASSERT_TRUE(calls == 1);
+
+  // Each form is computed separately.
+  std::string const& shell = table.GetForm(
+    "/bld/a.o", cmPathTable::Form::Shell,
+    [](std::string const& p) { return "'" + p + "'"; });
+  ASSERT_EQUAL(shell, "'/bld/a.o'");
+  ASSERT_TRUE(table.Size() == 1);
+
+  return true;
+}
+
+bool testConcurrent()
+{
+  std::cout << "testConcurrent()\n";
+
+  cmPathTable table;
+  std::vector<std::string const*> results(8);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&table, &results, i]() {
+      for (int n = 0; n < 100; ++n) {
+        table.Intern("/bld/" + std::to_string(n));
+      }
+      results[i] =
+        &table.GetForm("/bld/x", cmPathTable::Form::Ninja,
+                       [](std::string const& p) { return p.substr(5); });
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  ASSERT_TRUE(table.Size() == 101);
+  for (std::string const* result : results) {
+    ASSERT_TRUE(result == results[0]);
+  }
+  ASSERT_EQUAL(*results[0], "x");
+
+  return true;
+}
+}
+
+int testPathTable(int /*unused*/, char* /*unused*/[])
+{
+  return runTests({
+    testIntern,
+    testForms,
+    testConcurrent,
+  });
+}
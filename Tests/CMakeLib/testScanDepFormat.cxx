@@ -0,0 +1,137 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include <string>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmScanDepFormat.h"
+#include "cmSystemTools.h"
+
+#include "testCommon.h"
+
+namespace {
+
+char const* const ddiPath = "testScanDepFormat.ddi";
+
+bool parseContent(std::string const& content, cmScanDepInfo& info)
+{
+  {
+    cmsys::ofstream fout(ddiPath, std::ios::out | std::ios::binary);
+    fout << content;
+  }
+  return cmScanDepFormat_P1689_Parse(ddiPath, &info);
+}
+
+bool testRoundTrip()
+{
+  std::cout << "testRoundTrip()\n";
+
+  cmScanDepInfo written;
+  written.PrimaryOutput = "/bld/a.o";
+  written.ExtraOutputs.emplace_back("/bld/a.o.extra");
+  cmSourceReqInfo provide;
+  provide.LogicalName = "a:part";
+  provide.CompiledModulePath = "/bld/a-part.pcm";
+  provide.SourcePath = "/src/a-part.cxx";
+  provide.IsInterface = false;
+  written.Provides.push_back(provide);
+  cmSourceReqInfo require;
+  require.LogicalName = "<header.h>";
+  require.SourcePath = "/src/header.h";
+  require.UseSourcePath = true;
+  require.Method = LookupMethod::IncludeAngle;
+  written.Requires.push_back(require);
+  ASSERT_TRUE(cmScanDepFormat_P1689_Write(ddiPath, written));
+
+  cmScanDepInfo read;
+  ASSERT_TRUE(cmScanDepFormat_P1689_Parse(ddiPath, &read));
+  ASSERT_EQUAL(read.PrimaryOutput, "/bld/a.o");
+  ASSERT_TRUE(read.ExtraOutputs.size() == 1);
+  ASSERT_EQUAL(read.ExtraOutputs[0], "/bld/a.o.extra");
+  ASSERT_TRUE(read.Provides.size() == 1);
+  ASSERT_EQUAL(read.Provides[0].LogicalName, "a:part");
+  ASSERT_EQUAL(read.Provides[0].CompiledModulePath, "/bld/a-part.pcm");
+  ASSERT_EQUAL(read.Provides[0].SourcePath, "/src/a-part.cxx");
+  ASSERT_TRUE(!read.Provides[0].IsInterface);
+  ASSERT_TRUE(read.Requires.size() == 1);
+  ASSERT_EQUAL(read.Requires[0].LogicalName, "<header.h>");
+  ASSERT_EQUAL(read.Requires[0].SourcePath, "/src/header.h");
+  ASSERT_TRUE(read.Requires[0].UseSourcePath);
+  ASSERT_TRUE(read.Requires[0].Method == LookupMethod::IncludeAngle);
+
+  return true;
+}
+
+bool testWorkDirectory()
+{
+  std::cout << "testWorkDirectory()\n";
+
+  // The work directory applies to paths that appear before it, and members
+  // unknown to CMake are skipped whatever their shape.
+  cmScanDepInfo info;
+  ASSERT_TRUE(parseContent(R"({
+  "extension": { "nested": [ 1, -2.5e3, true, null, { "k": "v" } ] },
+  "rules": [ {
+    "primary-output": "obj/b.o",
+    "provides": [ { "logical-name": "b", "compiled-module-path": "b.pcm" } ],
+    "requires": [ { "logical-name": "a:part",
+                    "lookup-method": "by-name" } ],
+    "work-directory": "/bld"
+  } ],
+  "version": 1,
+  "revision": 0
+})",
+                           info));
+  ASSERT_EQUAL(info.PrimaryOutput, "/bld/obj/b.o");
+  ASSERT_TRUE(info.Provides.size() == 1);
+  ASSERT_EQUAL(info.Provides[0].LogicalName, "b");
+  ASSERT_EQUAL(info.Provides[0].CompiledModulePath, "/bld/b.pcm");
+  ASSERT_TRUE(info.Provides[0].IsInterface);
+  ASSERT_TRUE(info.Requires.size() == 1);
+  ASSERT_EQUAL(info.Requires[0].LogicalName, "a:part");
+
+  return true;
+}
+
+bool testInvalid()
+{
+  std::cout << "testInvalid()\n";
+
+  char const* const invalid[] = {
+    "",
+    R"({ "rules": [ { "primary-output": "a.o" } )",
+    R"({ "version": 2, "rules": [] })",
+    R"({ "rules": [] })",
+    R"({ "rules": [ { "primary-output": "a.o" },
+                    { "primary-output": "b.o" } ] })",
+    R"({ "rules": [ { "primary-output": 1 } ] })",
+    R"({ "rules": [ { "provides": {} } ] })",
+    R"({ "rules": [ { "requires": [ { "lookup-method": "by-name" } ] } ] })",
+    R"({ "rules": [ { "requires": [ { "logical-name": "a",
+                                      "lookup-method": "by-path" } ] } ] })",
+    R"({ "rules": [ { "provides": [ { "logical-name": "a",
+                                      "unique-on-source-path": true
+                                    } ] } ] })",
+  };
+  for (char const* content : invalid) {
+    cmScanDepInfo info;
+    if (parseContent(content, info)) {
+      std::cout << "Unexpectedly parsed:\n" << content << '\n';
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int testScanDepFormat(int /*unused*/, char* /*unused*/[])
+{
+  int const result = runTests({
+    testRoundTrip,
+    testWorkDirectory,
+    testInvalid,
+  });
+  cmSystemTools::RemoveFile(ddiPath);
+  return result;
+}
@@ -0,0 +1,68 @@
+# Stand-in for gcov: cmake -P fakegcov.cmake [options] -o <dir> <file>.gcda...
+# Each .gcda file holds the paths of its source and of the header the
+# source includes, and the count of their lines.  Like gcov, write a
+# <name>.gcov file for each to the working directory.  With --stdout, as
+# given in JSON mode, print the JSON intermediate format instead, or with
+# -DGCOV_JSON_FILES=1 write it to a .gcov.json.gz file per data file as
+# gcov does without --stdout.
+set(json 0)
+set(gcda_files "")
+math(EXPR last "${CMAKE_ARGC} - 1")
+foreach(i RANGE 1 ${last})
+  if(CMAKE_ARGV${i} STREQUAL "--stdout")
+    set(json 1)
+  elseif(CMAKE_ARGV${i} MATCHES "\\.gcda$")
+    list(APPEND gcda_files "${CMAKE_ARGV${i}}")
+  endif()
+endforeach()
+
+set(output "")
+foreach(gcda IN LISTS gcda_files)
+  file(STRINGS "${gcda}" data ENCODING UTF-8)
+  list(GET data 0 source)
+  list(GET data 1 header)
+  list(GET data 2 count)
+
+  if(json)
+    set(cwd "${CMAKE_CURRENT_BINARY_DIR}")
+    file(READ "${CMAKE_CURRENT_LIST_DIR}/gcov.json.in" document)
+    string(CONFIGURE "${document}" document @ONLY)
+    if(GCOV_JSON_FILES)
+      get_filename_component(name "${gcda}" NAME_WLE)
+      file(WRITE "${name}.gcov.json" "${document}")
+      file(ARCHIVE_CREATE OUTPUT "${name}.gcov.json.gz"
+        PATHS "${name}.gcov.json" FORMAT raw COMPRESSION GZip)
+      file(REMOVE "${name}.gcov.json")
+    else()
+      string(APPEND output "${document}")
+    endif()
+    continue()
+  endif()
+
+  # Right-align the count in the nine columns that gcov gives it.
+  string(LENGTH "${count}" length)
+  math(EXPR length "9 - ${length}")
+  string(REPEAT " " ${length} padding)
+  set(count "${padding}${count}")
+
+  foreach(file IN ITEMS "${source}" "${header}")
+    get_filename_component(name "${file}" NAME)
+    file(WRITE "${name}.gcov"
+      "        -:    0:Source:${file}\n"
+      "${count}:    1:line\n"
+      "        -:    2:{\n"
+      "${count}:    3:line\n"
+      "    #####:    4:}\n"
+    )
+    string(APPEND output
+      "File '${file}'\n"
+      "Lines executed:66.67% of 3\n"
+      "Creating '${name}.gcov'\n"
+      "\n"
+    )
+  endforeach()
+endforeach()
+
+# Give concurrent runs the chance to overwrite each other's files.
+execute_process(COMMAND "${CMAKE_COMMAND}" -E sleep 0.2)
+execute_process(COMMAND "${CMAKE_COMMAND}" -E echo_append "${output}")
@@ -0,0 +1,12 @@
+package org.cmake.Coverage;
+
+public class OtherTest {
+
+  public static int twice(int value) {
+    return 2 * value;
+  }
+
+  public static int thrice(int value) {
+    return 3 * value;
+  }
+}
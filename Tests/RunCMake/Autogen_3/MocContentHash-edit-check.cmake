@@ -0,0 +1,6 @@
+foreach(output IN ITEMS moc_object.cpp ui_form.h)
+  if(NOT actual_stdout MATCHES "Generating [^\n]*${output}")
+    string(APPEND RunCMake_TEST_FAILED
+      "${output} was not generated although its inputs changed.\n")
+  endif()
+endforeach()
@@ -0,0 +1,18 @@
+file(GLOB_RECURSE hash_files
+  "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/dummy_autogen.dir/ContentHashes*.txt")
+if(NOT hash_files)
+  string(APPEND RunCMake_TEST_FAILED "No content hash file was written.\n")
+endif()
+foreach(hash_file IN LISTS hash_files)
+  file(READ "${hash_file}" content)
+  if(content MATCHES "ui_form\\.h")
+    string(APPEND RunCMake_TEST_FAILED
+      "The content hash file\n  ${hash_file}\n"
+      "still lists the removed ui_form.h:\n${content}")
+  endif()
+  if(NOT content MATCHES "moc_object\\.cpp")
+    string(APPEND RunCMake_TEST_FAILED
+      "The content hash file\n  ${hash_file}\n"
+      "does not list moc_object.cpp:\n${content}")
+  endif()
+endforeach()
@@ -0,0 +1,9 @@
+foreach(output IN ITEMS moc_object.cpp ui_form.h)
+  if(actual_stdout MATCHES "Generating [^\n]*${output}")
+    string(APPEND RunCMake_TEST_FAILED
+      "${output} was generated although its inputs did not change.\n")
+  endif()
+  if(NOT actual_stdout MATCHES "Skipping [^\n]*${output}\"?, because the content")
+    string(APPEND RunCMake_TEST_FAILED "${output} was not skipped.\n")
+  endif()
+endforeach()
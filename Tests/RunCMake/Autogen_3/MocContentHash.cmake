@@ -0,0 +1,29 @@
+enable_language(CXX)
+
+set(CMAKE_CXX_STANDARD 11)
+find_package(Qt${with_qt_version} REQUIRED COMPONENTS Core Widgets Gui)
+
+# Copy the sources so that the test can touch and edit them.
+foreach(file IN ITEMS object.h object.cpp form.ui)
+  configure_file(MocContentHash/${file} ${file} COPYONLY)
+endforeach()
+if(MocContentHash_NO_UI)
+  # Drop the form from the target.
+  file(READ MocContentHash/object.cpp content)
+  string(REPLACE "#include \"ui_form.h\"\n" "" content "${content}")
+  file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/object.cpp "${content}")
+endif()
+
+add_library(dummy STATIC ${CMAKE_CURRENT_BINARY_DIR}/object.cpp)
+if(NOT MocContentHash_NO_UI)
+  target_sources(dummy PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/form.ui)
+endif()
+target_link_libraries(dummy Qt${with_qt_version}::Core
+                            Qt${with_qt_version}::Widgets
+                            Qt${with_qt_version}::Gui)
+
+set_target_properties(dummy PROPERTIES
+  AUTOMOC ON
+  AUTOUIC ON
+  AUTOGEN_CONTENT_HASH ON
+  )
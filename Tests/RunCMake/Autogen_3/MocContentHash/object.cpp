@@ -0,0 +1,5 @@
+#include "object.h"
+
+#include "ui_form.h"
+
+Object::Object() = default;
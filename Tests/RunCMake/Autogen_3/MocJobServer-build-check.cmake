@@ -0,0 +1,8 @@
+foreach(lib IN ITEMS a b c)
+  foreach(n RANGE 1 4)
+    file(GLOB moc "${RunCMake_TEST_BINARY_DIR}/${lib}_autogen/*/moc_${lib}${n}.cpp")
+    if(NOT moc)
+      string(APPEND RunCMake_TEST_FAILED "Missing moc output of ${lib}${n}.h\n")
+    endif()
+  endforeach()
+endforeach()
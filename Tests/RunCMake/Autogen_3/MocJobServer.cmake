@@ -0,0 +1,35 @@
+enable_language(CXX)
+
+set(CMAKE_CXX_STANDARD 11)
+find_package(Qt${with_qt_version} REQUIRED COMPONENTS Core)
+
+set(CMAKE_AUTOMOC ON)
+set(CMAKE_AUTOGEN_PARALLEL 2)
+set(CMAKE_AUTOGEN_USE_JOBSERVER ON)
+
+# Several autogen targets with several moc jobs each compete for the tokens
+# of the build's job server.
+foreach(lib IN ITEMS a b c)
+  set(sources "")
+  foreach(n RANGE 1 4)
+    set(name "${lib}${n}")
+    file(CONFIGURE OUTPUT ${name}.h CONTENT [[
+#include <QObject>
+
+class @name@ : public QObject
+{
+  Q_OBJECT
+public:
+  @name@();
+};
+]] @ONLY)
+    file(CONFIGURE OUTPUT ${name}.cpp CONTENT [[
+#include "@name@.h"
+
+@name@::@name@() = default;
+]] @ONLY)
+    list(APPEND sources ${CMAKE_CURRENT_BINARY_DIR}/${name}.cpp)
+  endforeach()
+  add_library(${lib} STATIC ${sources})
+  target_link_libraries(${lib} Qt${with_qt_version}::Core)
+endforeach()
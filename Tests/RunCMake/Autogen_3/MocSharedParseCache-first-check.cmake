@@ -0,0 +1,15 @@
+if(actual_stdout MATCHES "Reusing the shared parse result")
+  string(APPEND RunCMake_TEST_FAILED
+    "The first target reused a parse result from an empty cache.\n")
+endif()
+set(cache_dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/AutogenParseCache")
+file(GLOB entries "${cache_dir}/*.txt")
+if(NOT entries)
+  string(APPEND RunCMake_TEST_FAILED "No entries were stored in\n  ${cache_dir}\n")
+endif()
+if(EXISTS "${cache_dir}/stale.txt")
+  string(APPEND RunCMake_TEST_FAILED "The stale entry was not removed.\n")
+endif()
+if(EXISTS "${cache_dir}/stale.txt.tmp1a2b3")
+  string(APPEND RunCMake_TEST_FAILED "The stale temporary file was not removed.\n")
+endif()
@@ -0,0 +1,6 @@
+foreach(file IN ITEMS object.h object.cpp)
+  if(NOT actual_stdout MATCHES "Reusing the shared parse result of [^\n]*${file}")
+    string(APPEND RunCMake_TEST_FAILED
+      "The second target did not reuse the parse result of ${file}.\n")
+  endif()
+endforeach()
@@ -0,0 +1,13 @@
+enable_language(CXX)
+
+set(CMAKE_CXX_STANDARD 11)
+find_package(Qt${with_qt_version} REQUIRED COMPONENTS Core)
+
+set(CMAKE_AUTOMOC ON)
+set(CMAKE_AUTOGEN_SHARED_PARSE_CACHE ON)
+
+# Both targets parse the same files.
+add_library(first STATIC MocSharedParseCache/object.cpp)
+target_link_libraries(first Qt${with_qt_version}::Core)
+add_library(second STATIC MocSharedParseCache/object.cpp)
+target_link_libraries(second Qt${with_qt_version}::Core)
@@ -0,0 +1,3 @@
+#include "object.h"
+
+Object::Object() = default;
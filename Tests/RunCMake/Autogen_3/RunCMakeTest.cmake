@@ -8,4 +8,72 @@ if (DEFINED with_qt_version)
     "-DCMAKE_PREFIX_PATH:STRING=${CMAKE_PREFIX_PATH}"
   )
   autogen_executable_test(Moc)
+
+  if(RunCMake_GENERATOR MATCHES "Make|Ninja")
+    block()
+      set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/MocContentHash-build)
+      run_cmake_with_options(MocContentHash ${RunCMake_TEST_OPTIONS}
+        -DCMAKE_AUTOGEN_VERBOSE=ON)
+      set(RunCMake_TEST_NO_CLEAN 1)
+      run_cmake_command(MocContentHash-build ${CMAKE_COMMAND} --build .)
+
+      # Touching the inputs without changing them does not rerun moc or uic.
+      execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+      file(TOUCH
+        ${RunCMake_TEST_BINARY_DIR}/object.h
+        ${RunCMake_TEST_BINARY_DIR}/form.ui
+        )
+      run_cmake_command(MocContentHash-touch ${CMAKE_COMMAND} --build .)
+
+      # Changing the content reruns them.
+      execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+      file(APPEND ${RunCMake_TEST_BINARY_DIR}/object.h "// changed\n")
+      file(APPEND ${RunCMake_TEST_BINARY_DIR}/form.ui "<!-- changed -->\n")
+      run_cmake_command(MocContentHash-edit ${CMAKE_COMMAND} --build .)
+
+      # The digest of an output that no longer exists is dropped when the
+      # content hash file is rewritten.
+      run_cmake_with_options(MocContentHash ${RunCMake_TEST_OPTIONS}
+        -DCMAKE_AUTOGEN_VERBOSE=ON -DMocContentHash_NO_UI=ON)
+      file(GLOB_RECURSE ui_headers ${RunCMake_TEST_BINARY_DIR}/ui_form.h)
+      file(REMOVE ${ui_headers})
+      execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+      file(APPEND ${RunCMake_TEST_BINARY_DIR}/object.h "// changed again\n")
+      run_cmake_command(MocContentHash-prune ${CMAKE_COMMAND} --build .)
+    endblock()
+  endif()
+
+  block()
+    set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/MocSharedParseCache-build)
+    run_cmake_with_options(MocSharedParseCache ${RunCMake_TEST_OPTIONS}
+      -DCMAKE_AUTOGEN_VERBOSE=ON)
+    set(RunCMake_TEST_NO_CLEAN 1)
+    # An entry that was not used for a long time is removed, and so is an
+    # old temporary file of an interrupted writer.
+    if(CMAKE_HOST_UNIX)
+      set(cache_dir ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/AutogenParseCache)
+      foreach(stale IN ITEMS stale.txt stale.txt.tmp1a2b3)
+        file(WRITE ${cache_dir}/${stale} "")
+        execute_process(COMMAND touch -t 200001010000 ${cache_dir}/${stale})
+      endforeach()
+    endif()
+    run_cmake_command(MocSharedParseCache-first
+      ${CMAKE_COMMAND} --build . --config Debug --target first)
+    run_cmake_command(MocSharedParseCache-second
+      ${CMAKE_COMMAND} --build . --config Debug --target second)
+  endblock()
+
+  if(RunCMake_GENERATOR STREQUAL "Unix Makefiles")
+    execute_process(COMMAND "${RunCMake_MAKE_PROGRAM}" --version
+      OUTPUT_VARIABLE make_version ERROR_QUIET)
+    if(make_version MATCHES "GNU Make")
+      block()
+        set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/MocJobServer-build)
+        run_cmake(MocJobServer)
+        set(RunCMake_TEST_NO_CLEAN 1)
+        # GNU make reports tokens that were not returned on stderr.
+        run_cmake_command(MocJobServer-build ${CMAKE_COMMAND} --build . -j3)
+      endblock()
+    endif()
+  endif()
 endif ()
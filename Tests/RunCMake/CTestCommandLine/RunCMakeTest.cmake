@@ -316,6 +316,178 @@ run_Parallel(env-3)
 unset(ENV{CTEST_PARALLEL_LEVEL})
 unset(ENV{__CTEST_FAKE_PROCESSOR_COUNT_FOR_TESTING)
 
+function(run_ScheduleCriticalPath)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ScheduleCriticalPath)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(p \"${CMAKE_COMMAND}\" -E true)
+add_test(q \"${CMAKE_COMMAND}\" -E true)
+add_test(r \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(p PROPERTIES COST 10)
+set_tests_properties(q PROPERTIES COST 1)
+set_tests_properties(r PROPERTIES COST 1 DEPENDS q)
+")
+  run_cmake_command(ScheduleCriticalPath ${CMAKE_CTEST_COMMAND} -j2 --schedule-critical-path)
+  run_cmake_command(ScheduleCriticalPath-serial ${CMAKE_CTEST_COMMAND} -j1 --schedule-critical-path)
+endfunction()
+run_ScheduleCriticalPath()
+
+function(run_ScheduleCriticalPathBackfill)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ScheduleCriticalPathBackfill)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # While 'first' runs, 'big' waits for both processors.  Only 'short'
+  # is expected to finish before 'first' does, so only it backfills.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(first \"${CMAKE_COMMAND}\" -E sleep 3)
+add_test(gate \"${CMAKE_COMMAND}\" -E sleep 1)
+add_test(long \"${CMAKE_COMMAND}\" -E true)
+add_test(big \"${CMAKE_COMMAND}\" -E true)
+add_test(short \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(first PROPERTIES COST 6)
+set_tests_properties(gate PROPERTIES COST 0.5)
+set_tests_properties(long PROPERTIES COST 5.5 DEPENDS gate)
+set_tests_properties(big PROPERTIES COST 6 PROCESSORS 2 DEPENDS gate)
+set_tests_properties(short PROPERTIES COST 1 DEPENDS gate)
+")
+  run_cmake_command(ScheduleCriticalPathBackfill ${CMAKE_CTEST_COMMAND} -j2 --schedule-critical-path)
+endfunction()
+run_ScheduleCriticalPathBackfill()
+
+function(run_ScheduleCriticalPathTies)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ScheduleCriticalPathTies)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/resspec.json" [[
+{
+  "version": {"major": 1, "minor": 0},
+  "local": [{"gpus": [{"id": "0", "slots": 2}]}]
+}
+]])
+  # Equal costs: PROCESSORS breaks the tie first, then RESOURCE_GROUPS.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(plain \"${CMAKE_COMMAND}\" -E true)
+add_test(gpu \"${CMAKE_COMMAND}\" -E true)
+add_test(wide \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(plain gpu wide PROPERTIES COST 1)
+set_tests_properties(gpu PROPERTIES RESOURCE_GROUPS gpus:1)
+set_tests_properties(wide PROPERTIES PROCESSORS 2)
+")
+  run_cmake_command(ScheduleCriticalPathTies ${CMAKE_CTEST_COMMAND} -j2 --schedule-critical-path
+    --resource-spec-file resspec.json)
+endfunction()
+run_ScheduleCriticalPathTies()
+
+function(run_Shard)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Shard)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(a \"${CMAKE_COMMAND}\" -E true)
+add_test(b \"${CMAKE_COMMAND}\" -E true)
+add_test(c \"${CMAKE_COMMAND}\" -E true)
+add_test(d \"${CMAKE_COMMAND}\" -E true)
+add_test(e \"${CMAKE_COMMAND}\" -E true)
+add_test(f \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(a PROPERTIES COST 8)
+set_tests_properties(b PROPERTIES COST 3 DEPENDS c)
+set_tests_properties(c PROPERTIES COST 3)
+set_tests_properties(d PROPERTIES COST 1 FIXTURES_SETUP F)
+set_tests_properties(e PROPERTIES COST 1 FIXTURES_REQUIRED F)
+set_tests_properties(f PROPERTIES COST 2)
+")
+  run_cmake_command(Shard-1 ${CMAKE_CTEST_COMMAND} -N --shard 1/2)
+  run_cmake_command(Shard-2 ${CMAKE_CTEST_COMMAND} -N --shard 2/2)
+  run_cmake_command(Shard-bad ${CMAKE_CTEST_COMMAND} -N --shard 3/2)
+endfunction()
+run_Shard()
+
+function(run_ShardStable)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ShardStable)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(z \"${CMAKE_COMMAND}\" -E true)
+add_test(y \"${CMAKE_COMMAND}\" -E true)
+add_test(x \"${CMAKE_COMMAND}\" -E true)
+add_test(w \"${CMAKE_COMMAND}\" -E true)
+")
+  # Run times recorded by this machine do not move tests between shards.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt"
+    "w 1 100\nx 1 1\ny 1 1\nz 1 1\n---\n")
+  run_cmake_command(ShardStable ${CMAKE_CTEST_COMMAND} -N --shard 1/2)
+endfunction()
+run_ShardStable()
+
+function(run_ShardCostFile)
+  # Measured costs shared by all shards, e.g. kept from an earlier run.
+  set(costs "${RunCMake_BINARY_DIR}/ShardCostFile-costs.txt")
+  file(WRITE "${costs}" "p 3 10\nq 3 6\nr 2 4\ns 1 3\nt 1 2\nu 1 1\n---\nq\n")
+  foreach(shard 1 2)
+    # Each shard runs in its own build tree, as on separate machines.
+    set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ShardCostFile-${shard})
+    set(RunCMake_TEST_NO_CLEAN 1)
+    file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+    file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+    file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(p \"${CMAKE_COMMAND}\" -E true)
+add_test(q \"${CMAKE_COMMAND}\" -E true)
+add_test(r \"${CMAKE_COMMAND}\" -E true)
+add_test(s \"${CMAKE_COMMAND}\" -E true)
+add_test(t \"${CMAKE_COMMAND}\" -E true)
+add_test(u \"${CMAKE_COMMAND}\" -E true)
+")
+    # Costs recorded by one machine alone do not move tests between shards.
+    file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt"
+      "p 1 1\nu 1 100\n---\n")
+    run_cmake_command(ShardCostFile-${shard}
+      ${CMAKE_CTEST_COMMAND} -N --shard ${shard}/2 --shard-cost-file ${costs})
+  endforeach()
+  run_cmake_command(ShardCostFile-missing
+    ${CMAKE_CTEST_COMMAND} -N --shard 1/2 --shard-cost-file ${costs}-missing)
+endfunction()
+run_ShardCostFile()
+
+function(run_TestStatistics)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestStatistics)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Pass \"${CMAKE_COMMAND}\" -E true)
+add_test(Fail \"${CMAKE_COMMAND}\" -E false)
+")
+  run_cmake_command(TestStatistics-1 ${CMAKE_CTEST_COMMAND})
+  run_cmake_command(TestStatistics-2 ${CMAKE_CTEST_COMMAND})
+endfunction()
+run_TestStatistics()
+
+function(run_PeakMemory name peak)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/PeakMemory)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(big1 \"${CMAKE_COMMAND}\" -E sleep 1)
+add_test(big2 \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(big1 PROPERTIES COST 2)
+set_tests_properties(big2 PROPERTIES COST 1)
+")
+  set(stats "\"mean\": 0, \"variance\": 0, \"samples\": 1, \"peakMemory\": ${peak}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestTestStatistics.json"
+    "{\"version\": 1, \"tests\": {\"big1\": {${stats}}, \"big2\": {${stats}}}}\n")
+  run_cmake_command(PeakMemory-${name} ${CMAKE_CTEST_COMMAND} -j2)
+endfunction()
+# Two tests that together exceed any host memory run one at a time.
+run_PeakMemory(exceeds 8000000000000000000)
+run_PeakMemory(fits 1024)
+
 function(run_TestLoad name load)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestLoad)
   set(RunCMake_TEST_NO_CLEAN 1)
@@ -396,6 +568,61 @@ run_TestOutputTruncation("middle" "12\\.\\.\\..*\\.\\.\\.89")
 run_TestOutputTruncation("tail" "12345\\.\\.\\.")
 run_TestOutputTruncation("bad" "")
 
+# Test output exceeding twice the limit is spilled to disk
+function(run_TestOutputSpill)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestOutputSpill)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/DartConfiguration.tcl" "
+BuildDirectory: ${RunCMake_TEST_BINARY_DIR}
+")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/print.cmake" "
+foreach(i RANGE 1 200)
+  execute_process(COMMAND \"${CMAKE_COMMAND}\" -E echo \"line \${i}\")
+endforeach()
+")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(Spill \"${CMAKE_COMMAND}\" -P \"${RunCMake_TEST_BINARY_DIR}/print.cmake\")
+")
+  run_cmake_command(TestOutputSpill
+    ${CMAKE_CTEST_COMMAND} -M Experimental -T Test
+                           --no-compress-output
+                           --test-output-size-passed 20
+                           --test-output-size-failed 20
+                           --test-output-truncation head
+    )
+endfunction()
+run_TestOutputSpill()
+
+# Test output of finished tests is spooled to disk until the XML is written
+function(run_TestOutputSpool case)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${case})
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  if(case MATCHES "NoSpool")
+    # A directory in place of the spool file makes it impossible to create.
+    file(MAKE_DIRECTORY
+      "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastTestOutput.tmp")
+  endif()
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/DartConfiguration.tcl" "
+BuildDirectory: ${RunCMake_TEST_BINARY_DIR}
+")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(Spool1 \"${CMAKE_COMMAND}\" -E echo \"output of Spool1\")
+  add_test(Spool2 \"${CMAKE_COMMAND}\" -E echo \"<CTestMeasurement type=\\\"numeric/double\\\" name=\\\"Spool2Measurement\\\">7</CTestMeasurement>\")
+  add_test(Spool3 \"${CMAKE_COMMAND}\" -E echo \"output of Spool3\")
+")
+  run_cmake_command(${case}
+    ${CMAKE_CTEST_COMMAND} -M Experimental -T Test -j2
+                           --no-compress-output
+                           --output-junit "${RunCMake_TEST_BINARY_DIR}/junit.xml"
+    )
+endfunction()
+run_TestOutputSpool(TestOutputSpool)
+run_TestOutputSpool(TestOutputNoSpool)
+
 # Test --stop-on-failure
 function(run_stop_on_failure)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/stop-on-failure)
@@ -0,0 +1,3 @@
+if(actual_stdout MATCHES "Critical path schedule")
+  set(RunCMake_TEST_FAILED "Critical path prediction reported for a serial run:\n${actual_stdout}")
+endif()
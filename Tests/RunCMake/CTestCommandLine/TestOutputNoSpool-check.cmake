@@ -0,0 +1 @@
+include("${RunCMake_SOURCE_DIR}/TestOutputSpool-check.cmake")
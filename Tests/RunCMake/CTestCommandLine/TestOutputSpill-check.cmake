@@ -0,0 +1,17 @@
+set(spill_file "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/TestOutput_1.txt.gz")
+if(NOT EXISTS "${spill_file}")
+  set(RunCMake_TEST_FAILED "Spilled test output not found:\n ${spill_file}")
+  return()
+endif()
+file(GLOB test_xml_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/Test.xml")
+if(test_xml_file)
+  file(READ "${test_xml_file}" test_xml LIMIT 4096)
+  if("${test_xml}" MATCHES [[(<Test Status="passed">.*</Test>)]])
+    set(test_result "${CMAKE_MATCH_1}")
+  endif()
+  if(NOT "${test_result}" MATCHES "<Value>[^<]*20 bytes[^<]*\\.\\.\\.[^<]*line 200\n</Value>")
+    set(RunCMake_TEST_FAILED "Test output not truncated from spilled output:\n ${test_result}")
+  endif()
+else()
+  set(RunCMake_TEST_FAILED "Test.xml not found")
+endif()
@@ -0,0 +1,46 @@
+set(spool "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastTestOutput.tmp")
+if(EXISTS "${spool}" AND NOT IS_DIRECTORY "${spool}")
+  set(RunCMake_TEST_FAILED "Test output spool not removed:\n ${spool}")
+  return()
+endif()
+
+file(GLOB test_xml_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/Test.xml")
+if(NOT test_xml_file)
+  set(RunCMake_TEST_FAILED "Test.xml not found")
+  return()
+endif()
+file(READ "${test_xml_file}" test_xml)
+string(REPLACE "</Test>" ";" tests "${test_xml}")
+file(READ "${RunCMake_TEST_BINARY_DIR}/junit.xml" junit_xml)
+string(REPLACE "</testcase>" ";" testcases "${junit_xml}")
+
+# Each test must get its own output back.
+foreach(n 1 3)
+  set(found 0)
+  foreach(test IN LISTS tests)
+    if(test MATCHES "<Name>Spool${n}</Name>")
+      if(NOT test MATCHES "<Value>output of Spool${n}\n</Value>")
+        set(RunCMake_TEST_FAILED "Test.xml has wrong output for Spool${n}:\n${test}")
+        return()
+      endif()
+      set(found 1)
+    endif()
+  endforeach()
+  foreach(testcase IN LISTS testcases)
+    if(testcase MATCHES "<testcase name=\"Spool${n}\"")
+      if(NOT testcase MATCHES "<system-out>output of Spool${n}\n</system-out>")
+        set(RunCMake_TEST_FAILED "junit.xml has wrong output for Spool${n}:\n${testcase}")
+        return()
+      endif()
+      math(EXPR found "${found} + 1")
+    endif()
+  endforeach()
+  if(NOT found EQUAL 2)
+    set(RunCMake_TEST_FAILED "Spool${n} not found in Test.xml and junit.xml")
+    return()
+  endif()
+endforeach()
+
+if(NOT test_xml MATCHES "name=\"Spool2Measurement\">[ \t\n]*<Value>7</Value>")
+  set(RunCMake_TEST_FAILED "Test.xml does not have the Spool2 measurement")
+endif()
@@ -0,0 +1,16 @@
+set(stats "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestTestStatistics.json")
+if(NOT EXISTS "${stats}")
+  set(RunCMake_TEST_FAILED "Test statistics file not found:\n ${stats}")
+  return()
+endif()
+file(READ "${stats}" json)
+foreach(test IN ITEMS Pass Fail)
+  string(JSON ${test}_history GET "${json}" tests ${test} history)
+  string(JSON ${test}_samples GET "${json}" tests ${test} samples)
+endforeach()
+if(NOT Pass_history STREQUAL "PP" OR NOT Pass_samples EQUAL 2)
+  string(APPEND RunCMake_TEST_FAILED "Unexpected statistics for Pass:\n ${json}\n")
+endif()
+if(NOT Fail_history STREQUAL "FF" OR NOT Fail_samples EQUAL 0)
+  string(APPEND RunCMake_TEST_FAILED "Unexpected statistics for Fail:\n ${json}\n")
+endif()
@@ -0,0 +1,7 @@
+include(${RunCMake_TEST_BINARY_DIR}/target_files.cmake)
+check_files(${RunCMake_TEST_BINARY_DIR}/out
+  ${OptTop_TARGET_FILE}
+  ${PlainTop_TARGET_FILE}
+  ${PlainMiddle_TARGET_FILE}
+  ${PlainBottom_TARGET_FILE}
+  )
@@ -0,0 +1,23 @@
+enable_language(C)
+
+set(CMAKE_ARCHIVE_OUTPUT_DIRECTORY out)
+set(CMAKE_LIBRARY_OUTPUT_DIRECTORY out)
+set(CMAKE_RUNTIME_OUTPUT_DIRECTORY out)
+
+# Only OptTop optimizes its dependencies.  The other chain must keep its
+# dependencies in the same graph.
+add_library(OptTop STATIC mylib.c)
+add_library(OptMiddle STATIC mylib.c)
+add_library(OptBottom STATIC mylib.c)
+target_link_libraries(OptTop PRIVATE OptMiddle)
+target_link_libraries(OptMiddle PRIVATE OptBottom)
+set_property(TARGET OptTop PROPERTY OPTIMIZE_DEPENDENCIES TRUE)
+
+add_library(PlainTop STATIC mylib.c)
+add_library(PlainMiddle STATIC mylib.c)
+add_library(PlainBottom STATIC mylib.c)
+target_link_libraries(PlainTop PRIVATE PlainMiddle)
+target_link_libraries(PlainMiddle PRIVATE PlainBottom)
+
+include(WriteTargets.cmake)
+write_targets()
@@ -60,6 +60,7 @@ run_cmake(Property)
 
 run_optimize_test(OptimizeShared SharedTop)
 run_optimize_test(OptimizeStatic StaticTop)
+run_cmake_build(OptimizeMixed OptTop PlainTop)
 if(CMake_TEST_Fortran)
   run_optimize_test(OptimizeFortran FortranTop)
 endif()
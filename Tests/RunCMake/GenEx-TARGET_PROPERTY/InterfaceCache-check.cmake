@@ -0,0 +1,32 @@
+function(check_generated file expect)
+  string(REGEX REPLACE "\r\n" "\n" expect "${expect}")
+  string(REGEX REPLACE "\n+$" "" expect "${expect}")
+
+  file(READ "${RunCMake_TEST_BINARY_DIR}/${file}" actual)
+  string(REGEX REPLACE "\r\n" "\n" actual "${actual}")
+  string(REGEX REPLACE "\n+$" "" actual "${actual}")
+
+  if(NOT actual MATCHES "^${expect}$")
+    string(REPLACE "\n" "\n expect> " expect " expect> ${expect}")
+    string(REPLACE "\n" "\n actual> " actual " actual> ${actual}")
+    string(APPEND RunCMake_TEST_FAILED "Expected file(GENERATE) output in ${file}:\n${expect}\ndoes not match actual output:\n${actual}\n")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}" PARENT_SCOPE)
+  endif()
+endfunction()
+
+check_generated(out.txt [[
+# file\(GENERATE\) produced:
+head1: 'HEAD_MID;HEAD_one'
+head2: 'HEAD_MID;HEAD_two'
+diamond1: 'TOP;LEFT;BASE;RIGHT'
+diamond2: 'RIGHT;BASE'
+diamond3: 'RIGHT;BASE;LEFT'
+cycle_head1: 'CYCLE1;CYCLE2'
+cycle_head2: 'CYCLE2;CYCLE1'
+compiler_id_head: 'ID_0'
+]])
+
+check_generated(InterfaceCache/out.txt [[
+# file\(GENERATE\) produced:
+compiler_id_subdir_head: 'ID_1'
+]])
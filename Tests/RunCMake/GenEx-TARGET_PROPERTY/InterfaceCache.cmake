@@ -0,0 +1,65 @@
+enable_language(C)
+
+# A value that depends on the head target.
+add_library(head_iface INTERFACE)
+target_compile_definitions(head_iface INTERFACE "HEAD_$<TARGET_PROPERTY:HEAD_NAME>")
+add_library(head_mid INTERFACE)
+target_compile_definitions(head_mid INTERFACE HEAD_MID)
+target_link_libraries(head_mid INTERFACE head_iface)
+add_library(head1 STATIC empty.c)
+set_property(TARGET head1 PROPERTY HEAD_NAME one)
+target_link_libraries(head1 PRIVATE head_mid)
+add_library(head2 STATIC empty.c)
+set_property(TARGET head2 PROPERTY HEAD_NAME two)
+target_link_libraries(head2 PRIVATE head_mid)
+
+# A diamond whose base is already seen when the second side is evaluated.
+add_library(base INTERFACE)
+target_compile_definitions(base INTERFACE BASE)
+add_library(left INTERFACE)
+target_compile_definitions(left INTERFACE LEFT)
+target_link_libraries(left INTERFACE base)
+add_library(right INTERFACE)
+target_compile_definitions(right INTERFACE RIGHT)
+target_link_libraries(right INTERFACE base)
+add_library(top INTERFACE)
+target_compile_definitions(top INTERFACE TOP)
+target_link_libraries(top INTERFACE left right)
+add_library(diamond1 STATIC empty.c)
+target_link_libraries(diamond1 PRIVATE top)
+add_library(diamond2 STATIC empty.c)
+target_link_libraries(diamond2 PRIVATE right)
+add_library(diamond3 STATIC empty.c)
+target_link_libraries(diamond3 PRIVATE right left)
+
+# A cycle through a $<TARGET_PROPERTY> that is skipped under one head only.
+add_library(cycle1 INTERFACE)
+target_compile_definitions(cycle1 INTERFACE CYCLE1)
+target_link_libraries(cycle1 INTERFACE cycle2)
+add_library(cycle2 INTERFACE)
+target_compile_definitions(cycle2 INTERFACE CYCLE2
+  "$<TARGET_PROPERTY:cycle1,INTERFACE_COMPILE_DEFINITIONS>")
+add_library(cycle_head1 STATIC empty.c)
+target_link_libraries(cycle_head1 PRIVATE cycle1)
+add_library(cycle_head2 STATIC empty.c)
+target_link_libraries(cycle_head2 PRIVATE cycle2)
+
+# A value that depends on the directory of the evaluation, consumed by
+# heads in this directory and in a subdirectory with another compiler id.
+add_library(compiler_id INTERFACE)
+target_compile_definitions(compiler_id INTERFACE "ID_$<C_COMPILER_ID:Other>")
+add_library(compiler_id_head STATIC empty.c)
+target_link_libraries(compiler_id_head PRIVATE compiler_id)
+
+file(GENERATE OUTPUT out.txt CONTENT "# file(GENERATE) produced:
+head1: '$<TARGET_PROPERTY:head1,COMPILE_DEFINITIONS>'
+head2: '$<TARGET_PROPERTY:head2,COMPILE_DEFINITIONS>'
+diamond1: '$<TARGET_PROPERTY:diamond1,COMPILE_DEFINITIONS>'
+diamond2: '$<TARGET_PROPERTY:diamond2,COMPILE_DEFINITIONS>'
+diamond3: '$<TARGET_PROPERTY:diamond3,COMPILE_DEFINITIONS>'
+cycle_head1: '$<TARGET_PROPERTY:cycle_head1,COMPILE_DEFINITIONS>'
+cycle_head2: '$<TARGET_PROPERTY:cycle_head2,COMPILE_DEFINITIONS>'
+compiler_id_head: '$<TARGET_PROPERTY:compiler_id_head,COMPILE_DEFINITIONS>'
+")
+
+add_subdirectory(InterfaceCache)
@@ -0,0 +1,17 @@
+enable_language(C)
+
+add_library(cycle INTERFACE)
+target_compile_definitions(cycle INTERFACE CYCLE
+  "$<TARGET_PROPERTY:cycle,INTERFACE_COMPILE_DEFINITIONS>")
+add_library(cycle_mid INTERFACE)
+target_link_libraries(cycle_mid INTERFACE cycle)
+
+add_library(head1 STATIC empty.c)
+target_link_libraries(head1 PRIVATE cycle_mid)
+add_library(head2 STATIC empty.c)
+target_link_libraries(head2 PRIVATE cycle_mid)
+
+file(GENERATE OUTPUT out.txt CONTENT "
+head1: '$<TARGET_PROPERTY:head1,COMPILE_DEFINITIONS>'
+head2: '$<TARGET_PROPERTY:head2,COMPILE_DEFINITIONS>'
+")
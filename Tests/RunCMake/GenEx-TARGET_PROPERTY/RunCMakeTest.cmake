@@ -5,6 +5,8 @@ run_cmake(BadInvalidName)
 run_cmake(BadNonTarget)
 run_cmake(BadSelfReference)
 run_cmake(INCLUDE_DIRECTORIES)
+run_cmake(InterfaceCache)
+run_cmake(InterfaceCacheCycle)
 run_cmake(LinkImplementationCycle1)
 run_cmake(LinkImplementationCycle2)
 run_cmake(LinkImplementationCycle3)
@@ -104,6 +104,12 @@ instrument(dynamic-query BUILD INSTALL TEST DYNAMIC_QUERY
 instrument(both-query BUILD INSTALL TEST DYNAMIC_QUERY
   CHECK_SCRIPT check-data-dir.cmake)
 
+# Snippet log
+instrument(snippet-log BUILD
+  CHECK_SCRIPT check-snippet-log.cmake)
+instrument(snippet-log-index BUILD MANUAL_HOOK
+  CHECK_SCRIPT check-snippet-log-index.cmake)
+
 # cmake_instrumentation command
 instrument(cmake-command
   COPY_QUERIES NO_WARN DYNAMIC_QUERY
@@ -125,3 +131,11 @@ if (UNIX)
     BUILD_MAKE_PROGRAM
     CHECK_SCRIPT check-make-program-hooks.cmake)
 endif()
+
+# Critical path analysis of recorded data
+configure_file(${RunCMake_SOURCE_DIR}/analyze/index.json.in
+  ${RunCMake_BINARY_DIR}/analyze-index.json @ONLY)
+run_cmake_command(analyze ${CMAKE_COMMAND} --instrumentation-analyze
+  ${RunCMake_BINARY_DIR}/analyze-index.json)
+instrument(analyze-build BUILD MANUAL_HOOK
+  CHECK_SCRIPT check-analyze-build.cmake)
@@ -0,0 +1,35 @@
+include(${CMAKE_CURRENT_LIST_DIR}/verify-snippet.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/json.cmake)
+
+read_json("${v1}/graph/targets.json" graph)
+string(JSON main_deps GET "${graph}" targets main dependencies)
+if (NOT main_deps MATCHES "\"lib\"")
+  add_error("Target graph does not list lib as a dependency of main:\n${graph}")
+endif()
+string(JSON main_compile_deps GET "${graph}" targets main compileDependencies)
+if (RunCMake_GENERATOR MATCHES "Ninja")
+  if (main_compile_deps MATCHES "\"lib\"")
+    add_error("Ninja compiles of main do not wait for the link of lib:\n${graph}")
+  endif()
+elseif (NOT main_compile_deps MATCHES "\"lib\"")
+  add_error("Compiles of main wait for the link of lib:\n${graph}")
+endif()
+
+if (NOT EXISTS "${v1}/analysis.json")
+  add_error("The analysis callback did not write ${v1}/analysis.json")
+  return()
+endif()
+read_json("${v1}/analysis.json" analysis)
+string(JSON length GET "${analysis}" length)
+string(JSON path_length LENGTH "${analysis}" criticalPath)
+if (length EQUAL 0 OR path_length EQUAL 0)
+  add_error("The analysis found no critical path:\n${analysis}")
+endif()
+foreach(target IN ITEMS main lib)
+  string(JSON duration ERROR_VARIABLE missing GET "${analysis}" targets ${target} duration)
+  if (missing)
+    add_error("The analysis has no target ${target}:\n${analysis}")
+  elseif (duration EQUAL 0)
+    add_error("The analysis found no compile or link of ${target}:\n${analysis}")
+  endif()
+endforeach()
@@ -0,0 +1,26 @@
+include(${CMAKE_CURRENT_LIST_DIR}/verify-snippet.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/json.cmake)
+
+file(GLOB claimed ${v1}/data/.snippets*.log)
+if (claimed)
+  add_error("Snippet log not consumed by indexing:\n${claimed}")
+endif()
+
+file(GLOB snippets ${v1}/indexed/*.json)
+if (NOT snippets)
+  add_error("No snippets read from the snippet log")
+  return()
+endif()
+
+set(FOUND_SNIPPETS "")
+foreach(snippet IN LISTS snippets)
+  read_json("${snippet}" contents)
+  verify_snippet("${snippet}" "${contents}")
+  list(APPEND FOUND_SNIPPETS ${role})
+endforeach()
+
+foreach(role IN ITEMS configure generate compile link cmakeBuild)
+  if (NOT role IN_LIST FOUND_SNIPPETS)
+    add_error("No logged snippet of role \"${role}\" was indexed")
+  endif()
+endforeach()
@@ -0,0 +1,20 @@
+include(${CMAKE_CURRENT_LIST_DIR}/verify-snippet.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/json.cmake)
+
+file(GLOB snippets ${v1}/data/*.json)
+if (snippets)
+  add_error("Unexpected snippet files generated:\n${snippets}")
+endif()
+
+set(log ${v1}/data/.snippets.log)
+if (NOT EXISTS ${log})
+  add_error("Snippet log not generated")
+  return()
+endif()
+
+read_json(${log} contents)
+foreach(role IN ITEMS configure generate compile link cmakeBuild)
+  if (NOT contents MATCHES "(^|\n)${role}-[^\t\n]*\\.json\t{[^\n]*\"role\" ?: ?\"${role}\"")
+    add_error("No snippet of role \"${role}\" found in ${log}")
+  endif()
+endforeach()
@@ -0,0 +1,39 @@
+cmake_minimum_required(VERSION 3.30)
+
+include(${CMAKE_CURRENT_LIST_DIR}/json.cmake)
+# Test CALLBACK script. Copies the snippets listed in the index, and those
+# in its snippet log, so that a check script can inspect them after indexing
+# has removed them.
+# Called as: cmake -P copy-snippets.cmake [index.json]
+set(index ${CMAKE_ARGV3})
+read_json("${index}" contents)
+string(JSON dataDir GET "${contents}" dataDir)
+string(JSON snippets GET "${contents}" snippets)
+
+get_filename_component(v1 ${dataDir} DIRECTORY)
+file(MAKE_DIRECTORY ${v1}/indexed)
+string(JSON length LENGTH "${snippets}")
+if (length GREATER 0)
+  math(EXPR length "${length}-1")
+  foreach(i RANGE ${length})
+    string(JSON filename GET "${snippets}" ${i})
+    file(COPY_FILE ${dataDir}/${filename} ${v1}/indexed/${filename})
+  endforeach()
+endif()
+
+string(JSON snippetLog ERROR_VARIABLE error GET "${contents}" snippetLog)
+if (NOT error)
+  # Each line of the log is "<filename>\t<json>".
+  file(READ ${dataDir}/${snippetLog} log)
+  while (log)
+    string(FIND "${log}" "\n" end)
+    string(SUBSTRING "${log}" 0 ${end} line)
+    math(EXPR end "${end}+1")
+    string(SUBSTRING "${log}" ${end} -1 log)
+    string(FIND "${line}" "\t" tab)
+    string(SUBSTRING "${line}" 0 ${tab} filename)
+    math(EXPR tab "${tab}+1")
+    string(SUBSTRING "${line}" ${tab} -1 snippet)
+    file(WRITE ${v1}/indexed/${filename} "${snippet}\n")
+  endwhile()
+endif()
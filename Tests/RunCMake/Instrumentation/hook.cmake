@@ -43,14 +43,20 @@ endif()
 
 string(JSON length LENGTH "${snippets}")
 math(EXPR length "${length}-1")
-foreach(i RANGE ${length})
-  string(JSON filename GET "${snippets}" ${i})
-  if (NOT EXISTS ${dataDir}/${filename})
-    add_error("Listed snippet: ${dataDir}/${filename} does not exist")
-  endif()
-  read_json(${dataDir}/${filename} snippet_contents)
-  verify_snippet(${dataDir}/${filename} "${snippet_contents}")
-endforeach()
+if (length GREATER_EQUAL 0)
+  foreach(i RANGE ${length})
+    string(JSON filename GET "${snippets}" ${i})
+    if (NOT EXISTS ${dataDir}/${filename})
+      add_error("Listed snippet: ${dataDir}/${filename} does not exist")
+    endif()
+    read_json(${dataDir}/${filename} snippet_contents)
+    verify_snippet(${dataDir}/${filename} "${snippet_contents}")
+  endforeach()
+endif()
+string(JSON snippetLog ERROR_VARIABLE noSnippetLog GET "${contents}" snippetLog)
+if (NOT noSnippetLog AND NOT EXISTS ${dataDir}/${snippetLog})
+  add_error("Listed snippet log: ${dataDir}/${snippetLog} does not exist")
+endif()
 
 has_key_index(staticSystemInformation "${contents}" ${hasStaticInfo})
 has_key_index(OSName "${staticSystemInformation}" ${hasStaticInfo})
@@ -0,0 +1,18 @@
+function(check_dd target regex)
+  set(file "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${target}.dir/Fortran.dd")
+  if(NOT EXISTS "${file}")
+    string(APPEND RunCMake_TEST_FAILED "Missing dyndep file:\n  ${file}\n")
+  else()
+    file(READ "${file}" content)
+    if(NOT content MATCHES "${regex}")
+      string(APPEND RunCMake_TEST_FAILED
+        "Dyndep file\n  ${file}\ndoes not match\n  ${regex}\n"
+        "It contains:\n${content}")
+    endif()
+  endif()
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}" PARENT_SCOPE)
+endfunction()
+
+check_dd(a "\nbuild CMakeFiles/a\\.dir/a\\.f90\\.o \\| amod\\.mod: dyndep\n")
+# The second target uses the module information written for the first.
+check_dd(b "\nbuild CMakeFiles/b\\.dir/b\\.f90\\.o \\| bmod\\.mod: dyndep \\| amod\\.mod\n")
@@ -0,0 +1,10 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+string(REGEX MATCHALL "\n  DYNDEP_BATCH_ARGS = [^\n]*" args "${build_ninja}")
+list(LENGTH args count)
+if(NOT count EQUAL 1)
+  string(APPEND RunCMake_TEST_FAILED
+    "Expected one batched dyndep statement, found ${count}.\n")
+elseif(NOT args MATCHES "/a\\.dir/Fortran\\.dd .*/b\\.dir/Fortran\\.dd .*/main\\.dir/Fortran\\.dd ")
+  string(APPEND RunCMake_TEST_FAILED
+    "Targets are not collated in dependency order:\n${args}\n")
+endif()
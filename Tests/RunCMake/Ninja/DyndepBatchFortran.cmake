@@ -0,0 +1,8 @@
+set(CMAKE_NINJA_BATCH_DYNDEP ON)
+enable_language(Fortran)
+# Declare the dependents first to check that they are collated last.
+add_executable(main DyndepBatchFortran/main.f90)
+target_link_libraries(main PRIVATE b)
+add_library(b STATIC DyndepBatchFortran/b.f90)
+target_link_libraries(b PUBLIC a)
+add_library(a STATIC DyndepBatchFortran/a.f90)
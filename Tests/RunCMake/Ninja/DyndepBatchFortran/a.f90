@@ -0,0 +1,6 @@
+module amod
+contains
+  integer function aval()
+    aval = 1
+  end function
+end module
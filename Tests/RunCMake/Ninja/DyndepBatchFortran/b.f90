@@ -0,0 +1,7 @@
+module bmod
+  use amod
+contains
+  integer function bval()
+    bval = aval() + 1
+  end function
+end module
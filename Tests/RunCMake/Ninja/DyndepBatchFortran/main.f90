@@ -0,0 +1,4 @@
+program main
+  use bmod
+  if (bval() /= 2) stop 1
+end program
@@ -0,0 +1,25 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+
+foreach(var IN ITEMS DEFINES FLAGS INCLUDES)
+  # The shared value is written once as a file scope variable.
+  string(REGEX MATCHALL "\n${var}_[0-9]+ = [^\n]*" defs "${build_ninja}")
+  list(FILTER defs INCLUDE REGEX "POOLED_DEFINE|POOLED_FLAG|pooled_include")
+  list(LENGTH defs count)
+  if(NOT count EQUAL 1)
+    string(APPEND RunCMake_TEST_FAILED
+      "Expected one pooled ${var} variable, found ${count}:\n${defs}\n")
+    continue()
+  endif()
+  string(REGEX MATCH "${var}_[0-9]+" name "${defs}")
+
+  # Every compile statement references it.
+  foreach(lib IN ITEMS first second)
+    foreach(src IN ITEMS greeting greeting2)
+      set(obj "CMakeFiles/${lib}\\.dir/${src}\\.c\\.o")
+      if(NOT build_ninja MATCHES "\nbuild ${obj}: [^\n]*\n(  [^\n]*\n)*  ${var} = \\$${name}\n")
+        string(APPEND RunCMake_TEST_FAILED
+          "The compile statement of ${obj} does not use ${var} = $${name}.\n")
+      endif()
+    endforeach()
+  endforeach()
+endforeach()
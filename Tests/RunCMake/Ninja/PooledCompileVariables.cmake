@@ -0,0 +1,9 @@
+enable_language(C)
+
+# Both targets compile their sources with the same flags.
+foreach(lib IN ITEMS first second)
+  add_library(${lib} OBJECT greeting.c greeting2.c)
+  target_compile_definitions(${lib} PRIVATE POOLED_DEFINE)
+  target_compile_options(${lib} PRIVATE -DPOOLED_FLAG)
+  target_include_directories(${lib} PRIVATE pooled_include)
+endforeach()
@@ -73,6 +73,58 @@ function(run_NoWorkToDo)
 endfunction()
 run_NoWorkToDo()
 
+function(run_SubninjaPerDirectory)
+  run_cmake(SubninjaPerDirectory)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SubninjaPerDirectory-build)
+  set(RunCMake_TEST_OUTPUT_MERGE 1)
+  run_cmake_command(SubninjaPerDirectory-build ${CMAKE_COMMAND} --build .)
+  run_cmake_command(SubninjaPerDirectory-nowork ${CMAKE_COMMAND} --build . -- -d explain)
+
+  # Reconfiguring after a change in the subdirectory rewrites the file of
+  # that directory only.  Compare with a second run, because the first one
+  # also detects the compiler.
+  run_cmake_command(SubninjaPerDirectory-regenerate ${CMAKE_COMMAND} .)
+  set(fragment ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory.ninja)
+  file(TIMESTAMP "${fragment}" fragment_time "%s")
+  file(READ "${fragment}" fragment_content)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake_command(SubninjaPerDirectory-reconfigure
+    ${CMAKE_COMMAND} -DSubninjaPerDirectory_EDIT=ON .)
+endfunction()
+run_SubninjaPerDirectory()
+
+function(run_DyndepBatch)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DyndepBatch-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  foreach(target IN ITEMS a b)
+    configure_file(${RunCMake_SOURCE_DIR}/DyndepBatch/${target}-tdi.json.in
+      ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${target}.dir/FortranDependInfo.json
+      @ONLY)
+    configure_file(${RunCMake_SOURCE_DIR}/DyndepBatch/${target}.f90.o.ddi
+      ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${target}.dir/${target}.f90.o.ddi
+      COPYONLY)
+  endforeach()
+  # Collate two targets in one process.  The options of the first target
+  # may be given in any order, and each further target starts with --tdi=.
+  run_cmake_command(DyndepBatch ${CMAKE_COMMAND} -E cmake_ninja_dyndep
+    --lang=Fortran --dd=CMakeFiles/a.dir/Fortran.dd
+    --tdi=CMakeFiles/a.dir/FortranDependInfo.json CMakeFiles/a.dir/a.f90.o.ddi
+    --tdi=CMakeFiles/b.dir/FortranDependInfo.json
+    --dd=CMakeFiles/b.dir/Fortran.dd --lang=Fortran CMakeFiles/b.dir/b.f90.o.ddi
+    )
+  # A target that does not start with --tdi= would take options that
+  # belong to the next target.  Reject it.
+  run_cmake_command(DyndepBatchPartial ${CMAKE_COMMAND} -E cmake_ninja_dyndep
+    --tdi=CMakeFiles/a.dir/FortranDependInfo.json --lang=Fortran
+    --dd=CMakeFiles/a.dir/Fortran.dd CMakeFiles/a.dir/a.f90.o.ddi
+    --modmapfmt=gcc --lang=Fortran --dd=CMakeFiles/b.dir/Fortran.dd
+    --tdi=CMakeFiles/b.dir/FortranDependInfo.json CMakeFiles/b.dir/b.f90.o.ddi
+    )
+endfunction()
+run_DyndepBatch()
+
 function(run_VerboseBuild)
   run_cmake(VerboseBuild)
   set(RunCMake_TEST_NO_CLEAN 1)
@@ -102,6 +154,8 @@ run_cmake_with_options(CustomCommandDepfileAsByproduct -DCMAKE_BUILD_TYPE=Debug)
 run_cmake(CustomCommandJobPool)
 run_cmake(JobPoolUsesTerminal)
 
+run_cmake(PooledCompileVariables)
+
 run_cmake(RspFileC)
 run_cmake(RspFileCXX)
 if(CMake_TEST_Fortran
@@ -111,6 +165,18 @@ if(CMake_TEST_Fortran
   run_cmake(RspFileFortran)
 endif()
 
+function(run_DyndepBatchFortran)
+  run_cmake(DyndepBatchFortran)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DyndepBatchFortran-build)
+  set(RunCMake_TEST_OUTPUT_MERGE 1)
+  run_cmake_command(DyndepBatchFortran-build ${CMAKE_COMMAND} --build .)
+  run_cmake_command(DyndepBatchFortran-run ./main)
+endfunction()
+if(CMake_TEST_Fortran)
+  run_DyndepBatchFortran()
+endif()
+
 function(run_CommandConcat)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CommandConcat-build)
   set(RunCMake_TEST_NO_CLEAN 1)
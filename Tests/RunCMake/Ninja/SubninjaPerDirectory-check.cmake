@@ -0,0 +1,11 @@
+foreach(dir IN ITEMS "" "SubninjaPerDirectory/")
+  set(file "${RunCMake_TEST_BINARY_DIR}/${dir}CMakeFiles/directory.ninja")
+  if(NOT EXISTS "${file}")
+    string(APPEND RunCMake_TEST_FAILED "Missing directory file:\n  ${file}\n")
+  endif()
+endforeach()
+
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+if(NOT build_ninja MATCHES "\nsubninja SubninjaPerDirectory/CMakeFiles/directory.ninja\n")
+  string(APPEND RunCMake_TEST_FAILED "build.ninja does not include the subdirectory file.\n")
+endif()
@@ -0,0 +1,13 @@
+file(TIMESTAMP "${fragment}" time "%s")
+file(READ "${fragment}" content)
+if(NOT time STREQUAL fragment_time OR NOT content STREQUAL fragment_content)
+  string(APPEND RunCMake_TEST_FAILED
+    "The unchanged directory file was rewritten:\n  ${fragment}\n")
+endif()
+
+set(file "${RunCMake_TEST_BINARY_DIR}/SubninjaPerDirectory/CMakeFiles/directory.ninja")
+file(READ "${file}" content)
+if(NOT content MATCHES "SUBNINJA_EDIT")
+  string(APPEND RunCMake_TEST_FAILED
+    "The changed directory file was not updated:\n  ${file}\n")
+endif()
@@ -0,0 +1,30 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/compile_commands.json" compile_commands)
+string(JSON n LENGTH "${compile_commands}")
+math(EXPR last "${n} - 1")
+foreach(i RANGE ${last})
+  string(JSON output GET "${compile_commands}" ${i} output)
+  if(NOT output MATCHES "exe\\.dir/(Debug|Release)/")
+    continue()
+  endif()
+  set(config "${CMAKE_MATCH_1}")
+  string(JSON command GET "${compile_commands}" ${i} command)
+  set(expect COMMON COMMON_IFACE IFACE_${config})
+  set(reject)
+  if(config STREQUAL "Debug")
+    list(APPEND expect IS_DEBUG "DEP_FILE=[^ ]*dep_d\\.")
+    list(APPEND reject IFACE_Release)
+  else()
+    list(APPEND expect "DEP_FILE=[^ ]*dep\\.")
+    list(APPEND reject IS_DEBUG IFACE_Debug "dep_d\\.")
+  endif()
+  foreach(e IN LISTS expect)
+    if(NOT command MATCHES "${e}")
+      string(APPEND RunCMake_TEST_FAILED "${config} command does not match \"${e}\":\n  ${command}\n")
+    endif()
+  endforeach()
+  foreach(r IN LISTS reject)
+    if(command MATCHES "${r}")
+      string(APPEND RunCMake_TEST_FAILED "${config} command matches \"${r}\":\n  ${command}\n")
+    endif()
+  endforeach()
+endforeach()
@@ -0,0 +1,15 @@
+enable_language(C)
+
+add_library(dep STATIC main.c)
+set_property(TARGET dep PROPERTY DEBUG_POSTFIX _d)
+
+add_library(iface INTERFACE)
+target_compile_definitions(iface INTERFACE COMMON_IFACE IFACE_$<CONFIG>)
+
+add_executable(exe main.c)
+target_link_libraries(exe PRIVATE iface)
+target_compile_definitions(exe PRIVATE
+  COMMON
+  $<$<CONFIG:Debug>:IS_DEBUG>
+  "DEP_FILE=$<TARGET_FILE_NAME:dep>"
+  )
@@ -201,6 +201,27 @@ unset(RunCMake_TEST_OPTIONS)
 run_cmake_build(PostBuild release Release Exe)
 run_cmake_build(PostBuild debug-in-release-graph Release Exe:Debug)
 
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SubninjaPerDirectory-build)
+set(RunCMake_TEST_OPTIONS "-DCMAKE_CONFIGURATION_TYPES=Debug\\;Release")
+run_cmake_configure(SubninjaPerDirectory)
+unset(RunCMake_TEST_OPTIONS)
+run_cmake_build(SubninjaPerDirectory debug Debug sub)
+# Reconfiguring after a change in the subdirectory rewrites the files of
+# that directory only.  Compare with a second run, because the first one
+# also detects the compiler.
+block()
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(SubninjaPerDirectory-regenerate ${CMAKE_COMMAND} .)
+  foreach(config IN ITEMS Debug Release)
+    set(fragment "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory-${config}.ninja")
+    file(TIMESTAMP "${fragment}" fragment_time_${config} "%s")
+    file(READ "${fragment}" fragment_content_${config})
+  endforeach()
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake_command(SubninjaPerDirectory-reconfigure
+    ${CMAKE_COMMAND} -DSubninjaPerDirectory_EDIT=ON .)
+endblock()
+
 set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/LongCommandLine-build)
 set(RunCMake_TEST_OPTIONS "-DCMAKE_CROSS_CONFIGS=all")
 run_cmake_configure(LongCommandLine)
@@ -461,6 +482,10 @@ set(RunCMake_TEST_OPTIONS "-DCMAKE_CONFIGURATION_TYPES=Debug\\;Release;-DCMAKE_C
 run_cmake(CompileCommands)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS "-DCMAKE_CONFIGURATION_TYPES=Debug\\;Release;-DCMAKE_CROSS_CONFIGS=all;-DCMAKE_EXPORT_COMPILE_COMMANDS=ON")
+run_cmake(ConfigDependentFlags)
+unset(RunCMake_TEST_OPTIONS)
+
 set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/OutputPathPrefix-build)
 run_cmake_with_options(OutputPathPrefix "-DCMAKE_NINJA_OUTPUT_PATH_PREFIX=OutputPathPrefix-build")
 set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR})
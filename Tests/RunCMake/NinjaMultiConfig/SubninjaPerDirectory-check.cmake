@@ -0,0 +1,16 @@
+foreach(dir IN ITEMS "" "SubninjaPerDirectory/")
+  foreach(config IN ITEMS Debug Release)
+    set(file "${RunCMake_TEST_BINARY_DIR}/${dir}CMakeFiles/directory-${config}.ninja")
+    if(NOT EXISTS "${file}")
+      string(APPEND RunCMake_TEST_FAILED "Missing directory file:\n  ${file}\n")
+    endif()
+  endforeach()
+endforeach()
+
+foreach(config IN ITEMS Debug Release)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/impl-${config}.ninja" impl)
+  if(NOT impl MATCHES "\nsubninja SubninjaPerDirectory/CMakeFiles/directory-${config}\\.ninja\n")
+    string(APPEND RunCMake_TEST_FAILED
+      "impl-${config}.ninja does not include the subdirectory file.\n")
+  endif()
+endforeach()
@@ -0,0 +1,17 @@
+foreach(config IN ITEMS Debug Release)
+  set(fragment "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory-${config}.ninja")
+  file(TIMESTAMP "${fragment}" time "%s")
+  file(READ "${fragment}" content)
+  if(NOT time STREQUAL fragment_time_${config} OR
+     NOT content STREQUAL fragment_content_${config})
+    string(APPEND RunCMake_TEST_FAILED
+      "The unchanged directory file was rewritten:\n  ${fragment}\n")
+  endif()
+
+  set(file "${RunCMake_TEST_BINARY_DIR}/SubninjaPerDirectory/CMakeFiles/directory-${config}.ninja")
+  file(READ "${file}" content)
+  if(NOT content MATCHES "SUBNINJA_EDIT")
+    string(APPEND RunCMake_TEST_FAILED
+      "The changed directory file was not updated:\n  ${file}\n")
+  endif()
+endforeach()
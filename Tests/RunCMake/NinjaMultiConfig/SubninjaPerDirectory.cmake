@@ -0,0 +1,4 @@
+set(CMAKE_NINJA_SUBNINJA_PER_DIRECTORY ON)
+enable_language(C)
+add_executable(hello main.c)
+add_subdirectory(SubninjaPerDirectory)
@@ -11,6 +11,10 @@ run_cmake(unitybuild_c)
 run_cmake(unitybuild_c_absolute_path)
 run_cmake(unitybuild_c_relocatable_path)
 run_cmake(unitybuild_c_batch)
+run_cmake(unitybuild_c_cost)
+run_cmake(unitybuild_c_cost_missing)
+run_cmake(unitybuild_c_cost_zero)
+run_cmake(unitybuild_c_cost_batchsize)
 run_cmake(unitybuild_c_group)
 run_cmake(unitybuild_cxx)
 run_cmake(unitybuild_cxx_absolute_path)
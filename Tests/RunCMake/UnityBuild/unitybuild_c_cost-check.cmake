@@ -0,0 +1,24 @@
+set(unitybuild_c0 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_0_c.c")
+set(unitybuild_c1 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_1_c.c")
+if(NOT EXISTS "${unitybuild_c0}")
+  set(RunCMake_TEST_FAILED "Generated unity source files ${unitybuild_c0} does not exist.")
+  return()
+endif()
+
+file(STRINGS ${unitybuild_c0} unitybuild_c0_strings)
+if(NOT unitybuild_c0_strings MATCHES "#include \"[^\"]*/s1\\.c\"")
+  set(RunCMake_TEST_FAILED "Generated unity file does not include s1.c")
+  return()
+endif()
+if(unitybuild_c0_strings MATCHES "#include \"[^\"]*/s2\\.c\"")
+  set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c0} includes s2.c")
+  return()
+endif()
+
+file(STRINGS ${unitybuild_c1} unitybuild_c1_strings)
+foreach(s RANGE 2 8)
+  if(NOT unitybuild_c1_strings MATCHES "#include \"[^\"]*/s${s}\\.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c1} does not include s${s}.c")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,26 @@
+project(unitybuild_c C)
+
+set(srcs "")
+foreach(s RANGE 1 8)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt PROPERTIES
+                          UNITY_BUILD ON
+                          UNITY_BUILD_MODE COST
+                          UNITY_BUILD_BATCH_SIZE 4
+                          )
+
+# s1 costs as much as all other sources together.
+set_source_files_properties("${CMAKE_CURRENT_BINARY_DIR}/s1.c"
+                            PROPERTIES UNITY_BUILD_COST 70
+                            )
+foreach(s RANGE 2 8)
+  set_source_files_properties("${CMAKE_CURRENT_BINARY_DIR}/s${s}.c"
+                              PROPERTIES UNITY_BUILD_COST 10
+                              )
+endforeach()
@@ -0,0 +1,18 @@
+set(unity_dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity")
+if(NOT EXISTS "${unity_dir}/unity_2_c.c" OR EXISTS "${unity_dir}/unity_3_c.c")
+  set(RunCMake_TEST_FAILED "Expected three unity source files in ${unity_dir}.")
+  return()
+endif()
+
+set(unity_dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt_unlimited.dir/Unity")
+if(NOT EXISTS "${unity_dir}/unity_0_c.c" OR EXISTS "${unity_dir}/unity_1_c.c")
+  set(RunCMake_TEST_FAILED "Expected one unity source file in ${unity_dir}.")
+  return()
+endif()
+file(STRINGS "${unity_dir}/unity_0_c.c" unitybuild_c_strings)
+foreach(s RANGE 1 8)
+  if(NOT unitybuild_c_strings MATCHES "#include \"[^\"]*/s${s}\\.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unity_dir}/unity_0_c.c does not include s${s}.c")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,25 @@
+project(unitybuild_c C)
+
+set(srcs "")
+foreach(s RANGE 1 8)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+set_source_files_properties(${srcs} PROPERTIES UNITY_BUILD_COST 10)
+
+# The batch size gives the number of unity sources.
+add_library(tgt SHARED ${srcs})
+set_target_properties(tgt PROPERTIES
+                          UNITY_BUILD ON
+                          UNITY_BUILD_MODE COST
+                          UNITY_BUILD_BATCH_SIZE 3
+                          )
+
+# A batch size of zero puts all sources in one unity source.
+add_library(tgt_unlimited SHARED ${srcs})
+set_target_properties(tgt_unlimited PROPERTIES
+                          UNITY_BUILD ON
+                          UNITY_BUILD_MODE COST
+                          UNITY_BUILD_BATCH_SIZE 0
+                          )
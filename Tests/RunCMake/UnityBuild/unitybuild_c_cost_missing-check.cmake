@@ -0,0 +1,22 @@
+set(unitybuild_c0 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_0_c.c")
+set(unitybuild_c1 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_1_c.c")
+if(NOT EXISTS "${unitybuild_c1}")
+  set(RunCMake_TEST_FAILED "Generated unity source files ${unitybuild_c1} does not exist.")
+  return()
+endif()
+
+file(STRINGS ${unitybuild_c0} unitybuild_c0_strings)
+foreach(s RANGE 1 4)
+  if(NOT unitybuild_c0_strings MATCHES "#include \"[^\"]*/s${s}\\.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c0} does not include s${s}.c")
+    return()
+  endif()
+endforeach()
+
+file(STRINGS ${unitybuild_c1} unitybuild_c1_strings)
+foreach(s RANGE 5 8)
+  if(NOT unitybuild_c1_strings MATCHES "#include \"[^\"]*/s${s}\\.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c1} does not include s${s}.c")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,28 @@
+project(unitybuild_c C)
+
+set(srcs "")
+foreach(s RANGE 1 8)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt PROPERTIES
+                          UNITY_BUILD ON
+                          UNITY_BUILD_MODE COST
+                          UNITY_BUILD_BATCH_SIZE 4
+                          )
+
+# s3 to s8 have no cost, or an invalid one, and cost the average of s1
+# and s2 each.  Were they free, s1 would be alone in the first batch.
+set_source_files_properties("${CMAKE_CURRENT_BINARY_DIR}/s1.c"
+                            PROPERTIES UNITY_BUILD_COST 30
+                            )
+set_source_files_properties("${CMAKE_CURRENT_BINARY_DIR}/s2.c"
+                            PROPERTIES UNITY_BUILD_COST 10
+                            )
+set_source_files_properties("${CMAKE_CURRENT_BINARY_DIR}/s3.c"
+                            PROPERTIES UNITY_BUILD_COST -5
+                            )
@@ -0,0 +1,23 @@
+set(batches "1,2,3" "4,5,6" "7,8")
+set(i 0)
+foreach(batch IN LISTS batches)
+  set(unitybuild_c "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_${i}_c.c")
+  if(NOT EXISTS "${unitybuild_c}")
+    set(RunCMake_TEST_FAILED "Generated unity source files ${unitybuild_c} does not exist.")
+    return()
+  endif()
+  file(STRINGS ${unitybuild_c} unitybuild_c_strings)
+  string(REPLACE "," ";" batch "${batch}")
+  foreach(s RANGE 1 8)
+    if(s IN_LIST batch)
+      if(NOT unitybuild_c_strings MATCHES "#include \"[^\"]*/s${s}\\.c\"")
+        set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c} does not include s${s}.c")
+        return()
+      endif()
+    elseif(unitybuild_c_strings MATCHES "#include \"[^\"]*/s${s}\\.c\"")
+      set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c} includes s${s}.c")
+      return()
+    endif()
+  endforeach()
+  math(EXPR i "${i} + 1")
+endforeach()
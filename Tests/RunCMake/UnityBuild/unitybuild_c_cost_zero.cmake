@@ -0,0 +1,19 @@
+project(unitybuild_c C)
+
+set(srcs "")
+foreach(s RANGE 1 8)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt PROPERTIES
+                          UNITY_BUILD ON
+                          UNITY_BUILD_MODE COST
+                          UNITY_BUILD_BATCH_SIZE 3
+                          )
+
+# With no cost at all the sources are batched as in BATCH mode.
+set_source_files_properties(${srcs} PROPERTIES UNITY_BUILD_COST 0)
@@ -0,0 +1,31 @@
+file(GLOB launch_log "${RunCMake_TEST_BINARY_DIR}/Testing/*/Build/CTestLaunchLog.txt")
+if(NOT launch_log)
+  set(RunCMake_TEST_FAILED "CTestLaunchLog.txt not found")
+  return()
+endif()
+file(STRINGS "${launch_log}" records)
+set(clean 0)
+set(fragments "")
+foreach(record IN LISTS records)
+  if(NOT record MATCHES "^0\t[0-9]+\t[0-9a-f]+\t(.*)$")
+    set(RunCMake_TEST_FAILED "CTestLaunchLog.txt has a malformed record:\n  ${record}")
+    return()
+  endif()
+  if("${CMAKE_MATCH_1}" STREQUAL "")
+    math(EXPR clean "${clean} + 1")
+  else()
+    list(APPEND fragments "${CMAKE_MATCH_1}")
+  endif()
+endforeach()
+if(clean LESS 1 OR NOT fragments MATCHES "^warning-[0-9a-f]+\\.xml$")
+  string(REPLACE ";" "\n  " records "  ${records}")
+  set(RunCMake_TEST_FAILED "CTestLaunchLog.txt does not have one clean and one warning record:\n${records}")
+  return()
+endif()
+get_filename_component(launch_dir "${launch_log}" DIRECTORY)
+if(NOT EXISTS "${launch_dir}/${fragments}")
+  set(RunCMake_TEST_FAILED "Fragment named in CTestLaunchLog.txt not found:\n  ${launch_dir}/${fragments}")
+  return()
+endif()
+
+include("${RunCMake_SOURCE_DIR}/LaunchLogWarning.cmake")
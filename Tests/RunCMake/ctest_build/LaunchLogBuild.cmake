@@ -0,0 +1,15 @@
+# Run the build, then remove the launch log (MODE=missing) or drop its
+# records that name an xml fragment (MODE=partial).
+execute_process(COMMAND "${CMAKE_COMMAND}" --build . RESULT_VARIABLE result)
+set(log "$ENV{CTEST_LAUNCH_LOGS}/CTestLaunchLog.txt")
+if(MODE STREQUAL "missing")
+  file(REMOVE "${log}")
+elseif(MODE STREQUAL "partial")
+  file(STRINGS "${log}" records)
+  list(FILTER records EXCLUDE REGEX "\t[^\t]+\\.xml$")
+  list(JOIN records "\n" records)
+  file(WRITE "${log}" "${records}\n")
+endif()
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "Build failed: ${result}")
+endif()
@@ -0,0 +1,7 @@
+file(GLOB launch_log "${RunCMake_TEST_BINARY_DIR}/Testing/*/Build/CTestLaunchLog.txt")
+if(launch_log)
+  set(RunCMake_TEST_FAILED "CTestLaunchLog.txt not removed:\n  ${launch_log}")
+  return()
+endif()
+
+include("${RunCMake_SOURCE_DIR}/LaunchLogWarning.cmake")
@@ -0,0 +1,9 @@
+file(GLOB launch_log "${RunCMake_TEST_BINARY_DIR}/Testing/*/Build/CTestLaunchLog.txt")
+file(STRINGS "${launch_log}" records)
+if(NOT records OR records MATCHES "\\.xml")
+  string(REPLACE ";" "\n  " records "  ${records}")
+  set(RunCMake_TEST_FAILED "CTestLaunchLog.txt does not have only clean records:\n${records}")
+  return()
+endif()
+
+include("${RunCMake_SOURCE_DIR}/LaunchLogWarning.cmake")
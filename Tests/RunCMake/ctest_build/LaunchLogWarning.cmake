@@ -0,0 +1,14 @@
+file(GLOB build_xml_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/Build.xml")
+if(build_xml_file)
+  file(READ "${build_xml_file}" build_xml)
+  string(REGEX MATCHALL "<Failure type=\"Warning\">" warnings "${build_xml}")
+  list(LENGTH warnings count)
+  if(NOT count EQUAL 1 OR NOT build_xml MATCHES "launch log warning")
+    string(REPLACE "\n" "\n  " build_xml "  ${build_xml}")
+    set(RunCMake_TEST_FAILED
+      "Build.xml does not have the launched warning once:\n${build_xml}"
+      )
+  endif()
+else()
+  set(RunCMake_TEST_FAILED "Build.xml not found")
+endif()
@@ -35,6 +35,26 @@ endif()
   run_ctest(BuildFailure)
 endblock()
 
+function(run_LaunchLog CASE_NAME mode)
+  set(CASE_CMAKELISTS_SUFFIX_CODE [=[
+add_custom_target(clean_step ALL COMMAND ${CMAKE_COMMAND} -E echo "clean step")
+add_custom_target(warn_step ALL
+  COMMAND ${CMAKE_COMMAND} -E echo "warn.c:1: warning: launch log warning"
+  )
+]=])
+  if(mode)
+    string(CONCAT CASE_TEST_PREFIX_CODE
+      "set(launch_log_mode ${mode})\n"
+      "set(launch_log_script \"${RunCMake_SOURCE_DIR}/LaunchLogBuild.cmake\")\n"
+      [[set(CTEST_BUILD_COMMAND "\"${CMAKE_COMMAND}\" -DMODE=${launch_log_mode} -P \"${launch_log_script}\"")]]
+      )
+  endif()
+  run_ctest(${CASE_NAME})
+endfunction()
+run_LaunchLog(LaunchLog "")
+run_LaunchLog(LaunchLogMissing missing)
+run_LaunchLog(LaunchLogPartial partial)
+
 function(run_BuildChangeId)
   set(CASE_TEST_PREFIX_CODE [[
     set(CTEST_CHANGE_ID "<>1")
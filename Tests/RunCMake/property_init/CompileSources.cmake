@@ -145,8 +145,11 @@ set(properties
   "ANDROID_PROCESS_MAX"                     "2"                 "<SAME>"
   "ANDROID_SKIP_ANT_STEP"                   "ON"                "<SAME>"
   ## Autogen
+  "AUTOGEN_CONTENT_HASH"                    "ON"                "<SAME>"
   "AUTOGEN_ORIGIN_DEPENDS"                  "OFF"               "<SAME>"
   "AUTOGEN_PARALLEL"                        "ON"                "<SAME>"
+  "AUTOGEN_SHARED_PARSE_CACHE"              "ON"                "<SAME>"
+  "AUTOGEN_USE_JOBSERVER"                   "ON"                "<SAME>"
   "AUTOGEN_USE_SYSTEM_INCLUDE"              "ON"                "<SAME>"
   ## moc
   "AUTOMOC_DEPEND_FILTERS"                  "FIRST<SEMI>SECOND" "<SAME>"
@@ -0,0 +1,58 @@
+# Measure the ctest_build step on a synthetic build log.  The build command
+# prints LINES lines of compiler invocations, with one warning and one
+# error every DIAGNOSTIC_EVERY lines, which are all scanned against the
+# default error and warning regular expressions.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DLINES=<n>] [-DDIAGNOSTIC_EVERY=<n>]
+#         -P CTestBuild.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED LINES)
+  set(LINES 100000)
+endif()
+if(NOT DEFINED DIAGNOSTIC_EVERY)
+  set(DIAGNOSTIC_EVERY 10000)
+endif()
+
+set(src "${WORK_DIR}/CTestBuild")
+file(REMOVE_RECURSE "${src}")
+file(MAKE_DIRECTORY "${src}")
+
+# Write the log in chunks of 1000 lines to keep the script fast.
+set(chunk "")
+foreach(i RANGE 1 1000)
+  string(APPEND chunk "/usr/bin/cc -DNDEBUG -I/src/include -O2 -o "
+    "obj/file${i}.o -c /src/lib/file${i}.c -Wall -Wextra\n")
+endforeach()
+set(diagnostics
+  "/src/lib/file.c:12:5: warning: unused variable 'x' [-Wunused-variable]\n"
+  "/src/lib/file.c:20:1: error: expected ';' before '}' token\n"
+  )
+string(JOIN "" diagnostics ${diagnostics})
+set(log "${src}/build.log")
+file(WRITE "${log}" "")
+set(written 0)
+set(next_diagnostic ${DIAGNOSTIC_EVERY})
+while(written LESS LINES)
+  file(APPEND "${log}" "${chunk}")
+  math(EXPR written "${written} + 1000")
+  while(NOT written LESS next_diagnostic)
+    file(APPEND "${log}" "${diagnostics}")
+    math(EXPR next_diagnostic "${next_diagnostic} + ${DIAGNOSTIC_EVERY}")
+  endwhile()
+endwhile()
+
+file(WRITE "${src}/build.cmake" "
+set(CTEST_SOURCE_DIRECTORY \"${src}\")
+set(CTEST_BINARY_DIRECTORY \"${src}\")
+set(CTEST_BUILD_COMMAND \"\${CMAKE_COMMAND} -E cat ${log}\")
+ctest_start(Experimental)
+ctest_build(NUMBER_ERRORS errors NUMBER_WARNINGS warnings)
+message(\"errors=\${errors} warnings=\${warnings}\")
+")
+
+foreach(bin IN LISTS BIN_DIRS)
+  benchmark_time(ms "${src}" "${bin}/ctest" -S build.cmake)
+  benchmark_report("CTestBuild ${LINES} lines" "${bin}" "${ms}")
+endforeach()
@@ -0,0 +1,50 @@
+# Helpers shared by the benchmark scripts in this directory.
+#
+# Input variables:
+#   BIN_DIRS   List of directories holding the cmake and ctest executables
+#              to compare.  Defaults to the directory of the running cmake.
+#   REPEAT     Number of runs per measurement.  The fastest is reported.
+#   WORK_DIR   Directory in which the scripts generate their inputs.
+
+cmake_minimum_required(VERSION 3.23)
+
+if(NOT DEFINED BIN_DIRS)
+  get_filename_component(BIN_DIRS "${CMAKE_COMMAND}" DIRECTORY)
+endif()
+if(NOT DEFINED REPEAT)
+  set(REPEAT 3)
+endif()
+if(NOT DEFINED WORK_DIR)
+  set(WORK_DIR "${CMAKE_CURRENT_BINARY_DIR}/benchmark-work")
+endif()
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+# benchmark_time(<out-var> <working-dir> <command>...)
+# Run <command> REPEAT times and store the fastest wall clock time in
+# milliseconds in <out-var>.  The exit code of <command> is ignored, so
+# that commands reporting failed tests can be measured too.
+function(benchmark_time out dir)
+  set(best "")
+  foreach(i RANGE 1 ${REPEAT})
+    string(TIMESTAMP start "%s%f" UTC)
+    execute_process(COMMAND ${ARGN}
+      WORKING_DIRECTORY "${dir}"
+      RESULT_VARIABLE result
+      OUTPUT_QUIET ERROR_QUIET
+      )
+    string(TIMESTAMP stop "%s%f" UTC)
+    if(NOT result MATCHES "^[0-9]+$")
+      message(FATAL_ERROR "Running\n  ${ARGN}\nfailed: ${result}")
+    endif()
+    math(EXPR ms "(${stop} - ${start}) / 1000")
+    if(best STREQUAL "" OR ms LESS best)
+      set(best "${ms}")
+    endif()
+  endforeach()
+  set("${out}" "${best}" PARENT_SCOPE)
+endfunction()
+
+# benchmark_report(<label> <bin-dir> <ms>)
+function(benchmark_report label bin ms)
+  message(STATUS "${label}: ${ms} ms [${bin}]")
+endfunction()
@@ -0,0 +1,73 @@
+# Measure the cost of recording instrumentation snippets.  Each of SNIPPETS
+# commands runs a trivial command through 'ctest --instrument', which
+# writes one snippet, in a build tree that enables instrumentation.  The
+# script reports the time per snippet when each snippet is written to its
+# own file and, with builds of CMake that support the snippetLog query,
+# when the snippets are appended to one log.  It also reports the time per
+# command run without instrumentation, to subtract the process overhead.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DSNIPPETS=<n>]
+#         -P InstrumentationSnippets.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED SNIPPETS)
+  set(SNIPPETS 500)
+endif()
+
+set(uuid "a37d1069-1972-4901-b9c9-f194aaf2b6e0")
+set(src "${WORK_DIR}/InstrumentationSnippets")
+file(REMOVE_RECURSE "${src}")
+
+set(n 0)
+foreach(bin IN LISTS BIN_DIRS)
+  math(EXPR n "${n} + 1")
+  foreach(mode IN ITEMS none files log)
+    set(build "${src}/build-${n}-${mode}")
+    set(v1 "${build}/.cmake/instrumentation-${uuid}/v1")
+    if(mode STREQUAL "files")
+      file(WRITE "${v1}/query/query.json" "{ \"version\": 1 }\n")
+    elseif(mode STREQUAL "log")
+      file(WRITE "${v1}/query/query.json"
+        "{ \"version\": 1, \"queries\": [ \"snippetLog\" ] }\n")
+    else()
+      file(MAKE_DIRECTORY "${build}")
+    endif()
+
+    # Run the commands from one script so that only the recording differs
+    # between the modes.
+    if(mode STREQUAL "none")
+      set(command "\"${bin}/cmake\" -E true")
+    else()
+      set(command "\"${bin}/ctest\" --instrument --command-type compile
+        --build-dir \"${build}\" -- \"${bin}/cmake\" -E true")
+    endif()
+    file(WRITE "${build}/record.cmake" "
+foreach(i RANGE 1 ${SNIPPETS})
+  execute_process(COMMAND ${command} RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR \"Recording failed: \${result}\")
+  endif()
+endforeach()
+")
+
+    # Older builds of CMake reject the snippetLog query.
+    if(mode STREQUAL "log")
+      execute_process(
+        COMMAND "${bin}/ctest" --instrument --command-type compile
+          --build-dir "${build}" -- "${bin}/cmake" -E true
+        RESULT_VARIABLE result
+        OUTPUT_QUIET ERROR_QUIET
+        )
+      file(GLOB logs "${v1}/data/.snippets*.log")
+      if(NOT result EQUAL 0 OR NOT logs)
+        continue()
+      endif()
+    endif()
+
+    benchmark_time(ms "${build}" "${bin}/cmake" -P record.cmake)
+    math(EXPR us "${ms} * 1000 / ${SNIPPETS}")
+    message(STATUS
+      "InstrumentationSnippets ${mode}: ${us} us per command [${bin}]")
+  endforeach()
+endforeach()
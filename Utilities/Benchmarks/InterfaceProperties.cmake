@@ -0,0 +1,78 @@
+# Measure the generate step for many consumers of one deep chain of
+# libraries.  Every library adds include directories, compile definitions
+# and compile options to its interface and links the next one publicly.
+# The consumers are spread over several directories, so values shared
+# between heads are also shared between directories.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DLIBRARIES=<n>] [-DCONSUMERS=<n>]
+#         [-DDIRS=<n>] [-DGENERATOR=<generator>] [-DCMAKE_ARGS=<arg>;...]
+#         -P InterfaceProperties.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED LIBRARIES)
+  set(LIBRARIES 200)
+endif()
+if(NOT DEFINED CONSUMERS)
+  set(CONSUMERS 400)
+endif()
+if(NOT DEFINED DIRS)
+  set(DIRS 20)
+endif()
+if(DEFINED GENERATOR)
+  set(generator_args -G "${GENERATOR}")
+endif()
+
+set(src "${WORK_DIR}/InterfaceProperties-${LIBRARIES}-${CONSUMERS}")
+file(REMOVE_RECURSE "${src}")
+file(WRITE "${src}/empty.c" "int empty(void) { return 0; }\n")
+file(WRITE "${src}/main.c" "int main(void) { return 0; }\n")
+math(EXPR last_library "${LIBRARIES} - 1")
+math(EXPR last_dir "${DIRS} - 1")
+math(EXPR per_dir "${CONSUMERS} / ${DIRS}")
+file(WRITE "${src}/CMakeLists.txt" "
+cmake_minimum_required(VERSION 3.10)
+project(InterfaceProperties C)
+foreach(i RANGE ${last_library})
+  add_library(lib_\${i} STATIC empty.c)
+  target_include_directories(lib_\${i} INTERFACE
+    \${CMAKE_CURRENT_SOURCE_DIR}/include/lib_\${i}
+    $<BUILD_INTERFACE:\${CMAKE_CURRENT_BINARY_DIR}/generated/lib_\${i}>)
+  target_compile_definitions(lib_\${i} INTERFACE LIB_\${i}
+    $<$<CONFIG:Debug>:LIB_\${i}_DEBUG>)
+  target_compile_options(lib_\${i} INTERFACE $<$<COMPILE_LANGUAGE:C>:-DC_\${i}>)
+  if(i GREATER 0)
+    math(EXPR prev \"\${i} - 1\")
+    target_link_libraries(lib_\${prev} PUBLIC lib_\${i})
+  endif()
+endforeach()
+foreach(d RANGE ${last_dir})
+  add_subdirectory(dir_\${d})
+endforeach()
+")
+foreach(d RANGE ${last_dir})
+  file(WRITE "${src}/dir_${d}/CMakeLists.txt" "
+foreach(i RANGE 1 ${per_dir})
+  add_executable(exe_${d}_\${i} ../main.c)
+  target_link_libraries(exe_${d}_\${i} PRIVATE lib_0)
+endforeach()
+")
+endforeach()
+
+set(n 0)
+foreach(bin IN LISTS BIN_DIRS)
+  math(EXPR n "${n} + 1")
+  set(build "${src}/build-${n}")
+  # Configure once so that the measurement excludes compiler checks.
+  execute_process(
+    COMMAND "${bin}/cmake" -S "${src}" -B "${build}" ${generator_args}
+      ${CMAKE_ARGS}
+    OUTPUT_QUIET
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Configuring ${src} with ${bin}/cmake failed.")
+  endif()
+  benchmark_time(ms "${build}" "${bin}/cmake" .)
+  benchmark_report("InterfaceProperties ${LIBRARIES} libraries" "${bin}" "${ms}")
+endforeach()
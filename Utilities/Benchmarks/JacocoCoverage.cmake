@@ -0,0 +1,49 @@
+# Measure the coverage step on synthetic JaCoCo reports.  Each of REPORTS
+# reports covers FILES source files of LINES lines each.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DREPORTS=<n>] [-DFILES=<n>]
+#         [-DLINES=<n>] [-DPARALLEL=<n>] -P JacocoCoverage.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED REPORTS)
+  set(REPORTS 8)
+endif()
+if(NOT DEFINED FILES)
+  set(FILES 50)
+endif()
+if(NOT DEFINED LINES)
+  set(LINES 2000)
+endif()
+if(NOT DEFINED PARALLEL)
+  set(PARALLEL 1)
+endif()
+
+set(src "${WORK_DIR}/JacocoCoverage")
+file(REMOVE_RECURSE "${src}")
+file(WRITE "${src}/DartConfiguration.tcl"
+  "SourceDirectory: ${src}\nBuildDirectory: ${src}\n")
+
+set(source "")
+set(lines "")
+foreach(l RANGE 1 ${LINES})
+  string(APPEND source "    i = i + ${l};\n")
+  math(EXPR ci "${l} % 3")
+  string(APPEND lines "<line nr=\"${l}\" mi=\"0\" ci=\"${ci}\" mb=\"0\" cb=\"0\"/>")
+endforeach()
+
+foreach(r RANGE 1 ${REPORTS})
+  set(report "<?xml version=\"1.0\" encoding=\"UTF-8\"?><report name=\"r${r}\">")
+  string(APPEND report "<package name=\"org/cmake/r${r}\">")
+  foreach(f RANGE 1 ${FILES})
+    file(WRITE "${src}/java/org/cmake/r${r}/File${f}.java" "${source}")
+    string(APPEND report "<sourcefile name=\"File${f}.java\">${lines}</sourcefile>")
+  endforeach()
+  string(APPEND report "</package></report>\n")
+  file(WRITE "${src}/reports/r${r}-jacoco.xml" "${report}")
+endforeach()
+
+foreach(bin IN LISTS BIN_DIRS)
+  benchmark_time(ms "${src}" "${bin}/ctest" -T Coverage --parallel ${PARALLEL})
+  benchmark_report("JacocoCoverage ${REPORTS}x${FILES}x${LINES}" "${bin}" "${ms}")
+endforeach()
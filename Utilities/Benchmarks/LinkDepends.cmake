@@ -0,0 +1,68 @@
+# Measure the generate step for diamond shaped link graphs of increasing
+# depth.  Every library of a level links all libraries of the next level,
+# and one executable per level links the libraries of that level.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DDEPTHS=<n>;...] [-DWIDTH=<n>]
+#         [-DGENERATOR=<generator>] -P LinkDepends.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED DEPTHS)
+  set(DEPTHS 25 50 100)
+endif()
+if(NOT DEFINED WIDTH)
+  set(WIDTH 4)
+endif()
+if(DEFINED GENERATOR)
+  set(generator_args -G "${GENERATOR}")
+endif()
+
+foreach(depth IN LISTS DEPTHS)
+  set(src "${WORK_DIR}/LinkDepends-${depth}")
+  file(REMOVE_RECURSE "${src}")
+  file(WRITE "${src}/empty.c" "int empty(void) { return 0; }\n")
+  file(WRITE "${src}/main.c" "int main(void) { return 0; }\n")
+  file(WRITE "${src}/CMakeLists.txt" "
+cmake_minimum_required(VERSION 3.10)
+project(LinkDepends C)
+set(depth ${depth})
+set(width ${WIDTH})
+math(EXPR last \"\${depth} - 1\")
+foreach(level RANGE \${last})
+  foreach(i RANGE 1 \${width})
+    add_library(lib_\${level}_\${i} STATIC empty.c)
+  endforeach()
+endforeach()
+foreach(level RANGE \${last})
+  set(libs \"\")
+  foreach(i RANGE 1 \${width})
+    list(APPEND libs lib_\${level}_\${i})
+  endforeach()
+  if(level GREATER 0)
+    math(EXPR up \"\${level} - 1\")
+    foreach(i RANGE 1 \${width})
+      target_link_libraries(lib_\${up}_\${i} PUBLIC \${libs})
+    endforeach()
+  endif()
+  add_executable(exe_\${level} main.c)
+  target_link_libraries(exe_\${level} PRIVATE \${libs})
+endforeach()
+")
+
+  set(n 0)
+  foreach(bin IN LISTS BIN_DIRS)
+    math(EXPR n "${n} + 1")
+    set(build "${src}/build-${n}")
+    # Configure once so that the measurement excludes compiler checks.
+    execute_process(
+      COMMAND "${bin}/cmake" -S "${src}" -B "${build}" ${generator_args}
+      OUTPUT_QUIET
+      RESULT_VARIABLE result
+      )
+    if(NOT result EQUAL 0)
+      message(FATAL_ERROR "Configuring ${src} with ${bin}/cmake failed.")
+    endif()
+    benchmark_time(ms "${build}" "${bin}/cmake" .)
+    benchmark_report("LinkDepends depth ${depth}" "${bin}" "${ms}")
+  endforeach()
+endforeach()
@@ -0,0 +1,83 @@
+# Measure the Ninja manifest of a project with many sources.  The sources
+# are spread over static libraries that each add compile definitions and
+# include directories to those of the directory.  The script reports the
+# total size of the .ninja files, the time to generate them, and, when
+# NINJA names a ninja executable, the time 'ninja -n' takes to load them.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DSOURCES=<n>] [-DTARGETS=<n>]
+#         [-DGENERATOR=<generator>] [-DNINJA=<ninja>]
+#         [-DCMAKE_ARGS=<arg>;...] -P NinjaManifest.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED SOURCES)
+  set(SOURCES 100000)
+endif()
+if(NOT DEFINED TARGETS)
+  set(TARGETS 100)
+endif()
+if(NOT DEFINED GENERATOR)
+  set(GENERATOR "Ninja")
+endif()
+set(generator_args -G "${GENERATOR}")
+if(DEFINED NINJA)
+  list(APPEND generator_args "-DCMAKE_MAKE_PROGRAM=${NINJA}")
+endif()
+
+set(src "${WORK_DIR}/NinjaManifest-${SOURCES}")
+file(REMOVE_RECURSE "${src}")
+math(EXPR per_target "${SOURCES} / ${TARGETS}")
+math(EXPR last_target "${TARGETS} - 1")
+math(EXPR last_source "${per_target} - 1")
+foreach(t RANGE ${last_target})
+  foreach(s RANGE ${last_source})
+    file(WRITE "${src}/t${t}/s${s}.c" "int t${t}_s${s}(void) { return ${s}; }\n")
+  endforeach()
+endforeach()
+file(WRITE "${src}/CMakeLists.txt" "
+cmake_minimum_required(VERSION 3.10)
+project(NinjaManifest C)
+add_compile_definitions(PROJECT_WIDE=1 NDEBUG_LEVEL=2)
+add_compile_options(-Wall)
+include_directories(include common/include)
+foreach(t RANGE ${last_target})
+  set(srcs \"\")
+  foreach(s RANGE ${last_source})
+    list(APPEND srcs t\${t}/s\${s}.c)
+  endforeach()
+  add_library(t\${t} STATIC \${srcs})
+  target_compile_definitions(t\${t} PRIVATE TARGET_ID=\${t} BUILDING_T\${t})
+  target_include_directories(t\${t} PRIVATE t\${t}/include t\${t}/private)
+endforeach()
+")
+
+set(n 0)
+foreach(bin IN LISTS BIN_DIRS)
+  math(EXPR n "${n} + 1")
+  set(build "${src}/build-${n}")
+  # Configure once so that the measurement excludes compiler checks.
+  execute_process(
+    COMMAND "${bin}/cmake" -S "${src}" -B "${build}" ${generator_args}
+      ${CMAKE_ARGS}
+    OUTPUT_QUIET
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Configuring ${src} with ${bin}/cmake failed.")
+  endif()
+  benchmark_time(ms "${build}" "${bin}/cmake" .)
+  benchmark_report("NinjaManifest ${SOURCES} sources generate" "${bin}" "${ms}")
+
+  file(GLOB_RECURSE manifests "${build}/*.ninja")
+  set(bytes 0)
+  foreach(manifest IN LISTS manifests)
+    file(SIZE "${manifest}" size)
+    math(EXPR bytes "${bytes} + ${size}")
+  endforeach()
+  message(STATUS "NinjaManifest ${SOURCES} sources size: ${bytes} bytes [${bin}]")
+
+  if(DEFINED NINJA)
+    benchmark_time(ms "${build}" "${NINJA}" -n)
+    benchmark_report("NinjaManifest ${SOURCES} sources ninja -n" "${bin}" "${ms}")
+  endif()
+endforeach()
@@ -0,0 +1,68 @@
+# Measure the generate step of a project whose sources and include
+# directories have long full paths, which the generators convert to shell
+# and build system forms many times over.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DSOURCES=<n>] [-DTARGETS=<n>]
+#         [-DGENERATOR=<generator>] [-DCMAKE_ARGS=<arg>;...]
+#         -P OutputConverter.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED SOURCES)
+  set(SOURCES 20000)
+endif()
+if(NOT DEFINED TARGETS)
+  set(TARGETS 200)
+endif()
+if(DEFINED GENERATOR)
+  set(generator_args -G "${GENERATOR}")
+endif()
+
+set(src "${WORK_DIR}/OutputConverter-${SOURCES}")
+set(nested "components/subsystem/implementation/sources")
+file(REMOVE_RECURSE "${src}")
+math(EXPR per_target "${SOURCES} / ${TARGETS}")
+math(EXPR last_target "${TARGETS} - 1")
+math(EXPR last_source "${per_target} - 1")
+foreach(t RANGE ${last_target})
+  foreach(s RANGE ${last_source})
+    file(WRITE "${src}/${nested}/t${t}/s${s}.c"
+      "int t${t}_s${s}(void) { return ${s}; }\n")
+  endforeach()
+endforeach()
+file(WRITE "${src}/CMakeLists.txt" "
+cmake_minimum_required(VERSION 3.10)
+project(OutputConverter C)
+foreach(t RANGE ${last_target})
+  set(srcs \"\")
+  foreach(s RANGE ${last_source})
+    list(APPEND srcs \${CMAKE_SOURCE_DIR}/${nested}/t\${t}/s\${s}.c)
+  endforeach()
+  add_library(t\${t} STATIC \${srcs})
+  target_include_directories(t\${t} PRIVATE
+    \${CMAKE_SOURCE_DIR}/${nested}/t\${t}/include
+    \${CMAKE_BINARY_DIR}/${nested}/t\${t}/generated)
+  if(t GREATER 0)
+    math(EXPR prev \"\${t} - 1\")
+    target_link_libraries(t\${t} PUBLIC t\${prev})
+  endif()
+endforeach()
+")
+
+set(n 0)
+foreach(bin IN LISTS BIN_DIRS)
+  math(EXPR n "${n} + 1")
+  set(build "${src}/build-${n}")
+  # Configure once so that the measurement excludes compiler checks.
+  execute_process(
+    COMMAND "${bin}/cmake" -S "${src}" -B "${build}" ${generator_args}
+      ${CMAKE_ARGS}
+    OUTPUT_QUIET
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Configuring ${src} with ${bin}/cmake failed.")
+  endif()
+  benchmark_time(ms "${build}" "${bin}/cmake" .)
+  benchmark_report("OutputConverter ${SOURCES} sources" "${bin}" "${ms}")
+endforeach()
@@ -0,0 +1,87 @@
+# Measure the collation of scanned module dependencies by
+# 'cmake -E cmake_ninja_dyndep' for one target with many sources.  Every
+# source provides one Fortran module and requires the module of the source
+# before it, so every '.ddi' file is parsed and every module is resolved.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DCOUNTS=<n>;...] -P ScanDep.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED COUNTS)
+  set(COUNTS 5000 50000)
+endif()
+
+foreach(count IN LISTS COUNTS)
+  set(dir "${WORK_DIR}/ScanDep-${count}")
+  file(REMOVE_RECURSE "${dir}")
+  file(WRITE "${dir}/CMakeFiles/t.dir/FortranDependInfo.json" "{
+  \"compiler-frontend-variant\": \"GNU\",
+  \"compiler-id\": \"GNU\",
+  \"compiler-simulate-id\": \"\",
+  \"config\": \"\",
+  \"cxx-modules\": {},
+  \"database-info\": null,
+  \"dir-cur-bld\": \"${dir}\",
+  \"dir-cur-src\": \"${dir}\",
+  \"dir-top-bld\": \"${dir}\",
+  \"dir-top-src\": \"${dir}\",
+  \"exports\": [],
+  \"forward-modules-from-target-dirs\": [],
+  \"include-dirs\": [],
+  \"language\": \"Fortran\",
+  \"linked-target-dirs\": [],
+  \"module-dir\": \"${dir}/mod\",
+  \"sources\": {},
+  \"submodule-ext\": \".smod\",
+  \"submodule-sep\": \"@\"
+}
+")
+  # The response file is read as a single line.
+  set(rsp "--tdi=CMakeFiles/t.dir/FortranDependInfo.json --lang=Fortran")
+  string(APPEND rsp " --dd=CMakeFiles/t.dir/Fortran.dd")
+  math(EXPR last "${count} - 1")
+  foreach(i RANGE ${last})
+    if(i EQUAL 0)
+      set(requires "")
+    else()
+      math(EXPR prev "${i} - 1")
+      set(requires "{ \"logical-name\": \"m${prev}\", \"lookup-method\": \"by-name\" }")
+    endif()
+    set(ddi "CMakeFiles/t.dir/s${i}.f90.o.ddi")
+    file(WRITE "${dir}/${ddi}" "{
+  \"revision\": 0,
+  \"rules\": [
+    {
+      \"primary-output\": \"CMakeFiles/t.dir/s${i}.f90.o\",
+      \"outputs\": [ \"CMakeFiles/t.dir/s${i}.f90.o.d\" ],
+      \"provides\": [
+        {
+          \"compiled-module-path\": \"mod/m${i}.mod\",
+          \"is-interface\": true,
+          \"logical-name\": \"m${i}\",
+          \"source-path\": \"${dir}/s${i}.f90\"
+        }
+      ],
+      \"requires\": [ ${requires} ]
+    }
+  ],
+  \"version\": 1
+}
+")
+    string(APPEND rsp " ${ddi}")
+  endforeach()
+  file(WRITE "${dir}/dyndep.rsp" "${rsp}\n")
+
+  foreach(bin IN LISTS BIN_DIRS)
+    execute_process(
+      COMMAND "${bin}/cmake" -E cmake_ninja_dyndep @dyndep.rsp
+      WORKING_DIRECTORY "${dir}"
+      RESULT_VARIABLE result
+      )
+    if(NOT result EQUAL 0)
+      message(FATAL_ERROR "Collating ${dir} with ${bin}/cmake failed.")
+    endif()
+    benchmark_time(ms "${dir}" "${bin}/cmake" -E cmake_ninja_dyndep @dyndep.rsp)
+    benchmark_report("ScanDep ${count} sources" "${bin}" "${ms}")
+  endforeach()
+endforeach()
@@ -0,0 +1,86 @@
+# Measure the generate step of a project with many targets, and the part
+# of it spent computing the inter-target dependency graph.  Every static
+# library links several of the libraries defined before it, and every
+# tenth one also depends on a custom target.
+#
+# The time of the dependency graph comes from a separate run with
+# --profiling-output, and is reported only by builds of CMake that record
+# it.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DTARGETS=<n>] [-DDEPENDS=<n>]
+#         [-DGENERATOR=<generator>] [-DCMAKE_ARGS=<arg>;...]
+#         -P TargetDepends.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED TARGETS)
+  set(TARGETS 1000)
+endif()
+if(NOT DEFINED DEPENDS)
+  set(DEPENDS 8)
+endif()
+if(DEFINED GENERATOR)
+  set(generator_args -G "${GENERATOR}")
+endif()
+
+set(src "${WORK_DIR}/TargetDepends-${TARGETS}")
+file(REMOVE_RECURSE "${src}")
+file(WRITE "${src}/lib.c" "int lib(void) { return 0; }\n")
+math(EXPR last_target "${TARGETS} - 1")
+file(WRITE "${src}/CMakeLists.txt" "
+cmake_minimum_required(VERSION 3.10)
+project(TargetDepends C)
+foreach(i RANGE ${last_target})
+  add_library(lib_\${i} STATIC lib.c)
+  foreach(d RANGE 1 ${DEPENDS})
+    math(EXPR dep \"\${i} - \${d} * \${d}\")
+    if(dep GREATER_EQUAL 0)
+      target_link_libraries(lib_\${i} PRIVATE lib_\${dep})
+    endif()
+  endforeach()
+  math(EXPR tenth \"\${i} % 10\")
+  if(tenth EQUAL 0)
+    add_custom_target(gen_\${i} COMMAND \\\${CMAKE_COMMAND} -E true)
+    add_dependencies(lib_\${i} gen_\${i})
+  endif()
+endforeach()
+")
+
+set(n 0)
+foreach(bin IN LISTS BIN_DIRS)
+  math(EXPR n "${n} + 1")
+  set(build "${src}/build-${n}")
+  # Configure once so that the measurement excludes compiler checks.
+  execute_process(
+    COMMAND "${bin}/cmake" -S "${src}" -B "${build}" ${generator_args}
+      ${CMAKE_ARGS}
+    OUTPUT_QUIET
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Configuring ${src} with ${bin}/cmake failed.")
+  endif()
+  benchmark_time(ms "${build}" "${bin}/cmake" .)
+  benchmark_report("TargetDepends ${TARGETS} targets generate" "${bin}" "${ms}")
+
+  execute_process(
+    COMMAND "${bin}/cmake" . --profiling-format=google-trace
+      --profiling-output=profile.json
+    WORKING_DIRECTORY "${build}"
+    OUTPUT_QUIET ERROR_QUIET
+    )
+  # The trace has a begin and an end event for each entry, with times in
+  # microseconds.  The dependency graph entry has no nested entries, so it
+  # ends with the next end event.
+  file(READ "${build}/profile.json" profile)
+  string(FIND "${profile}" "\"compute_target_depends\"" pos)
+  if(pos GREATER -1)
+    string(SUBSTRING "${profile}" ${pos} -1 profile)
+    string(REGEX MATCH "\"ts\" *: *([0-9]+)" begin "${profile}")
+    set(begin ${CMAKE_MATCH_1})
+    string(REGEX MATCH "\"ph\" *: *\"E\"[^}]*\"ts\" *: *([0-9]+)" end
+      "${profile}")
+    math(EXPR ms "(${CMAKE_MATCH_1} - ${begin}) / 1000")
+    benchmark_report("TargetDepends ${TARGETS} targets dependency graph" "${bin}" "${ms}")
+  endif()
+endforeach()
@@ -0,0 +1,46 @@
+# Measure a test step in which each of TESTS tests prints OUTPUT_KB
+# kilobytes, all of which go to Test.xml and a JUnit file.  The memory
+# held for the output grows with both, so run this under a tool that
+# reports the peak memory of ctest to compare that too.
+#
+#   cmake [-DBIN_DIRS=<dir>;...] [-DTESTS=<n>] [-DOUTPUT_KB=<n>]
+#         [-DPARALLEL=<n>] -P TestOutput.cmake
+
+include("${CMAKE_CURRENT_LIST_DIR}/Common.cmake")
+
+if(NOT DEFINED TESTS)
+  set(TESTS 500)
+endif()
+if(NOT DEFINED OUTPUT_KB)
+  set(OUTPUT_KB 100)
+endif()
+if(NOT DEFINED PARALLEL)
+  set(PARALLEL 4)
+endif()
+
+set(src "${WORK_DIR}/TestOutput")
+file(REMOVE_RECURSE "${src}")
+file(WRITE "${src}/DartConfiguration.tcl" "BuildDirectory: ${src}\n")
+
+# One kilobyte of output, printed OUTPUT_KB times by each test.
+string(REPEAT "x" 1023 line)
+set(output "")
+foreach(i RANGE 1 ${OUTPUT_KB})
+  string(APPEND output "${line}\n")
+endforeach()
+file(WRITE "${src}/output.txt" "${output}")
+
+set(tests "")
+foreach(t RANGE 1 ${TESTS})
+  string(APPEND tests
+    "add_test(t${t} \"${CMAKE_COMMAND}\" -E cat \"${src}/output.txt\")\n")
+endforeach()
+file(WRITE "${src}/CTestTestfile.cmake" "${tests}")
+
+math(EXPR size "${OUTPUT_KB} * 1024 + 1024")
+foreach(bin IN LISTS BIN_DIRS)
+  benchmark_time(ms "${src}" "${bin}/ctest" -T Test -j${PARALLEL}
+    --no-compress-output --test-output-size-passed ${size}
+    --output-junit "${src}/junit.xml")
+  benchmark_report("TestOutput ${TESTS}x${OUTPUT_KB}KB" "${bin}" "${ms}")
+endforeach()